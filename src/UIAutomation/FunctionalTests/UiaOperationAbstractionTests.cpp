@@ -4,10 +4,32 @@
 #include "pch.h"
 #include "CppUnitTest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
+
 #include "ModernApp.h"
 #include "TestUtils.h"
 
 #include "UiaOperationAbstraction.h"
+#include "UiaAccessibilityRules.h"
+#include "UiaCrawler.h"
+#include "UiaOperationBatcher.h"
+#include "UiaOperationSizer.h"
+#include "UiaPriorityExecutor.h"
+#include "UiaSnapshot.h"
+#include "UiaSpatialIndex.h"
+#include "UiaStringBuilder.h"
+#include "UiaSubtreeMirror.h"
+#include "UiaTreeQueries.h"
+#include "UiaTypeSwitch.h"
+#include "GeometryDecoding.h"
 #include "SafeArrayUtil.h"
 
 using namespace UiaOperationAbstraction;
@@ -2915,5 +2937,1594 @@ namespace UiaOperationAbstractionTests
                 }
             });
         }
+
+        // Asserts that operations submitted concurrently within the coalescing window share a batch. A stand-in
+        // executor with injected latency takes the place of the cross-process round trip.
+        TEST_METHOD(BatcherCoalescesConcurrentOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(false);
+
+            UiaOperationBatcher::Options options;
+            options.coalescingWindow = std::chrono::milliseconds(50);
+            UiaOperationBatcher batcher(options, UiaOperationBatcher::MakeLatencyInjectingExecutor(std::chrono::milliseconds(20)));
+
+            constexpr int c_operationCount = 8;
+            std::vector<int> results(c_operationCount);
+            std::vector<std::thread> threads;
+            for (int i = 0; i < c_operationCount; ++i)
+            {
+                threads.emplace_back([&, i]()
+                {
+                    UiaInt value = i;
+                    batcher.Submit(0 /* connectionId */, [&](UiaOperationScope& scope)
+                    {
+                        value *= 2;
+                        scope.BindResult(value);
+                    }).get();
+                    results[i] = value;
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            for (int i = 0; i < c_operationCount; ++i)
+            {
+                Assert::AreEqual(i * 2, results[i]);
+            }
+
+            const auto metrics = batcher.GetMetrics();
+            Assert::AreEqual(static_cast<uint64_t>(c_operationCount), metrics.operationCount);
+            Assert::IsTrue(metrics.batchCount < metrics.operationCount);
+        }
+
+        // Asserts that a failing operation in a batch reports its own failure code without affecting the
+        // other operations in the same batch.
+        void BatcherIsolatesFailingOperationsTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            UiaString name = L"";
+            const std::vector<BatchedOperation> batch{
+                [](UiaOperationScope& scope)
+                {
+                    scope.AbortOperationWithHresult(E_FAIL);
+                },
+                [&](UiaOperationScope& scope)
+                {
+                    UiaElement element = calc;
+                    name = element.GetName(false /*useCachedApi*/);
+                    scope.BindResult(name);
+                } };
+
+            const auto results = UiaOperationBatcher::ExecuteBatchInScope(batch);
+
+            Assert::AreEqual(static_cast<size_t>(2), results.size());
+            Assert::AreEqual(E_FAIL, results[0]);
+            Assert::AreEqual(S_OK, results[1]);
+            Assert::AreEqual(std::wstring(static_cast<wil::shared_bstr>(name).get()), std::wstring(L"Display is 0"));
+        }
+
+        TEST_METHOD(BatcherIsolatesFailingOperationsLocalTest)
+        {
+            BatcherIsolatesFailingOperationsTest(false);
+        }
+
+        TEST_METHOD(BatcherIsolatesFailingOperationsRemoteTest)
+        {
+            BatcherIsolatesFailingOperationsTest(true);
+        }
+
+        // Asserts that an interactive operation submitted while a background operation is running is executed
+        // between the background operation's chunks rather than after all of them.
+        TEST_METHOD(PriorityExecutorInteractivePreemptsBackground)
+        {
+            auto guard = InitializeUiaOperationAbstraction(false);
+
+            UiaPriorityExecutor executor;
+
+            constexpr int c_chunkCount = 5;
+            std::atomic<int> chunksCompleted = 0;
+            std::promise<void> firstChunkStarted;
+            auto background = executor.SubmitBackground(0 /* connectionId */, [&](UiaOperationScope& /*scope*/)
+            {
+                if (chunksCompleted == 0)
+                {
+                    firstChunkStarted.set_value();
+                }
+
+                // Stands in for the round trip of a chunk of remote work.
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return ++chunksCompleted < c_chunkCount;
+            });
+
+            firstChunkStarted.get_future().get();
+
+            UiaInt value = 21;
+            executor.SubmitInteractive(0 /* connectionId */, [&](UiaOperationScope& scope)
+            {
+                value *= 2;
+                scope.BindResult(value);
+            }).get();
+            const int chunksCompletedBeforeInteractive = chunksCompleted;
+
+            background.get();
+
+            Assert::AreEqual(42, static_cast<int>(value));
+            Assert::IsTrue(chunksCompletedBeforeInteractive < c_chunkCount);
+            Assert::AreEqual(c_chunkCount, static_cast<int>(chunksCompleted));
+
+            const auto metrics = executor.GetMetrics();
+            Assert::AreEqual(static_cast<uint64_t>(1), metrics.interactive.executionTime.GetCount());
+            Assert::AreEqual(static_cast<uint64_t>(c_chunkCount), metrics.background.executionTime.GetCount());
+        }
+
+        // Asserts that RunWithDeadline returns promptly once the deadline passes, abandoning a stand-in for a
+        // hung provider call, and that work finishing in time returns its result.
+        TEST_METHOD(RunWithDeadlineAbandonsSlowWork)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            Assert::ExpectException<DeadlineExceededException>([&]()
+            {
+                RunWithDeadline([]()
+                {
+                    std::this_thread::sleep_for(std::chrono::seconds(2));
+                    return 0;
+                }, start + std::chrono::milliseconds(50));
+            });
+            Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+            const auto result = RunWithDeadline([]() { return 42; }, std::chrono::steady_clock::now() + std::chrono::seconds(10));
+            Assert::AreEqual(42, result);
+        }
+
+        // Asserts that resolving a remote scope whose deadline has passed fails with the deadline's error code
+        // without resolving bound results, that the scope can't be resolved again afterwards, and that deadlines
+        // don't affect local scopes.
+        void ResolveWithExpiredDeadlineTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+            scope.SetDeadline(std::chrono::steady_clock::now());
+
+            UiaElement element = calc;
+            UiaString name = L"Unresolved";
+            scope.BindResult(name);
+            name = element.GetName(false /*useCachedApi*/);
+
+            if (useRemoteOperations)
+            {
+                Assert::AreEqual(HRESULT_FROM_WIN32(ERROR_TIMEOUT), scope.ResolveHr());
+
+                // The resolver never ran, so the bound value is still an unresolved stand-in.
+                Assert::IsTrue(name.IsRemoteType());
+
+                // The scope is poisoned, rather than quietly resolving nothing the second time.
+                Assert::ExpectException<DeadlineExceededException>([&]()
+                {
+                    scope.Resolve();
+                });
+            }
+            else
+            {
+                scope.Resolve();
+                Assert::AreEqual(std::wstring(L"Display is 0"), std::wstring(static_cast<wil::shared_bstr>(name).get()));
+            }
+        }
+
+        TEST_METHOD(ResolveWithExpiredDeadlineLocalTest)
+        {
+            ResolveWithExpiredDeadlineTest(false);
+        }
+
+        TEST_METHOD(ResolveWithExpiredDeadlineRemoteTest)
+        {
+            ResolveWithExpiredDeadlineTest(true);
+        }
+
+        // Asserts that spatial index queries agree with a linear scan over the same entries, on a synthetic layout
+        // large enough to exercise several levels of the tree, including after incremental updates.
+        TEST_METHOD(SpatialIndexMatchesLinearScan)
+        {
+            std::mt19937 random(81);
+            std::uniform_real_distribution<float> position(0.0f, 10000.0f);
+            std::uniform_real_distribution<float> extent(1.0f, 200.0f);
+            auto makeEntry = [&](int id)
+            {
+                return UiaSpatialIndexEntry{ { position(random), position(random), extent(random), extent(random) }, { 42, id } };
+            };
+
+            std::map<std::vector<int>, winrt::Windows::Foundation::Rect> expected;
+            std::vector<UiaSpatialIndexEntry> entries;
+            for (int id = 0; id < 100000; ++id)
+            {
+                entries.emplace_back(makeEntry(id));
+                expected[entries.back().runtimeId] = entries.back().boundingRectangle;
+            }
+
+            const auto buildStart = std::chrono::steady_clock::now();
+            UiaSpatialIndex index(std::move(entries));
+            Logger::WriteMessage((L"Bulk load of 100000 entries took " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count()) + L"ms").c_str());
+
+            auto verify = [&]()
+            {
+                Assert::AreEqual(expected.size(), index.Size());
+
+                auto idsOf = [](const std::vector<const UiaSpatialIndexEntry*>& matches)
+                {
+                    std::set<std::vector<int>> ids;
+                    for (const auto match : matches)
+                    {
+                        ids.insert(match->runtimeId);
+                    }
+                    return ids;
+                };
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    const winrt::Windows::Foundation::Point point{ position(random), position(random) };
+                    std::set<std::vector<int>> linear;
+                    for (const auto& [runtimeId, rect] : expected)
+                    {
+                        if (rect.X <= point.X && point.X < rect.X + rect.Width && rect.Y <= point.Y && point.Y < rect.Y + rect.Height)
+                        {
+                            linear.insert(runtimeId);
+                        }
+                    }
+                    Assert::IsTrue(linear == idsOf(index.QueryPoint(point)));
+
+                    const winrt::Windows::Foundation::Rect region{ position(random), position(random), extent(random), extent(random) };
+                    linear.clear();
+                    for (const auto& [runtimeId, rect] : expected)
+                    {
+                        if (rect.X < region.X + region.Width && region.X < rect.X + rect.Width &&
+                            rect.Y < region.Y + region.Height && region.Y < rect.Y + rect.Height)
+                        {
+                            linear.insert(runtimeId);
+                        }
+                    }
+                    Assert::IsTrue(linear == idsOf(index.QueryRegion(region)));
+                }
+            };
+
+            const auto queryStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < 10000; ++i)
+            {
+                index.QueryPoint({ position(random), position(random) });
+            }
+            Logger::WriteMessage((L"10000 point queries took " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queryStart).count()) + L"us").c_str());
+
+            verify();
+
+            // Move, remove and add entries, enough to go through at least one repack.
+            for (int id = 0; id < 30000; ++id)
+            {
+                if (id % 3 == 0)
+                {
+                    Assert::IsTrue(index.Remove({ 42, id }));
+                    expected.erase({ 42, id });
+                }
+                else
+                {
+                    auto entry = makeEntry(id % 2 == 0 ? id : 100000 + id);
+                    expected[entry.runtimeId] = entry.boundingRectangle;
+                    index.Insert(std::move(entry));
+                }
+            }
+            Assert::IsFalse(index.Remove({ 42, 0 }));
+
+            verify();
+        }
+
+        // Asserts that a spatial index built from an element's subtree finds that element by point.
+        void SpatialIndexFromSubtreeTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            unique_safearray runtimeIdArray;
+            THROW_IF_FAILED(calc->GetRuntimeId(&runtimeIdArray));
+            SafeArrayAccessor<int> runtimeIdAccessor(runtimeIdArray.get(), VT_I4);
+            std::vector<int> runtimeId;
+            for (UINT i = 0; i < runtimeIdAccessor.Count(); ++i)
+            {
+                runtimeId.push_back(runtimeIdAccessor[i]);
+            }
+
+            RECT rect{};
+            THROW_IF_FAILED(calc->get_CurrentBoundingRectangle(&rect));
+
+            const auto index = UiaSpatialIndex::FromSubtree(calc);
+            Assert::IsTrue(index.Size() >= 1);
+
+            const winrt::Windows::Foundation::Point center{
+                static_cast<float>(rect.left + rect.right) / 2,
+                static_cast<float>(rect.top + rect.bottom) / 2 };
+            const auto matches = index.QueryPoint(center);
+            Assert::IsTrue(std::any_of(matches.begin(), matches.end(), [&](const auto match)
+            {
+                return match->runtimeId == runtimeId;
+            }));
+        }
+
+        TEST_METHOD(SpatialIndexFromSubtreeLocalTest)
+        {
+            SpatialIndexFromSubtreeTest(false);
+        }
+
+        TEST_METHOD(SpatialIndexFromSubtreeRemoteTest)
+        {
+            SpatialIndexFromSubtreeTest(true);
+        }
+
+        // Asserts that hit-testing from an element finds a path starting at that element for a point inside it,
+        // and nothing for a point outside it.
+        void HitTestTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            RECT rect{};
+            THROW_IF_FAILED(calc->get_CurrentBoundingRectangle(&rect));
+            const winrt::Windows::Foundation::Point center{
+                static_cast<float>(rect.left + rect.right) / 2,
+                static_cast<float>(rect.top + rect.bottom) / 2 };
+
+            auto scope = UiaOperationScope::StartNew();
+            UiaElement root = calc;
+            scope.BindInput(root);
+
+            auto inside = HitTest(scope, root, center);
+            UiaString rootName = inside.chain.GetAt(0).GetName(false /*useCachedApi*/);
+            auto outside = HitTest(scope, root, { static_cast<float>(rect.left) - 1, static_cast<float>(rect.top) - 1 });
+
+            scope.BindResult(inside.found, inside.element, inside.chain, rootName, outside.found, outside.chain);
+            scope.Resolve();
+
+            Assert::IsTrue(static_cast<bool>(inside.found));
+            Assert::IsTrue(static_cast<bool>(inside.element));
+            Assert::IsTrue((*inside.chain).size() >= 1);
+            Assert::AreEqual(std::wstring(L"Display is 0"), std::wstring(static_cast<wil::shared_bstr>(rootName).get()));
+
+            Assert::IsFalse(static_cast<bool>(outside.found));
+            Assert::AreEqual(static_cast<size_t>(0), (*outside.chain).size());
+        }
+
+        TEST_METHOD(HitTestLocalTest)
+        {
+            HitTestTest(false);
+        }
+
+        TEST_METHOD(HitTestRemoteTest)
+        {
+            HitTestTest(true);
+        }
+
+        // Asserts that the visible part of an on-screen element is its own rectangle, that its descendants are
+        // clipped to it, and that nothing is visible through a viewport that doesn't overlap it.
+        void FindVisibleElementsTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            RECT rect{};
+            THROW_IF_FAILED(calc->get_CurrentBoundingRectangle(&rect));
+
+            auto scope = UiaOperationScope::StartNew();
+            UiaElement root = calc;
+            scope.BindInput(root);
+
+            auto visible = FindVisibleElements(scope, root);
+            auto hidden = FindVisibleElements(scope, root, winrt::Windows::Foundation::Rect{
+                static_cast<float>(rect.right) + 10, static_cast<float>(rect.bottom) + 10, 100, 100 });
+
+            scope.BindResult(visible.elements, visible.visibleBounds, hidden.elements, hidden.visibleBounds);
+            scope.Resolve();
+
+            const auto rectangles = visible.GetVisibleRectangles();
+            Assert::AreEqual((*visible.elements).size(), rectangles.size());
+            Assert::IsTrue(rectangles.size() >= 1);
+
+            Assert::AreEqual(static_cast<float>(rect.left), rectangles[0].X);
+            Assert::AreEqual(static_cast<float>(rect.top), rectangles[0].Y);
+            Assert::AreEqual(static_cast<float>(rect.right - rect.left), rectangles[0].Width);
+            Assert::AreEqual(static_cast<float>(rect.bottom - rect.top), rectangles[0].Height);
+
+            for (const auto& visibleRect : rectangles)
+            {
+                Assert::IsTrue(visibleRect.Width > 0 && visibleRect.Height > 0);
+                Assert::IsTrue(visibleRect.X >= rect.left && visibleRect.X + visibleRect.Width <= rect.right);
+                Assert::IsTrue(visibleRect.Y >= rect.top && visibleRect.Y + visibleRect.Height <= rect.bottom);
+            }
+
+            Assert::AreEqual(static_cast<size_t>(0), (*hidden.elements).size());
+            Assert::IsTrue(hidden.GetVisibleRectangles().empty());
+        }
+
+        TEST_METHOD(FindVisibleElementsLocalTest)
+        {
+            FindVisibleElementsTest(false);
+        }
+
+        TEST_METHOD(FindVisibleElementsRemoteTest)
+        {
+            FindVisibleElementsTest(true);
+        }
+
+        // Asserts that the first sync of a subtree mirror fetches the whole subtree and that syncing again with
+        // nothing changed reports no differences.
+        void SubtreeMirrorSyncTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            UiaSubtreeMirror mirror{ UiaElement{ calc } };
+
+            const auto initial = mirror.Sync();
+            Assert::IsFalse(mirror.GetRootKey().empty());
+            Assert::AreEqual(mirror.GetNodes().size(), initial.addedCount);
+            Assert::AreEqual(static_cast<size_t>(0), initial.removedCount);
+
+            const auto& rootNode = mirror.GetNodes().at(mirror.GetRootKey());
+            Assert::AreEqual(std::wstring(L"Display is 0"), rootNode.name);
+            for (const auto& child : rootNode.children)
+            {
+                Assert::IsTrue(mirror.GetNodes().find(child) != mirror.GetNodes().end());
+            }
+
+            const auto unchanged = mirror.Sync();
+            Assert::AreEqual(static_cast<size_t>(0), unchanged.addedCount);
+            Assert::AreEqual(static_cast<size_t>(0), unchanged.removedCount);
+            Assert::AreEqual(static_cast<size_t>(0), unchanged.childrenChangedCount);
+            Assert::AreEqual(static_cast<size_t>(0), unchanged.propertiesChangedCount);
+            Assert::AreEqual(initial.addedCount, mirror.GetNodes().size());
+        }
+
+        TEST_METHOD(SubtreeMirrorSyncLocalTest)
+        {
+            SubtreeMirrorSyncTest(false);
+        }
+
+        TEST_METHOD(SubtreeMirrorSyncRemoteTest)
+        {
+            SubtreeMirrorSyncTest(true);
+        }
+
+        void AccessibilityRulesTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            const UiaAccessibilityRule alwaysViolated{ L"AlwaysViolated", UiaRuleProperty_None, [](const UiaRuleElement&) { return UiaBool(true); } };
+            const UiaAccessibilityRule neverViolated{ L"NeverViolated", UiaRuleProperty_Name | UiaRuleProperty_IsEnabled, [](const UiaRuleElement& element) { return element.name.Length() > 1000000u; } };
+            const auto builtInRules = std::vector<UiaAccessibilityRule>{
+                MissingNameOnFocusableRule(),
+                ZeroSizeVisibleElementRule(),
+                DuplicateAutomationIdAmongSiblingsRule() };
+
+            // A rule that every element violates reports each element of the subtree exactly once.
+            const auto elementCount = UiaSpatialIndex::FromSubtree(UiaElement{ calc }).Size();
+            const auto everyElement = UiaAccessibilityRuleEngine({ alwaysViolated }).Evaluate(UiaElement{ calc });
+            Assert::AreEqual(elementCount, everyElement.size());
+            std::set<std::vector<int>> distinctRuntimeIds;
+            for (const auto& violation : everyElement)
+            {
+                Assert::IsFalse(violation.runtimeId.empty());
+                distinctRuntimeIds.insert(violation.runtimeId);
+            }
+            Assert::AreEqual(elementCount, distinctRuntimeIds.size());
+
+            // A rule that nothing violates contributes nothing, even alongside other rules.
+            auto rules = builtInRules;
+            rules.push_back(neverViolated);
+            const auto violations = UiaAccessibilityRuleEngine(rules).Evaluate(UiaElement{ calc });
+            for (const auto& violation : violations)
+            {
+                Assert::AreNotEqual(std::wstring(L"NeverViolated"), violation.ruleId);
+                Assert::IsTrue(std::any_of(builtInRules.begin(), builtInRules.end(), [&](const auto& rule) { return rule.id == violation.ruleId; }));
+            }
+
+            // Adding the rule doesn't change what the other rules report.
+            Assert::AreEqual(UiaAccessibilityRuleEngine(builtInRules).Evaluate(UiaElement{ calc }).size(), violations.size());
+        }
+
+        TEST_METHOD(AccessibilityRulesLocalTest)
+        {
+            AccessibilityRulesTest(false);
+        }
+
+        TEST_METHOD(AccessibilityRulesRemoteTest)
+        {
+            AccessibilityRulesTest(true);
+        }
+
+        void StringBuilderTest(const bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+            UiaElement element = calc;
+            scope.BindInput(element);
+
+            UiaStringBuilder empty;
+            UiaString emptyResult = empty.ToString(scope);
+
+            // An odd number of fragments, so that the last one has no neighbour on the first level.
+            UiaStringBuilder builder;
+            builder.Append(L"[");
+            builder.Append(element.GetName());
+            builder.Append(L"]");
+            for (int i = 0; i < 4; ++i)
+            {
+                builder.Append(std::to_wstring(i));
+            }
+            UiaString first = builder.ToString(scope);
+            UiaUint countAfterFirst = builder.FragmentCount();
+
+            builder.Append(L"!");
+            UiaString second = builder.ToString(scope);
+
+            scope.BindResult(emptyResult, first, countAfterFirst, second);
+            scope.Resolve();
+
+            Assert::AreEqual(std::wstring(L""), emptyResult.GetLocalWstring());
+            Assert::AreEqual(std::wstring(L"[Display is 0]0123"), first.GetLocalWstring());
+            Assert::AreEqual(1u, static_cast<unsigned int>(countAfterFirst));
+            Assert::AreEqual(std::wstring(L"[Display is 0]0123!"), second.GetLocalWstring());
+        }
+
+        TEST_METHOD(StringBuilderLocalTest)
+        {
+            StringBuilderTest(false);
+        }
+
+        TEST_METHOD(StringBuilderRemoteTest)
+        {
+            StringBuilderTest(true);
+        }
+
+        // Joins a large number of fragments with the builder and with a Concat chain, using the local
+        // implementation of the same operations as a stand-in for the provider, and checks that both produce the
+        // expected string. The timings show the difference in growth between the two.
+        TEST_METHOD(StringBuilderLargeFragmentCount)
+        {
+            auto guard = InitializeUiaOperationAbstraction(false);
+
+            for (const int fragmentCount : { 1024, 4096, 16384 })
+            {
+                std::wstring expected;
+                for (int i = 0; i < fragmentCount; ++i)
+                {
+                    expected += std::to_wstring(i) + L",";
+                }
+
+                auto scope = UiaOperationScope::StartNew();
+
+                const auto builderStart = std::chrono::steady_clock::now();
+                UiaStringBuilder builder;
+                for (int i = 0; i < fragmentCount; ++i)
+                {
+                    builder.Append(std::to_wstring(i) + L",");
+                }
+                UiaString balanced = builder.ToString(scope);
+                const auto builderTime = std::chrono::steady_clock::now() - builderStart;
+
+                const auto chainStart = std::chrono::steady_clock::now();
+                UiaString chained = L"";
+                for (int i = 0; i < fragmentCount; ++i)
+                {
+                    chained = chained.Concat(std::to_wstring(i) + L",");
+                }
+                const auto chainTime = std::chrono::steady_clock::now() - chainStart;
+
+                scope.BindResult(balanced, chained);
+                scope.Resolve();
+
+                Assert::IsTrue(expected == balanced.GetLocalWstring());
+                Assert::IsTrue(expected == chained.GetLocalWstring());
+
+                Logger::WriteMessage((L"Joining " + std::to_wstring(fragmentCount) + L" fragments took " +
+                    std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(builderTime).count()) + L"us with the builder and " +
+                    std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(chainTime).count()) + L"us with a Concat chain").c_str());
+            }
+        }
+
+        // Asserts that the vectorized conversions produce exactly the same floats as the scalar one, including for
+        // values that round, overflow or aren't numbers, and for every remainder length.
+        TEST_METHOD(GeometryDecodingMatchesScalar)
+        {
+            std::vector<double> values = {
+                0.0, -0.0, 1.0, -1.0, 0.1, 1.0 / 3.0, 16777217.0, -16777217.0,
+                1e-40, -1e-40, 1e-320, 3.5e38, -3.5e38, 1e300,
+                std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::max(), std::numeric_limits<double>::min() };
+
+            std::mt19937 random(87);
+            std::uniform_real_distribution<double> coordinate(-100000.0, 100000.0);
+            while (values.size() < 1000)
+            {
+                values.push_back(coordinate(random));
+            }
+
+            using Converter = void(*)(const double*, size_t, float*);
+            std::vector<std::pair<const wchar_t*, Converter>> converters = {
+                { L"SSE2", GeometryDecoding::NarrowToFloatSse2 },
+                { L"dispatch", GeometryDecoding::NarrowToFloat } };
+            if (GeometryDecoding::IsAvxSupported())
+            {
+                converters.emplace_back(L"AVX", GeometryDecoding::NarrowToFloatAvx);
+            }
+
+            for (size_t count = 0; count <= 40; ++count)
+            {
+                // Start at an odd offset too, so that the loads aren't always aligned.
+                for (size_t offset = 0; offset < 2; ++offset)
+                {
+                    std::vector<float> expected(count);
+                    GeometryDecoding::NarrowToFloatScalar(values.data() + offset, count, expected.data());
+
+                    for (const auto& [name, converter] : converters)
+                    {
+                        // Fill one extra slot so that writing past the end is caught.
+                        std::vector<float> actual(count + 1, 42.0f);
+                        converter(values.data() + offset, count, actual.data());
+
+                        Assert::AreEqual(0, memcmp(expected.data(), actual.data(), count * sizeof(float)), name);
+                        Assert::AreEqual(42.0f, actual.back(), name);
+                    }
+                }
+            }
+
+            std::vector<float> expected(values.size());
+            std::vector<float> actual(values.size());
+            GeometryDecoding::NarrowToFloatScalar(values.data(), values.size(), expected.data());
+            for (const auto& [name, converter] : converters)
+            {
+                converter(values.data(), values.size(), actual.data());
+                Assert::AreEqual(0, memcmp(expected.data(), actual.data(), values.size() * sizeof(float)), name);
+            }
+        }
+
+        // Decodes a large SAFEARRAY of bounding rectangles and compares it with a scalar decoding of the same data,
+        // logging how long each takes.
+        TEST_METHOD(RectSafeArrayDecoding)
+        {
+            constexpr size_t c_rectCount = 500000;
+
+            std::mt19937 random(87);
+            std::uniform_real_distribution<double> coordinate(-10000.0, 10000.0);
+            std::vector<double> packed(c_rectCount * 4);
+            for (auto& value : packed)
+            {
+                value = coordinate(random);
+            }
+
+            const auto scalarStart = std::chrono::steady_clock::now();
+            std::vector<winrt::Windows::Foundation::Rect> expected;
+            expected.reserve(c_rectCount);
+            for (size_t i = 0; i < c_rectCount; ++i)
+            {
+                expected.emplace_back(
+                    static_cast<float>(packed[4 * i]),
+                    static_cast<float>(packed[4 * i + 1]),
+                    static_cast<float>(packed[4 * i + 2]),
+                    static_cast<float>(packed[4 * i + 3]));
+            }
+            const auto scalarTime = std::chrono::steady_clock::now() - scalarStart;
+
+            auto safeArray = ArrayToSafeArray<VT_R8>(packed.data(), static_cast<int>(packed.size()));
+            const auto decodeStart = std::chrono::steady_clock::now();
+            UiaArray<UiaRect> rects(std::move(safeArray));
+            const auto decodeTime = std::chrono::steady_clock::now() - decodeStart;
+
+            const auto& actual = *rects;
+            Assert::AreEqual(expected.size(), actual.size());
+            Assert::AreEqual(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(winrt::Windows::Foundation::Rect)));
+
+            auto oddLength = ArrayToSafeArray<VT_R8>(packed.data(), 6);
+            Assert::ExpectException<winrt::hresult_error>([&]() { UiaArray<UiaRect> invalid(std::move(oddLength)); });
+
+            Logger::WriteMessage((L"Decoding " + std::to_wstring(c_rectCount) + L" rects took " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(decodeTime).count()) + L"us, against " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(scalarTime).count()) + L"us for a scalar loop" +
+                (GeometryDecoding::IsAvxSupported() ? L" (AVX)" : L" (SSE2)")).c_str());
+        }
+
+        // Asserts that a type switch over mixed-type property values runs exactly one matching handler per value,
+        // and that the frequencies of the resolved values can be observed for later switches.
+        void TypeSwitchTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaElement element = calc;
+            std::vector<UiaVariant> values{
+                element.GetPropertyValue(UiaPropertyId(UIA_NamePropertyId)),
+                element.GetPropertyValue(UiaPropertyId(UIA_ControlTypePropertyId)),
+                element.GetPropertyValue(UiaPropertyId(UIA_IsEnabledPropertyId)),
+                element.GetPropertyValue(UiaPropertyId(UIA_ProcessIdPropertyId)),
+                element.GetPropertyValue(UiaPropertyId(UIA_AutomationIdPropertyId)),
+                element.GetPropertyValue(UiaPropertyId(UIA_BoundingRectanglePropertyId)),
+            };
+
+            UiaUint strings = 0u;
+            UiaUint ints = 0u;
+            UiaUint bools = 0u;
+            UiaUint others = 0u;
+            UiaString name = L"";
+            for (const auto& value : values)
+            {
+                UiaTypeSwitch(scope, value)
+                    .Case<UiaBool>([&](UiaBool) { bools += 1u; })
+                    .Case<UiaInt>([&](UiaInt) { ints += 1u; })
+                    .Case<UiaString>([&](UiaString string)
+                    {
+                        strings += 1u;
+                        scope.If(string == UiaString(L"Display is 0"), [&]()
+                        {
+                            name = string;
+                        });
+                    }, 2)
+                    // A second case for the same type is never tested.
+                    .Case<UiaString>([&](UiaString) { others += 100u; })
+                    .Default([&]() { others += 1u; })
+                    .Run();
+            }
+
+            scope.BindResult(strings);
+            scope.BindResult(ints);
+            scope.BindResult(bools);
+            scope.BindResult(others);
+            scope.BindResult(name);
+            for (auto& value : values)
+            {
+                scope.BindResult(value);
+            }
+
+            scope.Resolve();
+
+            Assert::AreEqual(2u, static_cast<unsigned int>(strings));
+            Assert::AreEqual(2u, static_cast<unsigned int>(ints));
+            Assert::AreEqual(1u, static_cast<unsigned int>(bools));
+            Assert::AreEqual(1u, static_cast<unsigned int>(others));
+            Assert::AreEqual(std::wstring(L"Display is 0"), std::wstring(static_cast<wil::shared_bstr>(name).get()));
+
+            UiaTypeFrequencies frequencies;
+            for (const auto& value : values)
+            {
+                frequencies.Observe(value);
+            }
+            Assert::AreEqual(static_cast<uint64_t>(2), frequencies.Count(VT_BSTR));
+            Assert::AreEqual(static_cast<uint64_t>(2), frequencies.Count(VT_I4));
+            Assert::AreEqual(static_cast<uint64_t>(1), frequencies.Count(VT_BOOL));
+        }
+
+        TEST_METHOD(TypeSwitchLocalTest)
+        {
+            TypeSwitchTest(false);
+        }
+
+        TEST_METHOD(TypeSwitchRemoteTest)
+        {
+            TypeSwitchTest(true);
+        }
+
+        // Asserts that the children fetched all at once match the ones found by walking the siblings one at a time,
+        // and that the cache request is applied to each of them.
+        void ChildElementsTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaElement element = calc;
+            UiaElement parent = element.GetParentElement();
+
+            UiaArray<UiaString> walkedNames;
+            UiaElement child = parent.GetFirstChildElement();
+            scope.While([&]()
+            {
+                return !child.IsNull();
+            },
+            [&]()
+            {
+                walkedNames.Append(child.GetName());
+                child = child.GetNextSiblingElement();
+            });
+
+            UiaOperationAbstraction::UiaCacheRequest cacheRequest;
+            cacheRequest.AddProperty(UIA_NamePropertyId);
+
+            UiaArray<UiaElement> children = GetChildElements(parent, cacheRequest);
+            UiaArray<UiaString> fetchedNames;
+            scope.ForEach(children, [&](UiaElement fetched)
+            {
+                fetchedNames.Append(fetched.GetName(true /* useCachedApi */));
+            });
+
+            UiaArray<UiaString> visitedNames;
+            ForEachChildElement(parent, [&](UiaElement visited)
+            {
+                visitedNames.Append(visited.GetName());
+            });
+
+            scope.BindResult(walkedNames);
+            scope.BindResult(fetchedNames);
+            scope.BindResult(visitedNames);
+            scope.Resolve();
+
+            const auto& localWalkedNames = *walkedNames;
+            const auto& localFetchedNames = *fetchedNames;
+            const auto& localVisitedNames = *visitedNames;
+            Assert::IsTrue(localWalkedNames.size() > 0);
+            Assert::AreEqual(localWalkedNames.size(), localFetchedNames.size());
+            Assert::AreEqual(localWalkedNames.size(), localVisitedNames.size());
+            for (size_t i = 0; i < localWalkedNames.size(); ++i)
+            {
+                Assert::AreEqual(std::wstring(localWalkedNames[i].get()), std::wstring(localFetchedNames[i].get()));
+                Assert::AreEqual(std::wstring(localWalkedNames[i].get()), std::wstring(localVisitedNames[i].get()));
+            }
+        }
+
+        TEST_METHOD(ChildElementsLocalTest)
+        {
+            ChildElementsTest(false);
+        }
+
+        TEST_METHOD(ChildElementsRemoteTest)
+        {
+            ChildElementsTest(true);
+        }
+
+        // Asserts that batched local property reads return the same values as direct ones, with one cross-process
+        // call per element once the batch has learned which properties are read.
+        void LocalPropertyBatchTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto readChildren = [&](bool batch, const std::vector<PROPERTYID>& propertiesToBatch = {})
+            {
+                auto scope = UiaOperationScope::StartNew();
+                if (batch)
+                {
+                    scope.BatchLocalPropertyReads(propertiesToBatch);
+                }
+
+                UiaElement element = calc;
+                UiaElement parent = element.GetParentElement();
+
+                UiaArray<UiaString> properties;
+                UiaUint enabledCount = 0u;
+                ForEachChildElement(parent, [&](UiaElement child)
+                {
+                    properties.Append(child.GetName());
+                    properties.Append(child.GetAutomationId());
+                    properties.Append(child.GetClassName());
+                    scope.If(child.GetIsEnabled(), [&]()
+                    {
+                        enabledCount += 1u;
+                    });
+                });
+
+                scope.BindResult(properties);
+                scope.BindResult(enabledCount);
+                scope.Resolve();
+
+                const auto batchState = scope.GetLocalPropertyBatch();
+                return std::make_tuple(
+                    *properties,
+                    static_cast<unsigned int>(enabledCount),
+                    batchState ? batchState->GetBuildCount() : 0);
+            };
+
+            const auto [directProperties, directEnabledCount, directBuildCount] = readChildren(false);
+            const auto [batchedProperties, batchedEnabledCount, batchedBuildCount] = readChildren(true);
+
+            Assert::IsTrue(directProperties.size() > 0);
+            Assert::AreEqual(directProperties.size(), batchedProperties.size());
+            for (size_t i = 0; i < directProperties.size(); ++i)
+            {
+                Assert::AreEqual(std::wstring(directProperties[i].get()), std::wstring(batchedProperties[i].get()));
+            }
+            Assert::AreEqual(directEnabledCount, batchedEnabledCount);
+            Assert::AreEqual(static_cast<uint64_t>(0), directBuildCount);
+
+            if (useRemoteOperations)
+            {
+                // Remote operations read all of their properties in one call already.
+                Assert::AreEqual(static_cast<uint64_t>(0), batchedBuildCount);
+            }
+            else
+            {
+                // The first child builds its cache once per newly seen property, and every other child once.
+                const auto childCount = directProperties.size() / 3;
+                Assert::AreEqual(static_cast<uint64_t>(childCount + 3), batchedBuildCount);
+
+                // Naming the properties up front spares the first child its extra builds.
+                const auto [preparedProperties, preparedEnabledCount, preparedBuildCount] = readChildren(
+                    true,
+                    { UIA_NamePropertyId, UIA_AutomationIdPropertyId, UIA_ClassNamePropertyId, UIA_IsEnabledPropertyId });
+                Assert::AreEqual(directProperties.size(), preparedProperties.size());
+                Assert::AreEqual(directEnabledCount, preparedEnabledCount);
+                Assert::AreEqual(static_cast<uint64_t>(childCount), preparedBuildCount);
+            }
+        }
+
+        TEST_METHOD(LocalPropertyBatchLocalTest)
+        {
+            LocalPropertyBatchTest(false);
+        }
+
+        TEST_METHOD(LocalPropertyBatchRemoteTest)
+        {
+            LocalPropertyBatchTest(true);
+        }
+
+        // Asserts that adjacent loops over the same array produce the same results whether or not the remote
+        // operation fuses them, including when the second loop depends on the first one having finished.
+        void LoopFusionTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaElement element = calc;
+            UiaArray<UiaElement> children = GetChildElements(element.GetParentElement());
+            UiaArray<UiaInt> ints{ std::vector<int>{ 1, 2, 3 } };
+            scope.BindInput(ints);
+
+            // Loops that each collect into an array of their own, which can be fused.
+            UiaArray<UiaString> names;
+            scope.ForEach(children, [&](UiaElement child)
+            {
+                names.Append(child.GetName());
+            });
+
+            UiaArray<UiaBool> enabledStates;
+            scope.ForEach(children, [&](UiaElement child)
+            {
+                enabledStates.Append(child.GetIsEnabled());
+            });
+
+            // Independent loops, which can be fused.
+            UiaUint nameLength{ 0 };
+            scope.ForEach(children, [&](UiaElement child)
+            {
+                nameLength += child.GetName().Length();
+            });
+
+            UiaUint enabledCount{ 0 };
+            scope.ForEach(children, [&](UiaElement child)
+            {
+                scope.If(child.GetIsEnabled(), [&]()
+                {
+                    enabledCount += 1;
+                });
+            });
+
+            // The first loop increments its element in place, which the second one must not see.
+            UiaInt incrementedSum{ 0 };
+            scope.ForEach(ints, [&](UiaInt value)
+            {
+                value += 1;
+                incrementedSum += value;
+            });
+
+            UiaInt sum{ 0 };
+            scope.ForEach(ints, [&](UiaInt value)
+            {
+                sum += value;
+            });
+
+            // The first loop breaks out early, which must not cut the second one short.
+            UiaUint iterationsBeforeBreak{ 0 };
+            scope.ForEach(ints, [&](UiaInt /* value */)
+            {
+                iterationsBeforeBreak += 1;
+                scope.Break();
+            });
+
+            UiaUint iterationsAfterBreak{ 0 };
+            scope.ForEach(ints, [&](UiaInt /* value */)
+            {
+                iterationsAfterBreak += 1;
+            });
+
+            // The second loop reads what the first one accumulates, so they must stay apart.
+            UiaUint visitedCount{ 0 };
+            scope.ForEach(children, [&](UiaElement /* child */)
+            {
+                visitedCount += 1;
+            });
+
+            UiaArray<UiaUint> visitedCounts;
+            scope.ForEach(children, [&](UiaElement /* child */)
+            {
+                visitedCounts.Append(visitedCount);
+            });
+
+            scope.BindResult(children);
+            scope.BindResult(names);
+            scope.BindResult(enabledStates);
+            scope.BindResult(nameLength);
+            scope.BindResult(enabledCount);
+            scope.BindResult(incrementedSum);
+            scope.BindResult(sum);
+            scope.BindResult(iterationsBeforeBreak);
+            scope.BindResult(iterationsAfterBreak);
+            scope.BindResult(visitedCount);
+            scope.BindResult(visitedCounts);
+            scope.Resolve();
+
+            const auto& localChildren = *children;
+            const auto& localNames = *names;
+            const auto& localEnabledStates = *enabledStates;
+            const auto& localVisitedCounts = *visitedCounts;
+            Assert::IsTrue(localChildren.size() > 0);
+            Assert::AreEqual(localChildren.size(), localNames.size());
+            Assert::AreEqual(localChildren.size(), localEnabledStates.size());
+            Assert::AreEqual(9, static_cast<int>(incrementedSum));
+            Assert::AreEqual(6, static_cast<int>(sum));
+            Assert::AreEqual(1u, static_cast<unsigned int>(iterationsBeforeBreak));
+            Assert::AreEqual(3u, static_cast<unsigned int>(iterationsAfterBreak));
+            Assert::AreEqual(localChildren.size(), localVisitedCounts.size());
+            Assert::AreEqual(
+                static_cast<size_t>(std::count_if(localEnabledStates.begin(), localEnabledStates.end(), [](BOOL enabled) { return !!enabled; })),
+                static_cast<size_t>(static_cast<unsigned int>(enabledCount)));
+            Assert::AreEqual(localChildren.size(), static_cast<size_t>(static_cast<unsigned int>(visitedCount)));
+
+            for (const auto& count : localVisitedCounts)
+            {
+                Assert::AreEqual(static_cast<unsigned int>(visitedCount), static_cast<unsigned int>(count));
+            }
+        }
+
+        TEST_METHOD(LoopFusionLocalTest)
+        {
+            LoopFusionTest(false);
+        }
+
+        TEST_METHOD(LoopFusionRemoteTest)
+        {
+            LoopFusionTest(true);
+        }
+
+        // Asserts that a subtree snapshot reads back with the same structure and properties as the live tree, and
+        // that the writer keeps nodes in order across many spilled pages.
+        void SubtreeSnapshotTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            const auto path = std::filesystem::temp_directory_path() /
+                (useRemoteOperations ? L"SubtreeSnapshotRemoteTest.uias" : L"SubtreeSnapshotLocalTest.uias");
+            auto deleteFile = wil::scope_exit([&]()
+            {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            });
+
+            // Synthetic nodes, with pages small enough that every column spills many times.
+            {
+                UiaSnapshotWriter writer(path.wstring(), 16 /* pageSize */);
+                UiaSnapshotNode root;
+                root.name = L"root";
+                writer.Append(root);
+
+                for (uint32_t i = 1; i < 10000; ++i)
+                {
+                    const auto name = std::to_wstring(i % 100);
+                    UiaSnapshotNode node;
+                    node.parentIndex = (i - 1) / 4;
+                    node.name = name;
+                    node.controlType = UIA_ButtonControlTypeId;
+                    node.boundingRectangle = { static_cast<float>(i), 0.0f, 1.0f, 1.0f };
+                    node.isEnabled = (i % 2) == 0;
+                    Assert::AreEqual(i, writer.Append(node));
+                }
+                writer.Finish();
+            }
+
+            {
+                UiaSnapshotReader reader(path.wstring());
+                Assert::AreEqual(10000u, reader.GetNodeCount());
+                Assert::AreEqual(std::wstring(L"root"), std::wstring(reader.GetNode(0).name));
+                Assert::AreEqual(c_snapshotNoParent, reader.GetParentIndex(0));
+
+                for (uint32_t i = 1; i < reader.GetNodeCount(); ++i)
+                {
+                    const auto node = reader.GetNode(i);
+                    Assert::AreEqual((i - 1) / 4, node.parentIndex);
+                    Assert::AreEqual(std::to_wstring(i % 100), std::wstring(node.name));
+                    Assert::IsTrue(node.automationId.empty());
+                    Assert::AreEqual(static_cast<int>(UIA_ButtonControlTypeId), static_cast<int>(node.controlType));
+                    Assert::AreEqual(static_cast<float>(i), node.boundingRectangle.X);
+                    Assert::AreEqual((i % 2) == 0, node.isEnabled);
+                }
+
+                const auto [begin, end] = reader.GetChildRange(10);
+                Assert::AreEqual(41u, begin);
+                Assert::AreEqual(45u, end);
+            }
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            size_t windowChildCount = 0;
+            std::wstring windowName;
+            UiaElement window = [&]()
+            {
+                auto scope = UiaOperationScope::StartNew();
+                UiaElement element = calc;
+                UiaElement parent = element.GetParentElement();
+                UiaArray<UiaElement> children = GetChildElements(parent);
+                UiaString name = parent.GetName();
+                scope.BindResult(parent, children, name);
+                scope.Resolve();
+
+                windowChildCount = (*children).size();
+                windowName = name.GetLocalWstring();
+                return parent;
+            }();
+
+            const auto nodeCount = WriteSubtreeSnapshot(window, path.wstring(), 8 /* elementsPerOperation */);
+
+            UiaSnapshotReader reader(path.wstring());
+            Assert::AreEqual(nodeCount, reader.GetNodeCount());
+            Assert::IsTrue(nodeCount > 1);
+
+            // Every node's children point back at it, and every node but the root is the child of exactly one node.
+            uint32_t childCount = 0;
+            for (uint32_t i = 0; i < reader.GetNodeCount(); ++i)
+            {
+                const auto [begin, end] = reader.GetChildRange(i);
+                for (auto child = begin; child < end; ++child)
+                {
+                    Assert::AreEqual(i, reader.GetParentIndex(child));
+                }
+                childCount += end - begin;
+            }
+            Assert::AreEqual(nodeCount - 1, childCount);
+
+            const auto root = reader.GetNode(0);
+            Assert::AreEqual(windowName, std::wstring(root.name));
+            Assert::IsFalse(root.runtimeId.empty());
+
+            const auto [begin, end] = reader.GetChildRange(0);
+            Assert::AreEqual(static_cast<uint32_t>(windowChildCount), end - begin);
+        }
+
+        TEST_METHOD(SubtreeSnapshotLocalTest)
+        {
+            SubtreeSnapshotTest(false);
+        }
+
+        TEST_METHOD(SubtreeSnapshotRemoteTest)
+        {
+            SubtreeSnapshotTest(true);
+        }
+
+        // Asserts that decoding a string array into a table yields the same strings as decoding it into a
+        // UiaArray<UiaString>, and compares the cost of the two on a large array.
+        TEST_METHOD(StringTableDecodingBenchmark)
+        {
+            auto guard = InitializeUiaOperationAbstraction(false);
+
+            std::vector<winrt::Windows::Foundation::IInspectable> items;
+            for (int i = 0; i < 100000; ++i)
+            {
+                items.emplace_back((i % 1000 == 0) ? nullptr : winrt::box_value(winrt::hstring(L"Element name " + std::to_wstring(i))));
+            }
+            const auto result = winrt::single_threaded_vector<winrt::Windows::Foundation::IInspectable>(std::move(items));
+
+            const auto arrayStart = std::chrono::steady_clock::now();
+            UiaArray<UiaString> array;
+            array.FromRemoteResult(result);
+            Logger::WriteMessage((L"Decoding 100000 strings into an array took " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - arrayStart).count()) + L"us").c_str());
+
+            const auto tableStart = std::chrono::steady_clock::now();
+            UiaStringTable table;
+            table.FromRemoteResult(result);
+            Logger::WriteMessage((L"Decoding 100000 strings into a table took " +
+                std::to_wstring(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tableStart).count()) + L"us").c_str());
+
+            const auto& localArray = *array;
+            Assert::AreEqual(localArray.size(), table.Size());
+            for (size_t i = 0; i < table.Size(); ++i)
+            {
+                Assert::AreEqual(!localArray[i], table.IsNull(i));
+                Assert::AreEqual(std::wstring(localArray[i] ? localArray[i].get() : L""), std::wstring(table[i]));
+            }
+        }
+
+        // Asserts that a string array bound to a table resolves to the same strings as one bound directly.
+        void StringTableResultTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaElement element = calc;
+            UiaArray<UiaString> names;
+            UiaArray<UiaString> tableNames;
+            ForEachChildElement(element.GetParentElement(), [&](UiaElement child)
+            {
+                names.Append(child.GetName());
+                tableNames.Append(child.GetName());
+            });
+
+            // A nested remote scope never resolves the array, so binding it to a table there fails rather than
+            // leaving the table empty.
+            if (useRemoteOperations)
+            {
+                auto nestedScope = UiaOperationScope::StartNew();
+                UiaStringTable nestedTable;
+                Assert::ExpectException<wil::ResultException>([&]()
+                {
+                    nestedScope.BindStringTableResult(tableNames, nestedTable);
+                });
+            }
+
+            UiaStringTable table;
+            scope.BindResult(names);
+            scope.BindStringTableResult(tableNames, table);
+            scope.Resolve();
+
+            const auto& localNames = *names;
+            Assert::IsTrue(localNames.size() > 0);
+            Assert::AreEqual(localNames.size(), table.Size());
+            for (size_t i = 0; i < table.Size(); ++i)
+            {
+                Assert::AreEqual(std::wstring(localNames[i] ? localNames[i].get() : L""), std::wstring(table[i]));
+            }
+        }
+
+        TEST_METHOD(StringTableResultLocalTest)
+        {
+            StringTableResultTest(false);
+        }
+
+        TEST_METHOD(StringTableResultRemoteTest)
+        {
+            StringTableResultTest(true);
+        }
+
+        // Crawls a stand-in for several processes' trees, where each process serves one operation at a time with a
+        // fixed round trip, and compares the time one worker and several workers take to visit every node.
+        TEST_METHOD(WorkStealingCrawlBenchmark)
+        {
+            constexpr size_t c_processCount = 8;
+            // A complete tree with four children per node, five levels deep.
+            constexpr uint32_t c_nodesPerProcess = 341;
+            constexpr uint32_t c_nodesPerOperation = 16;
+            constexpr auto c_roundTrip = std::chrono::milliseconds(1);
+
+            std::vector<std::mutex> providers(c_processCount);
+
+            auto crawl = [&](size_t workerCount)
+            {
+                std::atomic<uint32_t> visitedCount{ 0 };
+
+                // Each task visits up to c_nodesPerOperation nodes breadth first from its root, in one round trip
+                // to the root's process, and spawns a task for each node left on its frontier.
+                std::function<void(UiaWorkStealingPool&, size_t, uint32_t)> visit =
+                    [&](UiaWorkStealingPool& pool, size_t process, uint32_t root)
+                {
+                    std::deque<uint32_t> pending{ root };
+                    uint32_t visited = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(providers[process]);
+                        std::this_thread::sleep_for(c_roundTrip);
+                        while (!pending.empty() && visited < c_nodesPerOperation)
+                        {
+                            const auto node = pending.front();
+                            pending.pop_front();
+                            ++visited;
+                            for (uint32_t child = node * 4 + 1; child <= node * 4 + 4 && child < c_nodesPerProcess; ++child)
+                            {
+                                pending.push_back(child);
+                            }
+                        }
+                    }
+                    visitedCount += visited;
+
+                    for (const auto node : pending)
+                    {
+                        pool.Spawn([&visit, process, node](UiaWorkStealingPool& taskPool)
+                        {
+                            visit(taskPool, process, node);
+                        });
+                    }
+                };
+
+                std::vector<UiaWorkStealingPool::Task> seeds;
+                for (size_t process = 0; process < c_processCount; ++process)
+                {
+                    seeds.emplace_back([&visit, process](UiaWorkStealingPool& pool)
+                    {
+                        visit(pool, process, 0);
+                    });
+                }
+
+                UiaWorkStealingPool pool(workerCount);
+                const auto start = std::chrono::steady_clock::now();
+                const auto metrics = pool.Run(std::move(seeds));
+                Logger::WriteMessage((L"Crawling " + std::to_wstring(c_processCount * c_nodesPerProcess) + L" nodes with " +
+                    std::to_wstring(workerCount) + L" workers took " +
+                    std::to_wstring(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()) +
+                    L"ms in " + std::to_wstring(metrics.taskCount) + L" tasks, " + std::to_wstring(metrics.stealCount) + L" stolen").c_str());
+
+                Assert::AreEqual(static_cast<uint32_t>(c_processCount * c_nodesPerProcess), visitedCount.load());
+            };
+
+            crawl(1);
+            crawl(c_processCount);
+        }
+
+        // Asserts that a parallel crawl split into many small operations, whose frontiers are queued in batches, finds
+        // the same elements, with the same parents and depths, as a crawl done in a single operation.
+        void CrawlSubtreesTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            UiaElement window = [&]()
+            {
+                auto scope = UiaOperationScope::StartNew();
+                UiaElement element = calc;
+                UiaElement parent = element.GetParentElement();
+                scope.BindResult(parent);
+                scope.Resolve();
+                return parent;
+            }();
+
+            auto crawl = [&](UiaCrawlOptions options)
+            {
+                std::mutex elementsLock;
+                std::map<std::wstring, UiaCrawledElement> elements;
+                std::atomic<size_t> failureCount{ 0 };
+                options.failureCallback = [&](const UiaCrawlFailure&)
+                {
+                    ++failureCount;
+                };
+                CrawlSubtrees({ window }, [&](std::vector<UiaCrawledElement>&& crawled)
+                {
+                    std::lock_guard<std::mutex> lock(elementsLock);
+                    for (auto& element : crawled)
+                    {
+                        auto runtimeId = element.runtimeId;
+                        elements.emplace(std::move(runtimeId), std::move(element));
+                    }
+                }, options);
+                // Nothing goes away while the calculator sits idle.
+                Assert::AreEqual(static_cast<size_t>(0), failureCount.load());
+                return elements;
+            };
+
+            UiaCrawlOptions singleOptions;
+            singleOptions.workerCount = 1;
+            singleOptions.maxDepthPerOperation = 1000;
+            singleOptions.maxElementsPerOperation = 100000;
+            const auto expected = crawl(singleOptions);
+
+            UiaCrawlOptions splitOptions;
+            splitOptions.workerCount = 4;
+            splitOptions.maxDepthPerOperation = 2;
+            splitOptions.maxElementsPerOperation = 4;
+            const auto actual = crawl(splitOptions);
+
+            Assert::IsTrue(expected.size() > 1);
+            Assert::AreEqual(expected.size(), actual.size());
+
+            size_t rootCount = 0;
+            for (const auto& [runtimeId, element] : actual)
+            {
+                const auto it = expected.find(runtimeId);
+                Assert::IsTrue(it != expected.end());
+                Assert::AreEqual(it->second.parentRuntimeId, element.parentRuntimeId);
+                Assert::AreEqual(it->second.depth, element.depth);
+
+                if (element.parentRuntimeId.empty())
+                {
+                    ++rootCount;
+                    Assert::AreEqual(0u, element.depth);
+                }
+                else
+                {
+                    Assert::AreEqual(actual.at(element.parentRuntimeId).depth + 1, element.depth);
+                }
+            }
+            Assert::AreEqual(static_cast<size_t>(1), rootCount);
+        }
+
+        TEST_METHOD(CrawlSubtreesLocalTest)
+        {
+            CrawlSubtreesTest(false);
+        }
+
+        TEST_METHOD(CrawlSubtreesRemoteTest)
+        {
+            CrawlSubtreesTest(true);
+        }
+
+        // Asserts that the sizer converges on each connection's limit independently, with few operations over it,
+        // and that a learned instruction budget caps the size for costlier items.
+        TEST_METHOD(OperationSizerConvergesTest)
+        {
+            using winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus;
+
+            UiaOperationSizer sizer;
+            const std::map<uint64_t, uint32_t> limits{ { 1, 300 }, { 2, 40 } };
+
+            constexpr int c_operationCount = 500;
+            for (int i = 0; i < c_operationCount; ++i)
+            {
+                for (const auto& [connectionId, limit] : limits)
+                {
+                    const auto size = sizer.GetSize(connectionId);
+                    sizer.Record(connectionId, size,
+                        (size > limit) ? AutomationRemoteOperationStatus::InstructionLimitExceeded : AutomationRemoteOperationStatus::Success);
+                }
+            }
+
+            const auto learned = sizer.GetLearnedSizes();
+            Assert::AreEqual(limits.size(), learned.size());
+            for (const auto& [connectionId, limit] : limits)
+            {
+                const auto& state = learned.at(connectionId);
+                Logger::WriteMessage((L"Connection " + std::to_wstring(connectionId) + L": size " + std::to_wstring(state.size) +
+                    L", " + std::to_wstring(state.limitExceededCount) + L" of " + std::to_wstring(c_operationCount) +
+                    L" operations over the limit").c_str());
+
+                Assert::IsTrue(state.largestSucceededSize <= limit);
+                Assert::IsTrue(state.largestSucceededSize > limit / 2);
+                Assert::IsTrue(state.limitExceededCount > 0);
+                Assert::IsTrue(state.limitExceededCount < c_operationCount / 10);
+            }
+
+            // A provider with a budget of 1000 instructions. Once the sizer has seen 100 items of 10 instructions
+            // hit the limit, operations of 20-instruction items settle under 50 items.
+            sizer.Reset();
+            sizer.Record(3, 100, AutomationRemoteOperationStatus::InstructionLimitExceeded, 1000);
+            Assert::AreEqual(1000ull, static_cast<unsigned long long>(sizer.GetLearnedSizes().at(3).instructionBudget));
+
+            uint64_t lateLimitExceededCount = 0;
+            for (int i = 0; i < 100; ++i)
+            {
+                const auto size = sizer.GetSize(3);
+                const auto estimate = size * 20ull;
+                const auto status = (estimate >= 1000) ?
+                    AutomationRemoteOperationStatus::InstructionLimitExceeded :
+                    AutomationRemoteOperationStatus::Success;
+                sizer.Record(3, size, status, estimate);
+                if (i >= 50 && status != AutomationRemoteOperationStatus::Success)
+                {
+                    ++lateLimitExceededCount;
+                }
+            }
+            Assert::IsTrue(sizer.GetSize(3) < 50);
+            Assert::AreEqual(0ull, static_cast<unsigned long long>(lateLimitExceededCount));
+        }
+
+        // Asserts that a crawl sized by a UiaOperationSizer finds the same elements as a fixed-size one, and that
+        // the sizer learns a size for the target process.
+        void AdaptiveCrawlTest(bool useRemoteOperations)
+        {
+            auto guard = InitializeUiaOperationAbstraction(useRemoteOperations);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            UiaElement window = [&]()
+            {
+                auto scope = UiaOperationScope::StartNew();
+                UiaElement element = calc;
+                UiaElement parent = element.GetParentElement();
+                scope.BindResult(parent);
+                scope.Resolve();
+                return parent;
+            }();
+
+            auto crawl = [&](const UiaCrawlOptions& options)
+            {
+                std::mutex elementsLock;
+                std::set<std::wstring> runtimeIds;
+                CrawlSubtrees({ window }, [&](std::vector<UiaCrawledElement>&& crawled)
+                {
+                    std::lock_guard<std::mutex> lock(elementsLock);
+                    for (const auto& element : crawled)
+                    {
+                        runtimeIds.insert(element.runtimeId);
+                    }
+                }, options);
+                return runtimeIds;
+            };
+
+            const auto expected = crawl(UiaCrawlOptions{});
+
+            UiaOperationSizer::Options sizerOptions;
+            sizerOptions.initialSize = 2;
+            UiaCrawlOptions adaptiveOptions;
+            adaptiveOptions.workerCount = 1;
+            adaptiveOptions.sizer = std::make_shared<UiaOperationSizer>(sizerOptions);
+            const auto actual = crawl(adaptiveOptions);
+
+            Assert::IsTrue(expected.size() > 2);
+            Assert::IsTrue(expected == actual);
+
+            const auto learned = adaptiveOptions.sizer->GetLearnedSizes();
+            Assert::AreEqual(static_cast<size_t>(1), learned.size());
+            const auto& state = learned.begin()->second;
+            Assert::IsTrue(state.successCount > 0);
+            Assert::IsTrue(state.size > 2);
+        }
+
+        TEST_METHOD(AdaptiveCrawlLocalTest)
+        {
+            AdaptiveCrawlTest(false);
+        }
+
+        TEST_METHOD(AdaptiveCrawlRemoteTest)
+        {
+            AdaptiveCrawlTest(true);
+        }
     };
 }
@@ -4,8 +4,16 @@
 #include "pch.h"
 #include "CppUnitTest.h"
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+#include <winrt/Windows.UI.UIAutomation.Core.h>
+
 #include "ModernApp.h"
 #include "TestUtils.h"
+#include "../Microsoft.UI.UIAutomation/StaticBytecodeBuilder.h"
 
 namespace WinRTBuilderTests
 {
@@ -573,5 +581,516 @@ namespace WinRTBuilderTests
             // failing behavior is released.
             // Assert::AreEqual(E_FAIL, hr);
         }
+
+        // Asserts that a byte-identical operation using the same result cache is served from the cache
+        // instead of executing again.
+        TEST_METHOD(ResultCacheReusesIdenticalOperationTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            const winrt::AutomationRemoteOperationResultCache cache{ std::chrono::seconds(60), 1024 * 1024 /* maxBytes */ };
+
+            auto getName = [&]()
+            {
+                winrt::AutomationRemoteOperation op;
+                op.UseResultCache(cache);
+                auto remoteElement = op.ImportElement(calc.as<winrt::AutomationElement>());
+                auto nameToken = op.RequestResponse(remoteElement.GetName());
+
+                auto results = op.Execute();
+                AssertSucceeded(results.OperationStatus());
+                return winrt::unbox_value<winrt::hstring>(results.GetResult(nameToken));
+            };
+
+            Assert::AreEqual(winrt::hstring(L"Display is 0"), getName());
+            Assert::AreEqual(winrt::hstring(L"Display is 0"), getName());
+
+            Assert::AreEqual(static_cast<uint64_t>(1), cache.MissCount());
+            Assert::AreEqual(static_cast<uint64_t>(1), cache.HitCount());
+            Assert::IsTrue(cache.CachedBytes() > 0);
+
+            cache.Clear();
+            Assert::AreEqual(static_cast<uint64_t>(0), cache.CachedBytes());
+        }
+
+        // Asserts that a recorded operation can be replayed without a provider and yields the recorded results.
+        TEST_METHOD(RecordAndReplayOperationTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            const auto path = std::filesystem::temp_directory_path() / L"RecordAndReplayOperationTest.uiar";
+            auto deleteFile = wil::scope_exit([&]()
+            {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            });
+
+            auto buildOperation = [](winrt::AutomationRemoteOperation& op, const winrt::AutomationElement& element)
+            {
+                auto remoteElement = op.ImportElement(element);
+                auto nameToken = op.RequestResponse(remoteElement.GetName());
+                auto runtimeIdToken = op.RequestResponse(remoteElement.GetRuntimeId());
+                return std::make_pair(nameToken, runtimeIdToken);
+            };
+
+            winrt::hstring recordedName;
+            std::vector<int> recordedRuntimeId;
+            {
+                const winrt::AutomationRemoteOperationRecorder recorder{ path.wstring() };
+                winrt::AutomationRemoteOperation op;
+                op.UseRecorder(recorder);
+                const auto [nameToken, runtimeIdToken] = buildOperation(op, calc.as<winrt::AutomationElement>());
+
+                auto results = op.Execute();
+                AssertSucceeded(results.OperationStatus());
+                recordedName = winrt::unbox_value<winrt::hstring>(results.GetResult(nameToken));
+                for (const auto& part : results.GetResult(runtimeIdToken).as<winrt::Windows::Foundation::Collections::IVector<winrt::Windows::Foundation::IInspectable>>())
+                {
+                    recordedRuntimeId.emplace_back(winrt::unbox_value<int>(part));
+                }
+                Assert::IsFalse(recordedRuntimeId.empty());
+
+                Assert::AreEqual(1u, recorder.RecordedCount());
+                recorder.Close();
+            }
+
+            // Replay the same operation against a null element: nothing reaches a provider.
+            const winrt::AutomationRemoteOperationReplayer replayer{ path.wstring() };
+            Assert::AreEqual(1u, replayer.RecordCount());
+
+            winrt::AutomationRemoteOperation op;
+            op.UseReplayer(replayer);
+            const auto [nameToken, runtimeIdToken] = buildOperation(op, nullptr);
+
+            auto results = op.Execute();
+            AssertSucceeded(results.OperationStatus());
+            Assert::AreEqual(recordedName, winrt::unbox_value<winrt::hstring>(results.GetResult(nameToken)));
+
+            std::vector<int> replayedRuntimeId;
+            for (const auto& part : results.GetResult(runtimeIdToken).as<winrt::Windows::Foundation::Collections::IVector<winrt::Windows::Foundation::IInspectable>>())
+            {
+                replayedRuntimeId.emplace_back(winrt::unbox_value<int>(part));
+            }
+            Assert::IsTrue(recordedRuntimeId == replayedRuntimeId);
+
+            Assert::AreEqual(0u, replayer.RemainingCount());
+            Assert::AreEqual(0u, replayer.BytecodeMismatchCount());
+
+            // Every record has been served.
+            winrt::AutomationRemoteOperation extraOp;
+            extraOp.UseReplayer(replayer);
+            Assert::AreEqual(E_BOUNDS, static_cast<HRESULT>(wil::ResultFromException([&]() { extraOp.Execute(); })));
+        }
+
+        // Asserts that an operation returning results that can't be replayed, such as elements, still succeeds and is
+        // recorded, but that replaying it fails instead of returning null for the element.
+        TEST_METHOD(RecordUnsupportedResultTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            const auto path = std::filesystem::temp_directory_path() / L"RecordUnsupportedResultTest.uiar";
+            auto deleteFile = wil::scope_exit([&]()
+            {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            });
+
+            const winrt::AutomationRemoteOperationRecorder recorder{ path.wstring() };
+            winrt::AutomationRemoteOperation op;
+            op.UseRecorder(recorder);
+            auto remoteElement = op.ImportElement(calc.as<winrt::AutomationElement>());
+            op.RequestResponse(remoteElement.GetParentElement());
+
+            auto results = op.Execute();
+            AssertSucceeded(results.OperationStatus());
+            Assert::AreEqual(1u, recorder.RecordedCount());
+            recorder.Close();
+
+            const winrt::AutomationRemoteOperationReplayer replayer{ path.wstring() };
+            winrt::AutomationRemoteOperation replayedOp;
+            replayedOp.UseReplayer(replayer);
+            auto replayedElement = replayedOp.ImportElement(calc.as<winrt::AutomationElement>());
+            replayedOp.RequestResponse(replayedElement.GetParentElement());
+            Assert::AreEqual(E_NOTIMPL, static_cast<HRESULT>(wil::ResultFromException([&]() { replayedOp.Execute(); })));
+        }
+
+        // Asserts that a recording whose counts claim more data than it holds is rejected before anything is
+        // allocated for it.
+        TEST_METHOD(ReplayCorruptRecordingTest)
+        {
+            const auto path = std::filesystem::temp_directory_path() / L"ReplayCorruptRecordingTest.uiar";
+            auto deleteFile = wil::scope_exit([&]()
+            {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            });
+
+            // The layout is described in RemoteOperationRecordingFormat.h.
+            auto writeInt = [](std::vector<uint8_t>& buffer, int value)
+            {
+                const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+                buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+            };
+
+            std::vector<uint8_t> results;
+            writeInt(results, 1); // result count
+            writeInt(results, 1); // operand ID
+            results.emplace_back(static_cast<uint8_t>(13)); // Int32Array
+            writeInt(results, 0x7fffffff); // element count
+
+            std::vector<uint8_t> record;
+            writeInt(record, 0); // bytecode
+            writeInt(record, 0); // imports
+            writeInt(record, 1); // requested results
+            writeInt(record, 1);
+            writeInt(record, 0); // status
+            writeInt(record, 0); // extended error
+            writeInt(record, static_cast<int>(results.size()));
+            record.insert(record.end(), results.begin(), results.end());
+
+            std::vector<uint8_t> file;
+            writeInt(file, 0x52414955); // "UIAR"
+            writeInt(file, 1); // version
+            writeInt(file, static_cast<int>(record.size()));
+            file.insert(file.end(), record.begin(), record.end());
+            {
+                std::ofstream stream(path, std::ios::binary);
+                stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+            }
+
+            const winrt::AutomationRemoteOperationReplayer replayer{ path.wstring() };
+            Assert::AreEqual(1u, replayer.RecordCount());
+
+            winrt::AutomationRemoteOperation op;
+            op.UseReplayer(replayer);
+            Assert::AreEqual(E_INVALIDARG, static_cast<HRESULT>(wil::ResultFromException([&]() { op.Execute(); })));
+        }
+
+        // Asserts that bytecode built at compile time runs as-is, without going through AutomationRemoteOperation.
+        TEST_METHOD(StaticBytecodeCalculatorTest)
+        {
+            static constexpr auto c_getNameAndParentName = []()
+            {
+                bytecode::StaticBytecodeBuilder<256> builder;
+                const auto element = builder.ImportElement();
+                builder.AddToResults(builder.GetPropertyValue(element, UIA_NamePropertyId));
+
+                const auto parent = builder.Navigate(element, NavigateDirection_Parent);
+                const auto parentName = builder.NewString(L"");
+                builder.If(builder.BoolNot(builder.IsNull(parent)), [&](auto& trueBlock)
+                {
+                    trueBlock.Set(parentName, trueBlock.GetPropertyValue(parent, UIA_NamePropertyId));
+                });
+                builder.AddToResults(parentName);
+                return builder;
+            }();
+
+            // The header is laid out exactly as the runtime serializer lays it out.
+            static_assert(c_getNameAndParentName.Data()[0] == bytecode::c_bytecodeCurrentVersion);
+            static_assert(c_getNameAndParentName.Data()[4] == static_cast<uint8_t>(bytecode::InstructionType::NewInt));
+            static_assert(c_getNameAndParentName.GetImportCount() == 1);
+            static_assert(c_getNameAndParentName.GetResultCount() == 2);
+
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            winrt::Windows::UI::UIAutomation::Core::CoreAutomationRemoteOperation op;
+            op.ImportElement({ c_getNameAndParentName.GetImports()[0].Value }, calc.as<winrt::AutomationElement>());
+            for (size_t i = 0; i < c_getNameAndParentName.GetResultCount(); ++i)
+            {
+                op.AddToResults({ c_getNameAndParentName.GetResults()[i].Value });
+            }
+
+            const auto results = op.Execute({ c_getNameAndParentName.Data(), static_cast<uint32_t>(c_getNameAndParentName.Size()) });
+            Assert::IsTrue(results.Status() == winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::Success);
+
+            const auto name = winrt::unbox_value<winrt::hstring>(results.GetOperand({ c_getNameAndParentName.GetResults()[0].Value }));
+            Assert::AreEqual(winrt::hstring(L"Display is 0"), name);
+            Assert::IsTrue(results.HasOperand({ c_getNameAndParentName.GetResults()[1].Value }));
+        }
+
+        // Asserts that operations using an identifier cache learn the lookups they execute, and that later
+        // operations get the same results without executing the lookups.
+        TEST_METHOD(IdentifierCacheTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            const winrt::AutomationRemoteIdentifierCache cache;
+
+            auto lookUpNamePropertyId = [&]()
+            {
+                winrt::AutomationRemoteOperation op;
+                op.UseIdentifierCache(cache);
+                op.ImportElement(calc.as<winrt::AutomationElement>());
+
+                auto propertyIdToken = op.RequestResponse(op.NewGuid(winrt::guid{ Name_Property_GUID }).LookupPropertyId());
+                auto guidToken = op.RequestResponse(op.NewEnum(winrt::AutomationPropertyId::Name).LookupGuid());
+
+                auto results = op.Execute();
+                AssertSucceeded(results.OperationStatus());
+                Assert::IsTrue(UIA_NamePropertyId == winrt::unbox_value<int32_t>(results.GetResult(propertyIdToken)));
+                Assert::IsTrue(winrt::guid{ Name_Property_GUID } == winrt::unbox_value<winrt::guid>(results.GetResult(guidToken)));
+            };
+
+            lookUpNamePropertyId();
+            Assert::AreEqual(static_cast<uint64_t>(2), cache.MissCount());
+            Assert::AreEqual(static_cast<uint64_t>(0), cache.HitCount());
+            Assert::AreEqual(2u, cache.Count());
+            Assert::AreEqual(0u, cache.PendingCount());
+
+            lookUpNamePropertyId();
+            Assert::AreEqual(static_cast<uint64_t>(2), cache.MissCount());
+            Assert::AreEqual(static_cast<uint64_t>(2), cache.HitCount());
+
+            // Requested identifiers are resolved together by a single prefetch.
+            cache.RequestPropertyId(winrt::guid{ AutomationId_Property_GUID });
+            cache.RequestAnnotationType(winrt::guid{ Annotation_Comment_GUID });
+            Assert::AreEqual(2u, cache.PendingCount());
+
+            cache.Prefetch(calc.as<winrt::AutomationElement>());
+            Assert::AreEqual(0u, cache.PendingCount());
+            Assert::AreEqual(4u, cache.Count());
+
+            cache.Clear();
+            Assert::AreEqual(0u, cache.Count());
+        }
+
+        // Asserts that a reset operation can be built and executed again, and logs how many operations per second
+        // run back to back with new operations and with one reset operation.
+        TEST_METHOD(ResetOperationTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            auto getName = [&](winrt::AutomationRemoteOperation& op)
+            {
+                auto remoteElement = op.ImportElement(calc.as<winrt::AutomationElement>());
+                auto nameToken = op.RequestResponse(remoteElement.GetName());
+
+                auto results = op.Execute();
+                AssertSucceeded(results.OperationStatus());
+                return winrt::unbox_value<winrt::hstring>(results.GetResult(nameToken));
+            };
+
+            winrt::AutomationRemoteOperation op;
+            Assert::AreEqual(winrt::hstring(L"Display is 0"), getName(op));
+            op.Reset();
+            Assert::AreEqual(winrt::hstring(L"Display is 0"), getName(op));
+
+            constexpr int c_iterations = 200;
+            const auto newStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < c_iterations; ++i)
+            {
+                winrt::AutomationRemoteOperation newOp;
+                getName(newOp);
+            }
+            const std::chrono::duration<double> newElapsed = std::chrono::steady_clock::now() - newStart;
+
+            const auto resetStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < c_iterations; ++i)
+            {
+                op.Reset();
+                getName(op);
+            }
+            const std::chrono::duration<double> resetElapsed = std::chrono::steady_clock::now() - resetStart;
+
+            std::wostringstream message;
+            message << L"New operations: " << c_iterations / newElapsed.count() << L" ops/s, "
+                << L"reset operation: " << c_iterations / resetElapsed.count() << L" ops/s";
+            Logger::WriteMessage(message.str().c_str());
+        }
+
+        // Asserts that adjacent loops over the same array are fused when running them interleaved is safe, and are
+        // left apart otherwise, by comparing how many instructions the operations serialize.
+        TEST_METHOD(LoopFusionInstructionCountTest)
+        {
+            ModernApp app(L"Microsoft.WindowsCalculator_8wekyb3d8bbwe!App");
+            app.Activate();
+            auto calc = WaitForElementFocus(L"Display is 0");
+
+            // Fusing drops the second loop's setup (3 instructions), its loop block, condition check and jump back
+            // (4), and its GetAt and condition update (5).
+            constexpr uint32_t c_fusionSavings = 12;
+
+            struct Operands
+            {
+                winrt::AutomationRemoteUint count{ nullptr };
+                winrt::AutomationRemoteUint sum{ nullptr };
+                winrt::AutomationRemoteArray list{ nullptr };
+                winrt::AutomationRemoteArray shared{ nullptr };
+            };
+            using LoopBody = std::function<void(winrt::AutomationRemoteOperation& op, const Operands& operands, winrt::AutomationRemoteAnyObject element)>;
+
+            // Emits a loop over the array the same way UiaOperationScope::ForEach does, which is what fusion looks for.
+            const auto forEach = [](
+                winrt::AutomationRemoteOperation& op,
+                const winrt::AutomationRemoteArray& array,
+                const std::function<void(winrt::AutomationRemoteAnyObject element)>& body)
+            {
+                auto size = array.Size();
+                auto index = op.NewUint(0);
+                auto condition = index.IsLessThan(size);
+                op.WhileBlock(condition,
+                    [&]()
+                    {
+                        body(array.GetAt(index));
+                    },
+                    [&]()
+                    {
+                        index.Add(op.NewUint(1));
+                        condition.Set(index.IsLessThan(size));
+                    });
+            };
+
+            // Executes an operation running the given loops, either of which may be empty, over the same array, and
+            // returns the number of instructions it serialized. The loops are put in a try block if asked to.
+            const auto execute = [&](const LoopBody& first, const LoopBody& second, bool inTryBlock, bool fusionEnabled)
+            {
+                winrt::AutomationRemoteOperation op;
+                op.IsLoopFusionEnabled(fusionEnabled);
+                op.ImportElement(calc.as<winrt::AutomationElement>());
+
+                // The shared array is stored in another one, so it can be reached through that one as well.
+                const Operands operands{ op.NewUint(0), op.NewUint(0), op.NewArray(), op.NewArray() };
+                auto holder = op.NewArray();
+                holder.Append(operands.shared);
+                auto values = op.NewArray();
+                for (uint32_t i = 1; i <= 3; ++i)
+                {
+                    values.Append(op.NewUint(i));
+                }
+
+                const auto emitLoops = [&]()
+                {
+                    for (const auto& body : { first, second })
+                    {
+                        if (body)
+                        {
+                            forEach(op, values, [&](winrt::AutomationRemoteAnyObject element)
+                            {
+                                body(op, operands, element);
+                            });
+                        }
+                    }
+                };
+
+                if (inTryBlock)
+                {
+                    op.TryBlock(emitLoops);
+                }
+                else
+                {
+                    emitLoops();
+                }
+
+                op.RequestResponse(operands.count);
+                op.RequestResponse(operands.sum);
+                op.RequestResponse(operands.list);
+                AssertSucceeded(op.Execute().OperationStatus());
+                return op.LastInstructionCount();
+            };
+
+            const auto assertFused = [&](
+                bool fused, const LoopBody& first, const LoopBody& second, bool inTryBlock = false, bool fusionEnabled = true)
+            {
+                const auto prologueCount = execute(nullptr, nullptr, inTryBlock, fusionEnabled);
+                const auto separateCount =
+                    execute(first, nullptr, inTryBlock, fusionEnabled) + execute(nullptr, second, inTryBlock, fusionEnabled) - prologueCount;
+                Assert::AreEqual(fused ? separateCount - c_fusionSavings : separateCount, execute(first, second, inTryBlock, fusionEnabled));
+            };
+
+            const LoopBody countElements = [](auto& op, const Operands& operands, auto /* element */)
+            {
+                operands.count.Add(op.NewUint(1));
+            };
+            const LoopBody sumElements = [](auto& /* op */, const Operands& operands, auto element)
+            {
+                operands.sum.Add(element.AsUint());
+            };
+
+            // Independent bodies.
+            assertFused(true, countElements, sumElements);
+
+            // A body may update a container that it creates itself.
+            assertFused(true,
+                [](auto& op, const Operands& operands, auto element)
+                {
+                    auto pair = op.NewArray();
+                    pair.Append(element);
+                    pair.Append(element);
+                    operands.count.Add(pair.Size());
+                },
+                sumElements);
+
+            // The second body reads what the first one writes.
+            assertFused(false,
+                countElements,
+                [](auto& /* op */, const Operands& operands, auto /* element */)
+                {
+                    operands.sum.Add(operands.count);
+                });
+
+            // The first body increments its element in place, which the second body would then see.
+            assertFused(false,
+                [](auto& op, const Operands& /* operands */, auto element)
+                {
+                    element.AsUint().Add(op.NewUint(1));
+                },
+                sumElements);
+
+            // A body may also update a container created outside it, as long as nothing else can reach it.
+            assertFused(true,
+                [](auto& /* op */, const Operands& operands, auto element)
+                {
+                    operands.list.Append(element);
+                },
+                sumElements);
+
+            // But not one that is stored in another container, which may be shared with other operands.
+            assertFused(false,
+                [](auto& /* op */, const Operands& operands, auto element)
+                {
+                    operands.shared.Append(element);
+                },
+                sumElements);
+
+            // Populating the element's cache doesn't count as changing the element. The block never runs, since the
+            // elements are numbers.
+            assertFused(true,
+                [](auto& op, const Operands& /* operands */, auto element)
+                {
+                    op.IfBlock(op.NewBool(false), [&]()
+                    {
+                        element.AsElement().PopulateCache(op.NewCacheRequest());
+                    });
+                },
+                sumElements);
+
+            // Loops in a try block stay apart, so that a failure leaves the first loop finished, as it would be
+            // without fusion.
+            assertFused(false, countElements, sumElements, true /* inTryBlock */);
+
+            // Operations can opt out of fusion altogether.
+            assertFused(false, countElements, sumElements, false /* inTryBlock */, false /* fusionEnabled */);
+
+            // The first body breaks out of its loop, which would skip the rest of the second loop too.
+            assertFused(false,
+                [](auto& op, const Operands& operands, auto /* element */)
+                {
+                    operands.count.Add(op.NewUint(1));
+                    op.BreakLoop();
+                },
+                sumElements);
+        }
     };
 }
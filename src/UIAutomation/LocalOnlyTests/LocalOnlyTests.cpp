@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// Tests for builds of the operation abstraction that define UIA_OPERATION_ABSTRACTION_LOCAL_ONLY. The project
+// compiles the abstraction itself with the macro defined, so these tests are what keeps that build compiling.
+
+#include <wil/cppwinrt.h>
+#include <unknwn.h>
+#include <Windows.h>
+#include <UIAutomation.h>
+
+#include <string>
+
+#include <wil/resource.h>
+#include <wil/result.h>
+
+#include "CppUnitTest.h"
+
+#include "UiaOperationAbstraction.h"
+
+#ifndef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
+#error LocalOnlyTests must be built with UIA_OPERATION_ABSTRACTION_LOCAL_ONLY defined.
+#endif
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace UiaOperationAbstraction;
+
+namespace LocalOnlyTests
+{
+    static_assert(!ShouldUseRemoteApi(), "The mode check should be a compile-time constant in local-only builds.");
+
+    TEST_CLASS(LocalOnlyTests)
+    {
+    public:
+        // Asserts that a scope that reads from an element, branches and loops resolves locally.
+        TEST_METHOD(LocalScopeTest)
+        {
+            winrt::com_ptr<IUIAutomation> automation;
+            THROW_IF_FAILED(::CoCreateInstance(__uuidof(CUIAutomation8), nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(automation.put())));
+            Initialize(false /* useRemoteOperations */, automation.get());
+            auto cleanup = wil::scope_exit([]()
+            {
+                Cleanup();
+            });
+
+            winrt::com_ptr<IUIAutomationElement> desktop;
+            THROW_IF_FAILED(automation->GetRootElement(desktop.put()));
+            wil::unique_bstr expectedName;
+            THROW_IF_FAILED(desktop->get_CurrentName(&expectedName));
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaElement element = desktop;
+            UiaString name = element.GetName();
+
+            UiaInt sum = 0;
+            UiaInt i = 0;
+            scope.While([&]()
+            {
+                return i < 4;
+            },
+            [&]()
+            {
+                scope.If(i != 2, [&]()
+                {
+                    sum += i;
+                });
+                i += 1;
+            });
+
+            scope.BindResult(name, sum);
+            scope.Resolve();
+
+            Assert::AreEqual(std::wstring(expectedName.get()), std::wstring(static_cast<wil::shared_bstr>(name).get()));
+            Assert::AreEqual(4, static_cast<int>(sum));
+        }
+
+        // Asserts that asking for remote operations fails in local-only builds.
+        TEST_METHOD(RemoteDelegatorFailsTest)
+        {
+            Assert::ExpectException<wil::ResultException>([]()
+            {
+                UiaOperationDelegator delegator(true /* useRemoteApi */);
+            });
+        }
+    };
+}
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "AutomationRemoteIdentifierCache.h"
+
+#if __has_include("Microsoft.UI.UIAutomation.AutomationRemoteIdentifierCache.g.cpp")
+#include "Microsoft.UI.UIAutomation.AutomationRemoteIdentifierCache.g.cpp"
+#endif
+
+#include <utility>
+#include <vector>
+
+#include "AutomationRemoteOperation.h"
+
+namespace winrt
+{
+    using namespace winrt::Microsoft::UI::UIAutomation;
+    using namespace winrt::Windows::UI::UIAutomation;
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    std::optional<int> AutomationRemoteIdentifierCache::LookupId(const GUID& guid, AutomationIdentifierType type)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& identifiers = m_identifiers[type];
+        const auto it = identifiers.ids.find(guid);
+        if (it == identifiers.ids.end())
+        {
+            ++m_missCount;
+            identifiers.pendingGuids.insert(guid);
+            return std::nullopt;
+        }
+
+        ++m_hitCount;
+        return it->second;
+    }
+
+    std::optional<GUID> AutomationRemoteIdentifierCache::LookupGuid(int id, AutomationIdentifierType type)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& identifiers = m_identifiers[type];
+        const auto it = identifiers.guids.find(id);
+        if (it == identifiers.guids.end())
+        {
+            ++m_missCount;
+            identifiers.pendingIds.insert(id);
+            return std::nullopt;
+        }
+
+        ++m_hitCount;
+        return it->second;
+    }
+
+    void AutomationRemoteIdentifierCache::Add(const GUID& guid, int id, AutomationIdentifierType type)
+    {
+        if (id == 0 || guid == GUID{})
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& identifiers = m_identifiers[type];
+        identifiers.ids[guid] = id;
+        identifiers.guids[id] = guid;
+        identifiers.pendingGuids.erase(guid);
+        identifiers.pendingIds.erase(id);
+    }
+
+    uint32_t AutomationRemoteIdentifierCache::Count()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        size_t count = 0;
+        for (const auto& [type, identifiers] : m_identifiers)
+        {
+            count += identifiers.ids.size();
+        }
+        return static_cast<uint32_t>(count);
+    }
+
+    uint32_t AutomationRemoteIdentifierCache::PendingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        size_t count = 0;
+        for (const auto& [type, identifiers] : m_identifiers)
+        {
+            count += identifiers.pendingGuids.size() + identifiers.pendingIds.size();
+        }
+        return static_cast<uint32_t>(count);
+    }
+
+    uint64_t AutomationRemoteIdentifierCache::HitCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_hitCount;
+    }
+
+    uint64_t AutomationRemoteIdentifierCache::MissCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_missCount;
+    }
+
+    void AutomationRemoteIdentifierCache::RequestPropertyId(const winrt::guid& propertyGuid)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& identifiers = m_identifiers[AutomationIdentifierType_Property];
+        if (identifiers.ids.find(propertyGuid) == identifiers.ids.end())
+        {
+            identifiers.pendingGuids.insert(propertyGuid);
+        }
+    }
+
+    void AutomationRemoteIdentifierCache::RequestAnnotationType(const winrt::guid& annotationTypeGuid)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& identifiers = m_identifiers[AutomationIdentifierType_Annotation];
+        if (identifiers.ids.find(annotationTypeGuid) == identifiers.ids.end())
+        {
+            identifiers.pendingGuids.insert(annotationTypeGuid);
+        }
+    }
+
+    void AutomationRemoteIdentifierCache::Prefetch(winrt::AutomationElement const& element)
+    {
+        std::vector<std::pair<AutomationIdentifierType, GUID>> pendingGuids;
+        std::vector<std::pair<AutomationIdentifierType, int>> pendingIds;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for (const auto& [type, identifiers] : m_identifiers)
+            {
+                for (const auto& guid : identifiers.pendingGuids)
+                {
+                    pendingGuids.emplace_back(type, guid);
+                }
+                for (const auto id : identifiers.pendingIds)
+                {
+                    pendingIds.emplace_back(type, id);
+                }
+            }
+        }
+
+        if (pendingGuids.empty() && pendingIds.empty())
+        {
+            return;
+        }
+
+        // The element only binds the operation to the connection whose identifiers we want.
+        const auto operation = make_self<AutomationRemoteOperation>();
+        operation->ImportElement(element);
+
+        std::vector<bytecode::OperandId> guidResults;
+        for (const auto& [type, guid] : pendingGuids)
+        {
+            const auto guidId = operation->GetNextId();
+            operation->InsertInstruction(bytecode::NewGuid{ guidId, guid });
+            const auto resultId = operation->GetNextId();
+            operation->InsertInstruction(bytecode::LookupId{ resultId, guidId, type });
+            operation->RequestResponse(resultId);
+            guidResults.emplace_back(resultId);
+        }
+
+        std::vector<bytecode::OperandId> idResults;
+        for (const auto& [type, id] : pendingIds)
+        {
+            const auto intId = operation->GetNextId();
+            operation->InsertInstruction(bytecode::NewInt{ intId, id });
+            const auto resultId = operation->GetNextId();
+            operation->InsertInstruction(bytecode::LookupGuid{ resultId, intId, type });
+            operation->RequestResponse(resultId);
+            idResults.emplace_back(resultId);
+        }
+
+        const auto results = operation->Execute();
+
+        // Identifiers that couldn't be resolved stay pending.
+        for (size_t i = 0; i < pendingGuids.size(); ++i)
+        {
+            const winrt::AutomationRemoteOperationResponseToken token{ guidResults[i].Value };
+            if (results.HasResult(token))
+            {
+                const auto& [type, guid] = pendingGuids[i];
+                Add(guid, winrt::unbox_value_or<int32_t>(results.GetResult(token), 0), type);
+            }
+        }
+
+        for (size_t i = 0; i < pendingIds.size(); ++i)
+        {
+            const winrt::AutomationRemoteOperationResponseToken token{ idResults[i].Value };
+            if (results.HasResult(token))
+            {
+                const auto& [type, id] = pendingIds[i];
+                Add(winrt::unbox_value_or<winrt::guid>(results.GetResult(token), winrt::guid{}), id, type);
+            }
+        }
+    }
+
+    void AutomationRemoteIdentifierCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_identifiers.clear();
+        m_hitCount = 0;
+        m_missCount = 0;
+    }
+}
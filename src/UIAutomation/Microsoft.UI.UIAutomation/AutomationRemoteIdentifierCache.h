@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include "Microsoft.UI.UIAutomation.AutomationRemoteIdentifierCache.g.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+
+#include <UIAutomation.h>
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    // This class caches the mapping between identifier GUIDs and their integer IDs, per identifier type, for a
+    // single provider connection. The mapping never changes for the lifetime of a connection, so once a lookup has
+    // been resolved, later operations can use the ID as a constant.
+    //
+    // Lookups that miss are remembered as pending until an operation resolves them, or until Prefetch resolves all
+    // of them at once.
+    struct AutomationRemoteIdentifierCache : AutomationRemoteIdentifierCacheT<AutomationRemoteIdentifierCache>
+    {
+        AutomationRemoteIdentifierCache() = default;
+
+        // Internal
+
+        // Returns the ID of the given GUID if it's known. Otherwise, marks the GUID as pending.
+        std::optional<int> LookupId(const GUID& guid, AutomationIdentifierType type);
+        // Returns the GUID of the given ID if it's known. Otherwise, marks the ID as pending.
+        std::optional<GUID> LookupGuid(int id, AutomationIdentifierType type);
+
+        // Records a resolved mapping. IDs of 0 and null GUIDs are the platform's way of saying that the identifier
+        // isn't registered, so they are ignored.
+        void Add(const GUID& guid, int id, AutomationIdentifierType type);
+
+        // API
+        uint32_t Count();
+        uint32_t PendingCount();
+        uint64_t HitCount();
+        uint64_t MissCount();
+
+        void RequestPropertyId(const winrt::guid& propertyGuid);
+        void RequestAnnotationType(const winrt::guid& annotationTypeGuid);
+
+        void Prefetch(winrt::Windows::UI::UIAutomation::AutomationElement const& element);
+
+        void Clear();
+
+    private:
+        struct GuidLess
+        {
+            bool operator()(const GUID& lhs, const GUID& rhs) const
+            {
+                return std::memcmp(&lhs, &rhs, sizeof(GUID)) < 0;
+            }
+        };
+
+        struct Identifiers
+        {
+            std::map<GUID, int, GuidLess> ids;
+            std::map<int, GUID> guids;
+            std::set<GUID, GuidLess> pendingGuids;
+            std::set<int> pendingIds;
+        };
+
+        std::mutex m_lock;
+        std::map<AutomationIdentifierType, Identifiers> m_identifiers;
+
+        uint64_t m_hitCount = 0;
+        uint64_t m_missCount = 0;
+    };
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::factory_implementation
+{
+    struct AutomationRemoteIdentifierCache : AutomationRemoteIdentifierCacheT<AutomationRemoteIdentifierCache, implementation::AutomationRemoteIdentifierCache>
+    {
+    };
+}
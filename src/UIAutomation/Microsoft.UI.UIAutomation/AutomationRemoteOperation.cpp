@@ -10,7 +10,11 @@
 
 #include "Standins.h"
 
+#include <type_traits>
+#include <unordered_map>
+
 #include <wil/resource.h>
+#include <wil/result.h>
 
 namespace winrt
 {
@@ -18,6 +22,25 @@ namespace winrt
     using namespace winrt::Windows::UI::UIAutomation;
 }
 
+namespace
+{
+    template <class InstructionT, class = void>
+    struct HasResultId : std::false_type {};
+
+    template <class InstructionT>
+    struct HasResultId<InstructionT, std::void_t<decltype(InstructionT::resultId)>> : std::true_type {};
+
+    template <class InstructionT, class = void>
+    struct HasTargetId : std::false_type {};
+
+    template <class InstructionT>
+    struct HasTargetId<InstructionT, std::void_t<decltype(InstructionT::targetId)>> : std::true_type {};
+
+    // Instructions that have a target but no result update their target in place (Set, Add, InPlaceBoolNot, etc.).
+    template <class InstructionT>
+    constexpr bool c_updatesTargetInPlace = HasTargetId<InstructionT>::value && !HasResultId<InstructionT>::value;
+}
+
 namespace winrt::Microsoft::UI::UIAutomation::implementation
 {
     AutomationRemoteOperation::AutomationRemoteOperation()
@@ -190,7 +213,12 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
     winrt::AutomationRemoteElement AutomationRemoteOperation::ImportElement(winrt::AutomationElement const& element)
     {
         const auto elementId = GetNextId();
-        m_remoteOperation.ImportElement({ elementId.Value }, element);
+        if (!m_replayer)
+        {
+            m_remoteOperation.ImportElement({ elementId.Value }, element);
+        }
+        m_importedObjects.emplace_back(elementId.Value, element);
+        m_importKinds.emplace_back(elementId.Value, recording::ImportKind::Element);
         const auto result = make<AutomationRemoteElement>(elementId, *this);
 
         return result;
@@ -199,7 +227,12 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
     winrt::AutomationRemoteTextRange AutomationRemoteOperation::ImportTextRange(winrt::AutomationTextRange const& textRange)
     {
         const auto textRangeId = GetNextId();
-        m_remoteOperation.ImportTextRange({ textRangeId.Value }, textRange);
+        if (!m_replayer)
+        {
+            m_remoteOperation.ImportTextRange({ textRangeId.Value }, textRange);
+        }
+        m_importedObjects.emplace_back(textRangeId.Value, textRange);
+        m_importKinds.emplace_back(textRangeId.Value, recording::ImportKind::TextRange);
 
         const auto result = make<AutomationRemoteTextRange>(textRangeId, *this);
         return result;
@@ -208,7 +241,12 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
     winrt::AutomationRemoteConnectionBoundObject AutomationRemoteOperation::ImportConnectionBoundObject(winrt::AutomationConnectionBoundObject const& connectionBoundObject)
     {
         const auto connectionBoundObjectId = GetNextId();
-        m_remoteOperation.ImportConnectionBoundObject({ connectionBoundObjectId.Value }, connectionBoundObject);
+        if (!m_replayer)
+        {
+            m_remoteOperation.ImportConnectionBoundObject({ connectionBoundObjectId.Value }, connectionBoundObject);
+        }
+        m_importedObjects.emplace_back(connectionBoundObjectId.Value, connectionBoundObject);
+        m_importKinds.emplace_back(connectionBoundObjectId.Value, recording::ImportKind::ConnectionBoundObject);
 
         const auto result = make<AutomationRemoteConnectionBoundObject>(connectionBoundObjectId, *this);
         return result;
@@ -217,6 +255,7 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
     void AutomationRemoteOperation::RequestResponse(bytecode::OperandId remoteOperationId)
     {
         m_remoteOperation.AddToResults({ remoteOperationId.Value });
+        m_requestedResults.emplace_back(remoteOperationId.Value);
     }
 
     AutomationRemoteOperationResponseToken AutomationRemoteOperation::RequestResponse(const winrt::AutomationRemoteObject& object)
@@ -342,12 +381,234 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
 
     winrt::AutomationRemoteOperationResultSet AutomationRemoteOperation::Execute()
     {
-        auto serializedBytecode = m_rootGraph->Serialize();
-        auto result = m_remoteOperation.Execute(serializedBytecode);
+        if (m_identifierCache && !m_replayer)
+        {
+            ApplyIdentifierCache();
+        }
+
+        // Fusing is deterministic, so replayed operations still produce the bytecode they were recorded with, as
+        // long as it is enabled for both.
+        if (m_isLoopFusionEnabled)
+        {
+            m_rootGraph->FuseLoops();
+        }
+
+        int instructionCount = 0;
+        auto serializedBytecode = m_rootGraph->Serialize(std::move(m_bytecodeBuffer), &instructionCount);
+        m_lastInstructionCount = static_cast<uint32_t>(instructionCount);
+
+        // Hand the buffer back for the next Execute however this one ends, including when it's replayed or throws.
+        auto restoreBuffer = wil::scope_exit([&]()
+        {
+            m_bytecodeBuffer = std::move(serializedBytecode);
+        });
+
+        if (m_replayer)
+        {
+            return make<AutomationRemoteOperationResultSet>(
+                get_self<AutomationRemoteOperationReplayer>(m_replayer)->Replay(serializedBytecode));
+        }
+
+        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult result{ nullptr };
+        if (m_resultCache)
+        {
+            result = get_self<AutomationRemoteOperationResultCache>(m_resultCache)->GetOrExecute(
+                serializedBytecode,
+                m_importedObjects,
+                m_requestedResults,
+                [&]()
+                {
+                    return m_remoteOperation.Execute(serializedBytecode);
+                });
+        }
+        else
+        {
+            result = m_remoteOperation.Execute(serializedBytecode);
+        }
+
+        if (m_identifierCache)
+        {
+            LearnIdentifiers(result);
+        }
+
+        // By now the operation has run, along with any side effects it has, so failing to record it mustn't fail
+        // the operation: the caller would see a failure, and retrying would repeat the side effects.
+        if (m_recorder)
+        {
+            try
+            {
+                get_self<AutomationRemoteOperationRecorder>(m_recorder)->Record(serializedBytecode, m_importKinds, m_requestedResults, result);
+            }
+            catch (...)
+            {
+                LOG_HR(to_hresult());
+            }
+        }
 
         // We wrap the platform result into the Result Set that the higher-level API operates on.
         auto resultSet = make<AutomationRemoteOperationResultSet>(std::move(result));
 
         return resultSet;
     }
+
+    void AutomationRemoteOperation::Reset()
+    {
+        // Resetting from within a block would leave the block's handler adding to a graph that no longer exists.
+        if (m_currentScope != m_rootGraph)
+        {
+            throw_hresult(E_ILLEGAL_METHOD_CALL);
+        }
+
+        m_nextId = 1;
+        m_rootGraph->Clear();
+        m_lastInstructionCount = 0;
+        m_isLoopFusionEnabled = true;
+
+        // The platform operation can't forget the objects imported into it or the results requested from it, so it
+        // is the one thing that has to be replaced.
+        m_remoteOperation = winrt::Windows::UI::UIAutomation::Core::CoreAutomationRemoteOperation{};
+
+        // Clearing keeps the capacity of the import and result tables.
+        m_importedObjects.clear();
+        m_requestedResults.clear();
+        m_importKinds.clear();
+        m_identifierLookups.clear();
+        m_identifierResults.clear();
+
+        m_resultCache = nullptr;
+        m_identifierCache = nullptr;
+        m_recorder = nullptr;
+        m_replayer = nullptr;
+    }
+
+    void AutomationRemoteOperation::UseResultCache(winrt::AutomationRemoteOperationResultCache const& cache)
+    {
+        m_resultCache = cache;
+    }
+
+    void AutomationRemoteOperation::UseIdentifierCache(winrt::AutomationRemoteIdentifierCache const& cache)
+    {
+        m_identifierCache = cache;
+    }
+
+    void AutomationRemoteOperation::ApplyIdentifierCache()
+    {
+        auto& cache = *get_self<AutomationRemoteIdentifierCache>(m_identifierCache);
+
+        // Only operands created by NewGuid or NewInt and never updated afterwards hold the same value wherever a
+        // lookup reads them, including in later iterations of a loop.
+        std::unordered_map<int, GUID> constantGuids;
+        std::unordered_map<int, int> constantInts;
+        std::unordered_set<int> updatedOperands;
+        m_rootGraph->VisitInstructions([&](bytecode::Instruction& instruction)
+        {
+            std::visit([&](const auto& typedInstruction)
+            {
+                using InstructionT = std::decay_t<decltype(typedInstruction)>;
+                if constexpr (std::is_same_v<InstructionT, bytecode::NewGuid>)
+                {
+                    constantGuids.emplace(typedInstruction.resultId.Value, typedInstruction.initialValue);
+                }
+                else if constexpr (std::is_same_v<InstructionT, bytecode::NewInt>)
+                {
+                    constantInts.emplace(typedInstruction.resultId.Value, typedInstruction.initialValue);
+                }
+                else if constexpr (c_updatesTargetInPlace<InstructionT>)
+                {
+                    updatedOperands.insert(typedInstruction.targetId.Value);
+                }
+            }, instruction);
+        });
+
+        for (const auto operandId : updatedOperands)
+        {
+            constantGuids.erase(operandId);
+            constantInts.erase(operandId);
+        }
+
+        m_identifierLookups.clear();
+        m_rootGraph->VisitInstructions([&](bytecode::Instruction& instruction)
+        {
+            if (const auto lookupId = std::get_if<bytecode::LookupId>(&instruction))
+            {
+                const auto guid = constantGuids.find(lookupId->guidId.Value);
+                if (guid != constantGuids.end())
+                {
+                    const auto resultId = lookupId->resultId;
+                    const auto type = lookupId->idType;
+                    if (const auto id = cache.LookupId(guid->second, type))
+                    {
+                        instruction = bytecode::NewInt{ resultId, *id };
+                    }
+                    else
+                    {
+                        m_identifierLookups.push_back({ resultId.Value, type, guid->second });
+                    }
+                }
+            }
+            else if (const auto lookupGuid = std::get_if<bytecode::LookupGuid>(&instruction))
+            {
+                const auto id = constantInts.find(lookupGuid->intIdId.Value);
+                if (id != constantInts.end())
+                {
+                    const auto resultId = lookupGuid->resultId;
+                    const auto type = lookupGuid->idType;
+                    if (const auto guid = cache.LookupGuid(id->second, type))
+                    {
+                        instruction = bytecode::NewGuid{ resultId, *guid };
+                    }
+                    else
+                    {
+                        m_identifierLookups.push_back({ resultId.Value, type, id->second });
+                    }
+                }
+            }
+        });
+
+        for (const auto& lookup : m_identifierLookups)
+        {
+            if (m_identifierResults.insert(lookup.resultId).second)
+            {
+                m_remoteOperation.AddToResults({ lookup.resultId });
+            }
+        }
+    }
+
+    void AutomationRemoteOperation::LearnIdentifiers(const winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult& result)
+    {
+        auto& cache = *get_self<AutomationRemoteIdentifierCache>(m_identifierCache);
+        for (const auto& lookup : m_identifierLookups)
+        {
+            if (!result.HasOperand({ lookup.resultId }))
+            {
+                continue;
+            }
+
+            const auto value = result.GetOperand({ lookup.resultId });
+            if (const auto guid = std::get_if<GUID>(&lookup.key))
+            {
+                cache.Add(*guid, winrt::unbox_value_or<int32_t>(value, 0), lookup.type);
+            }
+            else
+            {
+                cache.Add(winrt::unbox_value_or<winrt::guid>(value, winrt::guid{}), std::get<int>(lookup.key), lookup.type);
+            }
+        }
+    }
+
+    void AutomationRemoteOperation::UseRecorder(winrt::AutomationRemoteOperationRecorder const& recorder)
+    {
+        m_recorder = recorder;
+    }
+
+    void AutomationRemoteOperation::UseReplayer(winrt::AutomationRemoteOperationReplayer const& replayer)
+    {
+        // Objects imported so far have already been handed to the platform operation, so this one can no longer
+        // be replayed consistently.
+        if (!m_importedObjects.empty())
+        {
+            throw_hresult(E_ILLEGAL_METHOD_CALL);
+        }
+        m_replayer = replayer;
+    }
 }
@@ -4,6 +4,10 @@
 #pragma once
 #include "Microsoft.UI.UIAutomation.AutomationRemoteOperation.g.h"
 #include "AutomationRemoteOperationResultSet.h"
+#include "AutomationRemoteIdentifierCache.h"
+#include "AutomationRemoteOperationResultCache.h"
+#include "AutomationRemoteOperationRecorder.h"
+#include "AutomationRemoteOperationReplayer.h"
 
 #include <winrt/Windows.UI.UIAutomation.h>
 #include <winrt/Windows.UI.UIAutomation.Core.h>
@@ -12,7 +16,9 @@
 #include "RemoteOperationGraph.h"
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
+#include <variant>
 
 
 namespace winrt::Microsoft::UI::UIAutomation::implementation
@@ -108,10 +114,48 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
 
         winrt::AutomationRemoteOperationResultSet Execute();
 
+        uint32_t LastInstructionCount() const { return m_lastInstructionCount; }
+
+        bool IsLoopFusionEnabled() const { return m_isLoopFusionEnabled; }
+        void IsLoopFusionEnabled(bool value) { m_isLoopFusionEnabled = value; }
+
+        void Reset();
+
+        // Opts this operation in to sharing results with byte-identical operations through the given cache.
+        // Pass nullptr to opt back out.
+        void UseResultCache(winrt::AutomationRemoteOperationResultCache const& cache);
+
+        // Emits the lookups of constant identifiers that the given cache already knows as constants, and teaches the
+        // cache the ones this operation looks up. Pass nullptr to opt back out. Has no effect on replayed operations.
+        void UseIdentifierCache(winrt::AutomationRemoteIdentifierCache const& cache);
+
+        // Records this operation when it executes. Pass nullptr to stop recording.
+        void UseRecorder(winrt::AutomationRemoteOperationRecorder const& recorder);
+
+        // Serves this operation's results from the next record of the given replayer instead of executing it.
+        // Must be called before anything is imported into the operation: in replay mode, imported objects are
+        // never handed to the platform, so they may be null or belong to a provider that no longer exists.
+        void UseReplayer(winrt::AutomationRemoteOperationReplayer const& replayer);
+
 #include "AutomationRemoteOperationMethods.g.h"
 
     private:
 
+        // A LookupId or LookupGuid instruction whose result the identifier cache should learn.
+        struct IdentifierLookup
+        {
+            int resultId;
+            AutomationIdentifierType type;
+            // The GUID being looked up for LookupId, or the ID for LookupGuid.
+            std::variant<GUID, int> key;
+        };
+
+        // Replaces the lookups of constant identifiers that the identifier cache knows with constants, and requests
+        // the results of the remaining ones.
+        void ApplyIdentifierCache();
+        // Adds the results of the remaining lookups to the identifier cache.
+        void LearnIdentifiers(const winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult& result);
+
         // Members
 
         // The ID is incremented every time a new remote OperandId is requested. The remote operation
@@ -128,8 +172,28 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
         // scope is considered "current".
         std::shared_ptr<RemoteOperationGraph> m_currentScope;
 
+        // The buffer that the bytecode was last serialized into, kept so that the next serialization can reuse it.
+        std::vector<uint8_t> m_bytecodeBuffer;
+        uint32_t m_lastInstructionCount = 0;
+        bool m_isLoopFusionEnabled = true;
+
         // The underlying platform Remote Operation that we're preparing for execution.
         winrt::Windows::UI::UIAutomation::Core::CoreAutomationRemoteOperation m_remoteOperation;
+
+        // Everything besides the bytecode that determines the outcome of the operation: the objects imported
+        // into it, by operand ID, and the operands requested as results.
+        AutomationRemoteOperationResultCache::ImportedObjects m_importedObjects;
+        std::vector<int> m_requestedResults;
+
+        recording::Imports m_importKinds;
+
+        winrt::AutomationRemoteOperationResultCache m_resultCache{ nullptr };
+        winrt::AutomationRemoteIdentifierCache m_identifierCache{ nullptr };
+        std::vector<IdentifierLookup> m_identifierLookups;
+        // The lookup results that have already been added to the platform operation's results.
+        std::unordered_set<int> m_identifierResults;
+        winrt::AutomationRemoteOperationRecorder m_recorder{ nullptr };
+        winrt::AutomationRemoteOperationReplayer m_replayer{ nullptr };
     };
 }
 namespace winrt::Microsoft::UI::UIAutomation::factory_implementation
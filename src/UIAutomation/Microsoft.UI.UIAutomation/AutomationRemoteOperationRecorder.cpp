@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "AutomationRemoteOperationRecorder.h"
+
+#include <wil/result.h>
+
+#if __has_include("Microsoft.UI.UIAutomation.AutomationRemoteOperationRecorder.g.cpp")
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationRecorder.g.cpp"
+#endif
+
+namespace winrt
+{
+    using namespace winrt::Windows::UI::UIAutomation::Core;
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    AutomationRemoteOperationRecorder::AutomationRemoteOperationRecorder(hstring const& path) :
+        m_file(std::wstring{ path }, std::ios::binary | std::ios::trunc)
+    {
+        if (!m_file)
+        {
+            throw_hresult(E_ACCESSDENIED);
+        }
+
+        MessageBuilder header;
+        header.WriteInt(recording::c_magic);
+        header.WriteInt(recording::c_version);
+        const auto bytes = header.DetachBuffer();
+        m_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    void AutomationRemoteOperationRecorder::Record(
+        const std::vector<uint8_t>& bytecode,
+        const recording::Imports& imports,
+        const std::vector<int>& requestedResults,
+        const winrt::AutomationRemoteOperationResult& result)
+    {
+        // Build the record outside of the lock; only the write to the file needs to be serialized.
+        MessageBuilder record;
+        record.WriteByteArray(bytecode);
+
+        record.WriteInt(static_cast<int>(imports.size()));
+        for (const auto& [operandId, kind] : imports)
+        {
+            record.WriteInt(operandId);
+            record.WriteByte(static_cast<uint8_t>(kind));
+        }
+
+        record.WriteInt(static_cast<int>(requestedResults.size()));
+        for (const auto operandId : requestedResults)
+        {
+            record.WriteInt(operandId);
+        }
+
+        record.WriteInt(static_cast<int>(result.Status()));
+        record.WriteInt(result.ExtendedError());
+
+        std::vector<int> returnedResults;
+        for (const auto operandId : requestedResults)
+        {
+            if (result.HasOperand({ operandId }))
+            {
+                returnedResults.emplace_back(operandId);
+            }
+        }
+
+        MessageBuilder results;
+        results.WriteInt(static_cast<int>(returnedResults.size()));
+        bool replayable = true;
+        for (const auto operandId : returnedResults)
+        {
+            results.WriteInt(operandId);
+            replayable = recording::WriteValue(results, result.GetOperand({ operandId })) && replayable;
+        }
+
+        // The operation has already run, so the record is kept, in order, and only fails if it's replayed.
+        if (!replayable)
+        {
+            LOG_HR_MSG(E_NOTIMPL, "Recorded results that can't be replayed, such as elements");
+        }
+        record.WriteByteArray(results.DetachBuffer());
+
+        MessageBuilder framed;
+        framed.WriteByteArray(record.DetachBuffer());
+        const auto bytes = framed.DetachBuffer();
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_file.is_open())
+        {
+            throw_hresult(RO_E_CLOSED);
+        }
+
+        m_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        if (!m_file)
+        {
+            throw_hresult(E_FAIL);
+        }
+        ++m_recordedCount;
+    }
+
+    uint32_t AutomationRemoteOperationRecorder::RecordedCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_recordedCount;
+    }
+
+    void AutomationRemoteOperationRecorder::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_file.close();
+    }
+}
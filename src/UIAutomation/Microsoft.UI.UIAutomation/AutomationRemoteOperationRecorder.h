@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationRecorder.g.h"
+#include "RemoteOperationRecordingFormat.h"
+
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.UI.UIAutomation.Core.h>
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    // This class appends every remote operation executed with it to a recording file (see
+    // RemoteOperationRecordingFormat.h), so that the same operations can later be replayed without a provider.
+    //
+    // A single recorder can be shared by operations running on different threads.
+    struct AutomationRemoteOperationRecorder : AutomationRemoteOperationRecorderT<AutomationRemoteOperationRecorder>
+    {
+        explicit AutomationRemoteOperationRecorder(hstring const& path);
+
+        // Internal
+        void Record(
+            const std::vector<uint8_t>& bytecode,
+            const recording::Imports& imports,
+            const std::vector<int>& requestedResults,
+            const winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult& result);
+
+        // API
+        uint32_t RecordedCount();
+        void Close();
+
+    private:
+        std::mutex m_lock;
+        std::ofstream m_file;
+        uint32_t m_recordedCount = 0;
+    };
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::factory_implementation
+{
+    struct AutomationRemoteOperationRecorder : AutomationRemoteOperationRecorderT<AutomationRemoteOperationRecorder, implementation::AutomationRemoteOperationRecorder>
+    {
+    };
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "AutomationRemoteOperationReplayer.h"
+
+#if __has_include("Microsoft.UI.UIAutomation.AutomationRemoteOperationReplayer.g.cpp")
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationReplayer.g.cpp"
+#endif
+
+#include <fstream>
+#include <iterator>
+
+namespace winrt
+{
+    using namespace winrt::Windows::UI::UIAutomation::Core;
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    AutomationRemoteOperationReplayer::AutomationRemoteOperationReplayer(hstring const& path)
+    {
+        std::ifstream file(std::wstring{ path }, std::ios::binary);
+        if (!file)
+        {
+            throw_hresult(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+        }
+        const std::vector<uint8_t> contents{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        MessageReader reader(contents);
+        if (reader.ReadInt() != recording::c_magic || reader.ReadInt() != recording::c_version)
+        {
+            throw_hresult(E_INVALIDARG);
+        }
+
+        while (!reader.IsAtEnd())
+        {
+            const auto recordBytes = reader.ReadByteArray();
+            MessageReader recordReader(recordBytes);
+
+            Record record;
+            record.bytecode = recordReader.ReadByteArray();
+
+            const auto importCount = recordReader.ReadInt();
+            for (int i = 0; i < importCount; ++i)
+            {
+                const auto operandId = recordReader.ReadInt();
+                const auto kind = static_cast<recording::ImportKind>(recordReader.ReadByte());
+                record.imports.emplace_back(operandId, kind);
+            }
+
+            const auto requestedCount = recordReader.ReadInt();
+            for (int i = 0; i < requestedCount; ++i)
+            {
+                record.requestedResults.emplace_back(recordReader.ReadInt());
+            }
+
+            record.status = static_cast<winrt::AutomationRemoteOperationStatus>(recordReader.ReadInt());
+            record.extendedError = recordReader.ReadInt();
+            record.encodedResults = recordReader.ReadByteArray();
+
+            m_records.emplace_back(std::move(record));
+        }
+    }
+
+    AutomationRemoteOperationResultSet::ReplayedResult AutomationRemoteOperationReplayer::Replay(const std::vector<uint8_t>& bytecode)
+    {
+        const Record* record = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_nextRecord == m_records.size())
+            {
+                throw_hresult(E_BOUNDS);
+            }
+
+            record = &m_records[m_nextRecord++];
+            if (record->bytecode != bytecode)
+            {
+                ++m_bytecodeMismatchCount;
+            }
+        }
+
+        // Records are never modified after loading, so decoding can happen outside of the lock.
+        AutomationRemoteOperationResultSet::ReplayedResult replayed;
+        replayed.status = record->status;
+        replayed.extendedError = record->extendedError;
+
+        MessageReader reader(record->encodedResults);
+        const auto resultCount = reader.ReadInt();
+        for (int i = 0; i < resultCount; ++i)
+        {
+            const auto operandId = reader.ReadInt();
+            replayed.operands.insert_or_assign(operandId, recording::ReadValue(reader));
+        }
+
+        return replayed;
+    }
+
+    uint32_t AutomationRemoteOperationReplayer::RecordCount()
+    {
+        return static_cast<uint32_t>(m_records.size());
+    }
+
+    uint32_t AutomationRemoteOperationReplayer::RemainingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return static_cast<uint32_t>(m_records.size() - m_nextRecord);
+    }
+
+    uint32_t AutomationRemoteOperationReplayer::BytecodeMismatchCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_bytecodeMismatchCount;
+    }
+
+    void AutomationRemoteOperationReplayer::Rewind()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_nextRecord = 0;
+        m_bytecodeMismatchCount = 0;
+    }
+}
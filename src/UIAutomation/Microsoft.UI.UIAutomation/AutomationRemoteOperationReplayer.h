@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationReplayer.g.h"
+#include "AutomationRemoteOperationResultSet.h"
+#include "RemoteOperationRecordingFormat.h"
+
+#include <mutex>
+#include <vector>
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.UI.UIAutomation.Core.h>
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    // This class serves the records of a recording made by AutomationRemoteOperationRecorder, in order, in place of
+    // executing operations against a provider.
+    //
+    // Records are matched to operations by position only. An operation whose bytecode differs from its record (for
+    // example because the builder or optimizer changed since the recording was made) is still served that record's
+    // results, and is counted in BytecodeMismatchCount.
+    struct AutomationRemoteOperationReplayer : AutomationRemoteOperationReplayerT<AutomationRemoteOperationReplayer>
+    {
+        explicit AutomationRemoteOperationReplayer(hstring const& path);
+
+        // Internal
+
+        // Returns the results of the next record. Throws E_BOUNDS once every record has been replayed.
+        AutomationRemoteOperationResultSet::ReplayedResult Replay(const std::vector<uint8_t>& bytecode);
+
+        // API
+        uint32_t RecordCount();
+        uint32_t RemainingCount();
+        uint32_t BytecodeMismatchCount();
+        void Rewind();
+
+    private:
+        struct Record
+        {
+            std::vector<uint8_t> bytecode;
+            recording::Imports imports;
+            std::vector<int> requestedResults;
+            winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus status;
+            winrt::hresult extendedError;
+
+            // Results are kept encoded and decoded on every replay, so that each replayed operation gets its own
+            // objects and replays include the cost of materializing them.
+            std::vector<uint8_t> encodedResults;
+        };
+
+        std::mutex m_lock;
+        std::vector<Record> m_records;
+        size_t m_nextRecord = 0;
+        uint32_t m_bytecodeMismatchCount = 0;
+    };
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::factory_implementation
+{
+    struct AutomationRemoteOperationReplayer : AutomationRemoteOperationReplayerT<AutomationRemoteOperationReplayer, implementation::AutomationRemoteOperationReplayer>
+    {
+    };
+}
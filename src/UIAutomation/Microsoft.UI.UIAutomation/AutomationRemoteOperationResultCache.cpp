@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "AutomationRemoteOperationResultCache.h"
+
+#if __has_include("Microsoft.UI.UIAutomation.AutomationRemoteOperationResultCache.g.cpp")
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationResultCache.g.cpp"
+#endif
+
+namespace winrt
+{
+    using namespace winrt::Windows::UI::UIAutomation::Core;
+}
+
+namespace
+{
+    // Result payloads are opaque platform objects, so their size can't be measured. Each entry is charged its
+    // key size plus this fixed amount to account for the result and the cache's own bookkeeping.
+    constexpr uint64_t c_entryOverheadBytes = 256;
+
+    // 64-bit FNV-1a.
+    constexpr uint64_t c_fnvOffsetBasis = 14695981039346656037ull;
+    constexpr uint64_t c_fnvPrime = 1099511628211ull;
+
+    uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= c_fnvPrime;
+        }
+        return hash;
+    }
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    AutomationRemoteOperationResultCache::AutomationRemoteOperationResultCache(winrt::Windows::Foundation::TimeSpan const& timeToLive, uint64_t maxBytes) :
+        m_timeToLive(timeToLive),
+        m_maxBytes(maxBytes)
+    {
+        if (timeToLive.count() < 0)
+        {
+            throw_hresult(E_INVALIDARG);
+        }
+    }
+
+    winrt::AutomationRemoteOperationResult AutomationRemoteOperationResultCache::GetOrExecute(
+        const std::vector<uint8_t>& bytecode,
+        const ImportedObjects& importedObjects,
+        const std::vector<int>& requestedResults,
+        const Executor& execute)
+    {
+        std::promise<winrt::AutomationRemoteOperationResult> promise;
+        std::shared_ptr<Entry> entry;
+        const Key* key = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            auto newKey = MakeKey(bytecode, importedObjects, requestedResults);
+            auto it = m_entries.find(newKey);
+            if (it != m_entries.end())
+            {
+                const auto existing = it->second;
+                if (!existing->completed)
+                {
+                    ++m_sharedCount;
+                    lock.unlock();
+                    return existing->result.get();
+                }
+
+                if (std::chrono::steady_clock::now() - existing->completionTime < m_timeToLive)
+                {
+                    ++m_hitCount;
+                    m_lru.splice(m_lru.end(), m_lru, existing->lruPosition);
+                    return existing->result.get();
+                }
+
+                RemoveCompletedLocked(it);
+            }
+
+            ++m_missCount;
+            entry = std::make_shared<Entry>();
+            entry->result = promise.get_future().share();
+            entry->importedObjects = importedObjects;
+            entry->byteSize = newKey.bytecode.size()
+                + newKey.importIdentities.size() * (sizeof(int) + sizeof(void*))
+                + newKey.requestedResults.size() * sizeof(int)
+                + c_entryOverheadBytes;
+
+            key = &m_entries.emplace(std::move(newKey), entry).first->first;
+        }
+
+        winrt::AutomationRemoteOperationResult result{ nullptr };
+        try
+        {
+            result = execute();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_entries.erase(m_entries.find(*key));
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        // Publish to anyone sharing this execution before marking the entry completed, so that a later hit never
+        // has to wait.
+        promise.set_value(result);
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (result.Status() == winrt::AutomationRemoteOperationStatus::Success)
+        {
+            entry->completed = true;
+            entry->completionTime = std::chrono::steady_clock::now();
+            entry->lruPosition = m_lru.insert(m_lru.end(), key);
+            m_cachedBytes += entry->byteSize;
+            EvictLocked();
+        }
+        else
+        {
+            m_entries.erase(m_entries.find(*key));
+        }
+
+        return result;
+    }
+
+    /* static */ AutomationRemoteOperationResultCache::Key AutomationRemoteOperationResultCache::MakeKey(
+        const std::vector<uint8_t>& bytecode,
+        const ImportedObjects& importedObjects,
+        const std::vector<int>& requestedResults)
+    {
+        Key key;
+        key.bytecode = bytecode;
+        key.requestedResults = requestedResults;
+        key.importIdentities.reserve(importedObjects.size());
+        for (const auto& [operandId, object] : importedObjects)
+        {
+            // The IUnknown pointer is the COM identity of the object, regardless of which interface we hold.
+            key.importIdentities.emplace_back(operandId, winrt::get_abi(object.as<winrt::Windows::Foundation::IUnknown>()));
+        }
+
+        auto hash = HashBytes(c_fnvOffsetBasis, key.bytecode.data(), key.bytecode.size());
+        // Hash the members of each pair rather than the pairs themselves, whose padding is uninitialized.
+        for (const auto& [operandId, identity] : key.importIdentities)
+        {
+            hash = HashBytes(hash, &operandId, sizeof(operandId));
+            hash = HashBytes(hash, &identity, sizeof(identity));
+        }
+        hash = HashBytes(hash, key.requestedResults.data(), key.requestedResults.size() * sizeof(int));
+        key.hash = static_cast<size_t>(hash);
+
+        return key;
+    }
+
+    void AutomationRemoteOperationResultCache::RemoveCompletedLocked(EntryMap::iterator it)
+    {
+        m_cachedBytes -= it->second->byteSize;
+        m_lru.erase(it->second->lruPosition);
+        m_entries.erase(it);
+    }
+
+    void AutomationRemoteOperationResultCache::EvictLocked()
+    {
+        while (m_cachedBytes > m_maxBytes && !m_lru.empty())
+        {
+            RemoveCompletedLocked(m_entries.find(*m_lru.front()));
+        }
+    }
+
+    winrt::Windows::Foundation::TimeSpan AutomationRemoteOperationResultCache::TimeToLive()
+    {
+        return m_timeToLive;
+    }
+
+    uint64_t AutomationRemoteOperationResultCache::MaxBytes()
+    {
+        return m_maxBytes;
+    }
+
+    uint64_t AutomationRemoteOperationResultCache::HitCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_hitCount;
+    }
+
+    uint64_t AutomationRemoteOperationResultCache::SharedCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_sharedCount;
+    }
+
+    uint64_t AutomationRemoteOperationResultCache::MissCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_missCount;
+    }
+
+    uint64_t AutomationRemoteOperationResultCache::CachedBytes()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_cachedBytes;
+    }
+
+    void AutomationRemoteOperationResultCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        while (!m_lru.empty())
+        {
+            RemoveCompletedLocked(m_entries.find(*m_lru.front()));
+        }
+    }
+}
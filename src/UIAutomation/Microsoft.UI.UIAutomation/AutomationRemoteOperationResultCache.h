@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+#include "Microsoft.UI.UIAutomation.AutomationRemoteOperationResultCache.g.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.UI.UIAutomation.Core.h>
+
+namespace winrt::Microsoft::UI::UIAutomation::implementation
+{
+    // This class caches the platform results of remote operations that are byte-for-byte identical: the same
+    // serialized bytecode, the same imported objects (by COM identity) under the same operand IDs, and the same
+    // requested results.
+    //
+    // Identical operations that overlap in time share a single execution ("singleflight"), and successful
+    // results are reused until they are older than the configured time to live. Failed executions are never
+    // cached. Completed entries are evicted least recently used first once the estimated size of the cache
+    // exceeds the configured bound.
+    struct AutomationRemoteOperationResultCache : AutomationRemoteOperationResultCacheT<AutomationRemoteOperationResultCache>
+    {
+        AutomationRemoteOperationResultCache(winrt::Windows::Foundation::TimeSpan const& timeToLive, uint64_t maxBytes);
+
+        // Internal
+
+        using ImportedObjects = std::vector<std::pair<int, winrt::Windows::Foundation::IInspectable>>;
+        using Executor = std::function<winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult()>;
+
+        // Returns the cached result for the given operation if there is a live one, waits for an identical
+        // in-flight execution if there is one, and otherwise calls `execute` and caches its result.
+        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult GetOrExecute(
+            const std::vector<uint8_t>& bytecode,
+            const ImportedObjects& importedObjects,
+            const std::vector<int>& requestedResults,
+            const Executor& execute);
+
+        // API
+        winrt::Windows::Foundation::TimeSpan TimeToLive();
+        uint64_t MaxBytes();
+        uint64_t HitCount();
+        uint64_t SharedCount();
+        uint64_t MissCount();
+        uint64_t CachedBytes();
+
+        void Clear();
+
+    private:
+        struct Key
+        {
+            std::vector<uint8_t> bytecode;
+            std::vector<std::pair<int, void*>> importIdentities;
+            std::vector<int> requestedResults;
+            size_t hash = 0;
+
+            bool operator==(const Key& other) const
+            {
+                return hash == other.hash
+                    && bytecode == other.bytecode
+                    && importIdentities == other.importIdentities
+                    && requestedResults == other.requestedResults;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                return key.hash;
+            }
+        };
+
+        struct Entry
+        {
+            std::shared_future<winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult> result;
+
+            // Holding the imported objects keeps their COM identities from being reused while the key refers
+            // to them.
+            ImportedObjects importedObjects;
+
+            bool completed = false;
+            std::chrono::steady_clock::time_point completionTime;
+            uint64_t byteSize = 0;
+            std::list<const Key*>::iterator lruPosition;
+        };
+
+        using EntryMap = std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash>;
+
+        static Key MakeKey(const std::vector<uint8_t>& bytecode, const ImportedObjects& importedObjects, const std::vector<int>& requestedResults);
+
+        // The following methods must be called with m_lock held, and only on completed entries. In-flight entries
+        // are owned by the thread executing them until they complete.
+        void RemoveCompletedLocked(EntryMap::iterator it);
+        void EvictLocked();
+
+        const winrt::Windows::Foundation::TimeSpan m_timeToLive;
+        const uint64_t m_maxBytes;
+
+        std::mutex m_lock;
+        EntryMap m_entries;
+
+        // Completed entries, least recently used first.
+        std::list<const Key*> m_lru;
+
+        uint64_t m_cachedBytes = 0;
+        uint64_t m_hitCount = 0;
+        uint64_t m_sharedCount = 0;
+        uint64_t m_missCount = 0;
+    };
+}
+
+namespace winrt::Microsoft::UI::UIAutomation::factory_implementation
+{
+    struct AutomationRemoteOperationResultCache : AutomationRemoteOperationResultCacheT<AutomationRemoteOperationResultCache, implementation::AutomationRemoteOperationResultCache>
+    {
+    };
+}
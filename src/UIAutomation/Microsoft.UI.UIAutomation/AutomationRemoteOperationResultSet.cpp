@@ -15,34 +15,51 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
 {
     winrt::hresult AutomationRemoteOperationResultSet::OperationStatus()
     {
-        const auto status = m_result.Status();
+        const auto status = Status();
         if (status == winrt::AutomationRemoteOperationStatus::InstructionLimitExceeded)
         {
             return E_FAIL;
         }
         else
         {
-            return m_result.ExtendedError();
+            return ExtendedError();
         }
     }
 
     winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus AutomationRemoteOperationResultSet::Status()
     {
+        if (m_replayed)
+        {
+            return m_replayed->status;
+        }
         return m_result.Status();
     }
 
     winrt::hresult AutomationRemoteOperationResultSet::ExtendedError()
     {
+        if (m_replayed)
+        {
+            return m_replayed->extendedError;
+        }
         return m_result.ExtendedError();
     }
 
     bool AutomationRemoteOperationResultSet::HasResult(Microsoft::UI::UIAutomation::AutomationRemoteOperationResponseToken const& token)
     {
+        if (m_replayed)
+        {
+            return m_replayed->operands.find(token.Value) != m_replayed->operands.end();
+        }
         return m_result.HasOperand({ token.Value });
     }
 
     winrt::IInspectable AutomationRemoteOperationResultSet::GetResult(winrt::AutomationRemoteOperationResponseToken const& token)
     {
+        if (m_replayed)
+        {
+            const auto it = m_replayed->operands.find(token.Value);
+            return (it != m_replayed->operands.end()) ? it->second : nullptr;
+        }
         return m_result.GetOperand({ token.Value });
     }
 }
@@ -9,6 +9,9 @@
 #include <winrt/Windows.UI.UIAutomation.h>
 #include <winrt/Windows.UI.UIAutomation.Core.h>
 
+#include <map>
+#include <optional>
+
 namespace winrt
 {
     using namespace winrt::Microsoft::UI::UIAutomation;
@@ -30,6 +33,9 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
     //
     // Scalar values (such as ints, doubles, Rects, Points, etc.) will be represented by a boxed IInspectable; the
     // client should simply unbox it.
+    //
+    // A result set either wraps a platform result or, when replaying a recorded operation, holds the recorded
+    // status and operands directly.
     struct AutomationRemoteOperationResultSet : AutomationRemoteOperationResultSetT<AutomationRemoteOperationResultSet>
     {
         explicit AutomationRemoteOperationResultSet(winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult result) :
@@ -37,6 +43,18 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
         {
         }
 
+        struct ReplayedResult
+        {
+            winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus status;
+            winrt::hresult extendedError;
+            std::map<int, winrt::IInspectable> operands;
+        };
+
+        explicit AutomationRemoteOperationResultSet(ReplayedResult replayed) :
+            m_replayed(std::move(replayed))
+        {
+        }
+
         winrt::hresult OperationStatus();
 
         winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus Status();
@@ -47,6 +65,7 @@ namespace winrt::Microsoft::UI::UIAutomation::implementation
         winrt::IInspectable GetResult(winrt::AutomationRemoteOperationResponseToken const& token);
 
     private:
-        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult m_result;
+        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationResult m_result{ nullptr };
+        std::optional<ReplayedResult> m_replayed;
     };
 }
@@ -4,6 +4,12 @@
 #include "pch.h"
 #include "MessageBuilder.h"
 
+MessageBuilder::MessageBuilder(std::vector<uint8_t>&& buffer) :
+    m_buffer(std::move(buffer))
+{
+    m_buffer.clear();
+}
+
 void MessageBuilder::WriteBool(bool val)
 {
     WriteByte(val ? 1 : 0);
@@ -52,6 +58,12 @@ void MessageBuilder::WriteGuid(const GUID& val)
     WriteBytes(reinterpret_cast<const uint8_t*>(&val), sizeof(val));
 }
 
+void MessageBuilder::WriteByteArray(const std::vector<uint8_t>& val)
+{
+    WriteInt(static_cast<int>(val.size()));
+    WriteBytes(val.data(), val.size());
+}
+
 std::vector<uint8_t> MessageBuilder::DetachBuffer()
 {
     return std::move(m_buffer);
@@ -61,3 +73,112 @@ void MessageBuilder::WriteBytes(_In_reads_(count) const uint8_t* bytes, size_t c
 {
     std::copy(bytes, bytes + count, std::back_inserter(m_buffer));
 }
+
+MessageReader::MessageReader(const std::vector<uint8_t>& buffer) :
+    m_buffer(buffer)
+{
+}
+
+bool MessageReader::ReadBool()
+{
+    return ReadByte() != 0;
+}
+
+uint8_t MessageReader::ReadByte()
+{
+    uint8_t val;
+    ReadBytes(&val, sizeof(val));
+    return val;
+}
+
+wchar_t MessageReader::ReadChar()
+{
+    wchar_t val;
+    ReadBytes(reinterpret_cast<uint8_t*>(&val), sizeof(val));
+    return val;
+}
+
+int MessageReader::ReadInt()
+{
+    int val;
+    ReadBytes(reinterpret_cast<uint8_t*>(&val), sizeof(val));
+    return val;
+}
+
+unsigned int MessageReader::ReadUnsignedInt()
+{
+    unsigned int val;
+    ReadBytes(reinterpret_cast<uint8_t*>(&val), sizeof(val));
+    return val;
+}
+
+double MessageReader::ReadDouble()
+{
+    double val;
+    ReadBytes(reinterpret_cast<uint8_t*>(&val), sizeof(val));
+    return val;
+}
+
+std::wstring MessageReader::ReadString()
+{
+    const auto length = ReadInt();
+    if (length < 0)
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    if (static_cast<size_t>(length) > GetRemainingSize() / sizeof(wchar_t))
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    std::wstring val(static_cast<size_t>(length), L'\0');
+    ReadBytes(reinterpret_cast<uint8_t*>(val.data()), val.size() * sizeof(wchar_t));
+    return val;
+}
+
+GUID MessageReader::ReadGuid()
+{
+    GUID val;
+    ReadBytes(reinterpret_cast<uint8_t*>(&val), sizeof(val));
+    return val;
+}
+
+std::vector<uint8_t> MessageReader::ReadByteArray()
+{
+    const auto length = ReadInt();
+    if (length < 0)
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    if (static_cast<size_t>(length) > GetRemainingSize())
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    std::vector<uint8_t> val(static_cast<size_t>(length));
+    ReadBytes(val.data(), val.size());
+    return val;
+}
+
+bool MessageReader::IsAtEnd() const
+{
+    return m_position == m_buffer.size();
+}
+
+size_t MessageReader::GetRemainingSize() const
+{
+    return m_buffer.size() - m_position;
+}
+
+void MessageReader::ReadBytes(_Out_writes_(count) uint8_t* bytes, size_t count)
+{
+    if (count > m_buffer.size() - m_position)
+    {
+        winrt::throw_hresult(E_INVALIDARG);
+    }
+
+    std::copy(m_buffer.begin() + m_position, m_buffer.begin() + m_position + count, bytes);
+    m_position += count;
+}
@@ -18,6 +18,9 @@ class MessageBuilder
 public:
     MessageBuilder() = default;
 
+    // Writes into the given buffer from the start, reusing its capacity.
+    explicit MessageBuilder(std::vector<uint8_t>&& buffer);
+
     void WriteBool(bool);
     void WriteByte(uint8_t);
     void WriteChar(wchar_t);
@@ -26,6 +29,7 @@ public:
     void WriteDouble(double);
     void WriteString(std::wstring_view);
     void WriteGuid(const GUID&);
+    void WriteByteArray(const std::vector<uint8_t>&);
 
     // Takes ownership of the buffer that contains the serialized representation of all values
     // that have been written to the builder thus far.
@@ -39,3 +43,33 @@ private:
     std::vector<uint8_t> m_buffer;
 };
 
+// The counterpart of MessageBuilder, which reads back values in the representation MessageBuilder writes them.
+//
+// Every read is bounds-checked against the buffer and throws E_INVALIDARG if the buffer is too short, before
+// allocating anything for the value, so it is safe to use on untrusted input such as files.
+class MessageReader
+{
+public:
+    explicit MessageReader(const std::vector<uint8_t>& buffer);
+
+    bool ReadBool();
+    uint8_t ReadByte();
+    wchar_t ReadChar();
+    int ReadInt();
+    unsigned int ReadUnsignedInt();
+    double ReadDouble();
+    std::wstring ReadString();
+    GUID ReadGuid();
+    std::vector<uint8_t> ReadByteArray();
+
+    bool IsAtEnd() const;
+    // The number of bytes left to read. Callers that allocate for a count they read should check it against this
+    // first.
+    size_t GetRemainingSize() const;
+
+private:
+    void ReadBytes(_Out_writes_(count) uint8_t* bytes, size_t count);
+
+    const std::vector<uint8_t>& m_buffer;
+    size_t m_position = 0;
+};
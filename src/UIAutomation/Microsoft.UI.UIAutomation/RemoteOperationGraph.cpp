@@ -3,9 +3,131 @@
 #include "pch.h"
 #include "RemoteOperationGraph.h"
 
+#include <iterator>
+#include <type_traits>
+
 #include "MessageBuilder.h"
 #include "RemoteOperationInstructionSerialization.h"
 
+namespace
+{
+    // The operand fields that instructions only read. Together with resultId, targetId, elementId and cacheRequestId,
+    // these are all the operand fields of the instructions, generated ones included.
+#define FOR_EACH_READ_OPERAND_FIELD(X) \
+    X(TextUnitId) X(ZoomUnitId) X(alignToTopId) X(annotationId) X(attrId) X(backwardId) X(childId) X(columnId) \
+    X(countId) X(degreesId) X(directionId) X(dockPosId) X(endpointId) X(errorCodeOperandId) X(extensionIdId) \
+    X(flagsSelectId) X(guidId) X(heightId) X(horizontalAmountId) X(horizontalPercentId) X(ignoreCaseId) \
+    X(ignoreDefaultValueId) X(indexId) X(indexOperandId) X(inputTypeId) X(intIdId) X(isActiveId) X(keyId) \
+    X(lengthId) X(lhsId) X(maxLengthId) X(metadataId) X(millisecondsId) X(nameId) X(objectOperandId) X(operandId) \
+    X(pStartAfterId) X(patternIdId) X(propertyId) X(propertyIdId) X(ptId) X(rangeId) X(rhsId) X(rowId) \
+    X(srcEndPointId) X(stateId) X(szValueId) X(targetEndPointId) X(textId) X(unitId) X(valId) X(valueId) \
+    X(verticalAmountId) X(verticalPercentId) X(viewId) X(widthId) X(xId) X(yId) X(zoomValueId)
+
+    // Detects an operand field by name, so that the operands of an instruction can be visited without listing
+    // every instruction type.
+#define DEFINE_HAS_OPERAND_FIELD(field) \
+    template <class InstructionT, class = void> \
+    struct HasOperandField_##field : std::false_type {}; \
+    \
+    template <class InstructionT> \
+    struct HasOperandField_##field<InstructionT, std::void_t<decltype(InstructionT::field)>> : \
+        std::is_same<decltype(InstructionT::field), bytecode::OperandId> {};
+
+    DEFINE_HAS_OPERAND_FIELD(resultId)
+    DEFINE_HAS_OPERAND_FIELD(targetId)
+    DEFINE_HAS_OPERAND_FIELD(elementId)
+    DEFINE_HAS_OPERAND_FIELD(cacheRequestId)
+    FOR_EACH_READ_OPERAND_FIELD(DEFINE_HAS_OPERAND_FIELD)
+
+#undef DEFINE_HAS_OPERAND_FIELD
+
+    // Instructions without a result update their target in place (Set, Add, RemoteArrayAppend, PopulateCache,
+    // CacheRequestAddProperty, etc.), as do the ones that remove from a collection.
+    template <class InstructionT>
+    constexpr bool c_writesTarget =
+        !HasOperandField_resultId<InstructionT>::value ||
+        std::is_same_v<InstructionT, bytecode::RemoteArrayRemoveAt> ||
+        std::is_same_v<InstructionT, bytecode::RemoteStringMapRemove>;
+
+    // Calls the visitor with each operand of the instruction, and whether the instruction writes it. The writes are
+    // only accurate for the non-generated instructions.
+    template <class InstructionT, class Visitor>
+    void VisitOperands(InstructionT& instruction, Visitor&& visitor)
+    {
+        using T = std::remove_const_t<InstructionT>;
+
+#define VISIT_OPERAND_FIELD(field, written) \
+        if constexpr (HasOperandField_##field<T>::value) \
+        { \
+            visitor(instruction.field, written); \
+        }
+#define VISIT_READ_OPERAND_FIELD(field) VISIT_OPERAND_FIELD(field, false)
+
+        VISIT_OPERAND_FIELD(resultId, true)
+        VISIT_OPERAND_FIELD(targetId, c_writesTarget<T>)
+        VISIT_OPERAND_FIELD(elementId, c_writesTarget<T>)
+        VISIT_OPERAND_FIELD(cacheRequestId, c_writesTarget<T> && !HasOperandField_elementId<T>::value)
+        FOR_EACH_READ_OPERAND_FIELD(VISIT_READ_OPERAND_FIELD)
+
+#undef VISIT_READ_OPERAND_FIELD
+#undef VISIT_OPERAND_FIELD
+
+        if constexpr (std::is_same_v<T, bytecode::CallExtension>)
+        {
+            // The extension may write any of its operands.
+            for (auto& operandId : instruction.operandIds)
+            {
+                visitor(operandId, true);
+            }
+        }
+    }
+
+#undef FOR_EACH_READ_OPERAND_FIELD
+
+    // Whether the instruction can run interleaved with another loop's instructions, as long as they don't share
+    // operands. The generated instructions are pattern getters and methods, whose writes VisitOperands doesn't
+    // know; the rest either act on the provider or the operation itself, or transfer control.
+    template <class InstructionT>
+    constexpr bool IsReorderable()
+    {
+        constexpr auto type = InstructionT::type;
+        if (static_cast<int>(type) > static_cast<int>(bytecode::InstructionType::IsByteArray))
+        {
+            return false;
+        }
+
+        switch (type)
+        {
+        case bytecode::InstructionType::ForkIfTrue:
+        case bytecode::InstructionType::ForkIfFalse:
+        case bytecode::InstructionType::Fork:
+        case bytecode::InstructionType::Halt:
+        case bytecode::InstructionType::NewLoopBlock:
+        case bytecode::InstructionType::EndLoopBlock:
+        case bytecode::InstructionType::NewTryBlock:
+        case bytecode::InstructionType::EndTryBlock:
+        case bytecode::InstructionType::SetOperationStatus:
+        case bytecode::InstructionType::GetOperationStatus:
+        case bytecode::InstructionType::CallExtension:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    bool Intersects(const std::unordered_set<int>& lhs, const std::unordered_set<int>& rhs)
+    {
+        for (const auto operandId : lhs)
+        {
+            if (rhs.count(operandId) > 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
 void BytecodeBuilder::Emit(const bytecode::Instruction& instruction)
 {
     m_bytecodeInstructions.emplace_back(instruction);
@@ -21,13 +143,13 @@ int BytecodeBuilder::GetInstructionCount() const
     return static_cast<int>(m_bytecodeInstructions.size());
 }
 
-std::vector<uint8_t> BytecodeBuilder::SerializeInstructionsToBuffer() const
+std::vector<uint8_t> BytecodeBuilder::SerializeInstructionsToBuffer(std::vector<uint8_t>&& buffer) const
 {
-    MessageBuilder builder;
+    MessageBuilder builder(std::move(buffer));
 
     // The first 4 bytes are the version of the bytecode format that follows. UIA currently only
     // supports one version, which is what we'll emit.
-    builder.WriteUnsignedInt(c_bytecodeCurrentVersion);
+    builder.WriteUnsignedInt(bytecode::c_bytecodeCurrentVersion);
 
     // Now serialize each instruction into the bytestream.
     RemoteOperationInstructionSerializer serializer(builder);
@@ -71,6 +193,32 @@ void RemoteOperationGraph::AddInstruction(const bytecode::Instruction& instructi
     m_nodes.emplace_back(InstructionNode{ instruction });
 }
 
+void RemoteOperationGraph::VisitInstructions(const std::function<void(bytecode::Instruction&)>& visitor)
+{
+    for (auto& node : m_nodes)
+    {
+        if (const auto instructionNode = std::get_if<InstructionNode>(&node))
+        {
+            visitor(instructionNode->instruction);
+        }
+        else if (const auto ifNode = std::get_if<IfStatementNode>(&node))
+        {
+            ifNode->trueBody->VisitInstructions(visitor);
+            ifNode->falseBody->VisitInstructions(visitor);
+        }
+        else if (const auto whileNode = std::get_if<WhileLoopNode>(&node))
+        {
+            whileNode->body->VisitInstructions(visitor);
+            whileNode->conditionUpdate->VisitInstructions(visitor);
+        }
+        else if (const auto tryNode = std::get_if<TryStatementNode>(&node))
+        {
+            tryNode->tryBody->VisitInstructions(visitor);
+            tryNode->catchBody->VisitInstructions(visitor);
+        }
+    }
+}
+
 BytecodeBuilder RemoteOperationGraph::CompileBytecode() const
 {
     BytecodeBuilder builder;
@@ -85,14 +233,393 @@ BytecodeBuilder RemoteOperationGraph::CompileBytecode() const
     return builder;
 }
 
-std::vector<uint8_t> RemoteOperationGraph::Serialize() const
+std::vector<uint8_t> RemoteOperationGraph::Serialize(std::vector<uint8_t>&& buffer, int* instructionCount) const
 {
     const auto bytecode = CompileBytecode();
-    auto byteBuffer = bytecode.SerializeInstructionsToBuffer();
+    if (instructionCount)
+    {
+        *instructionCount = bytecode.GetInstructionCount();
+    }
+    auto byteBuffer = bytecode.SerializeInstructionsToBuffer(std::move(buffer));
 
     return byteBuffer;
 }
 
+void RemoteOperationGraph::Clear()
+{
+    m_nodes.clear();
+}
+
+void RemoteOperationGraph::FuseLoops()
+{
+    // A container can only be reached through another operand once it has been stored somewhere or assigned, so
+    // one that is created here and never is can be updated in place without touching anything else.
+    OperandAccesses graph;
+    CollectAccesses(graph, 0, m_nodes.size());
+    std::unordered_set<int> unaliasedContainers;
+    for (const auto operandId : graph.createdContainers)
+    {
+        if (graph.storedOperands.count(operandId) == 0)
+        {
+            unaliasedContainers.insert(operandId);
+        }
+    }
+
+    FuseLoops(unaliasedContainers);
+}
+
+void RemoteOperationGraph::FuseLoops(const std::unordered_set<int>& unaliasedContainers)
+{
+    for (auto& node : m_nodes)
+    {
+        if (const auto ifNode = std::get_if<IfStatementNode>(&node))
+        {
+            ifNode->trueBody->FuseLoops(unaliasedContainers);
+            ifNode->falseBody->FuseLoops(unaliasedContainers);
+        }
+        else if (const auto whileNode = std::get_if<WhileLoopNode>(&node))
+        {
+            whileNode->body->FuseLoops(unaliasedContainers);
+        }
+        // Try blocks are left alone: if an iteration fails, the catch block would see the first loop having
+        // stopped partway instead of having finished.
+    }
+
+    for (size_t index = 0; index < m_nodes.size(); ++index)
+    {
+        while (TryFuseWithNextLoop(index, unaliasedContainers))
+        {
+        }
+    }
+}
+
+const bytecode::Instruction* RemoteOperationGraph::InstructionAt(const std::vector<Node>& nodes, size_t index)
+{
+    if (index >= nodes.size())
+    {
+        return nullptr;
+    }
+
+    const auto instructionNode = std::get_if<InstructionNode>(&nodes[index]);
+    return instructionNode ? &instructionNode->instruction : nullptr;
+}
+
+std::optional<RemoteOperationGraph::ArrayLoop> RemoteOperationGraph::MatchArrayLoop(size_t index) const
+{
+    const auto loop = std::get_if<WhileLoopNode>(&m_nodes[index]);
+    if (!loop || index < c_arrayLoopSetupSize || loop->conditionUpdate->m_nodes.size() != 4)
+    {
+        return std::nullopt;
+    }
+
+    const auto size = std::get_if<bytecode::RemoteArraySize>(InstructionAt(m_nodes, index - 3));
+    const auto start = std::get_if<bytecode::NewUint>(InstructionAt(m_nodes, index - 2));
+    const auto condition = std::get_if<bytecode::Compare>(InstructionAt(m_nodes, index - 1));
+
+    const auto getAt = std::get_if<bytecode::RemoteArrayGetAt>(InstructionAt(loop->body->m_nodes, 0));
+
+    const auto& update = loop->conditionUpdate->m_nodes;
+    const auto one = std::get_if<bytecode::NewUint>(InstructionAt(update, 0));
+    const auto increment = std::get_if<bytecode::Add>(InstructionAt(update, 1));
+    const auto updatedCondition = std::get_if<bytecode::Compare>(InstructionAt(update, 2));
+    const auto assignment = std::get_if<bytecode::Set>(InstructionAt(update, 3));
+
+    if (!size || !start || !condition || !getAt || !one || !increment || !updatedCondition || !assignment)
+    {
+        return std::nullopt;
+    }
+
+    const ArrayLoop match{
+        size->targetId.Value,
+        size->resultId.Value,
+        start->resultId.Value,
+        loop->conditionOperandId,
+        getAt->resultId.Value,
+    };
+
+    const auto isIndexBelowSize = [&](const bytecode::Compare& compare)
+    {
+        return compare.lhsId.Value == match.indexId &&
+            compare.rhsId.Value == match.sizeId &&
+            compare.comparisonType == bytecode::ComparisonType::LessThan;
+    };
+
+    if (start->initialValue != 0 ||
+        condition->resultId.Value != match.conditionId ||
+        !isIndexBelowSize(*condition) ||
+        getAt->targetId.Value != match.arrayId ||
+        getAt->indexOperandId.Value != match.indexId ||
+        one->initialValue != 1 ||
+        increment->targetId.Value != match.indexId ||
+        increment->rhsId.Value != one->resultId.Value ||
+        !isIndexBelowSize(*updatedCondition) ||
+        assignment->targetId.Value != match.conditionId ||
+        assignment->rhsId.Value != updatedCondition->resultId.Value)
+    {
+        return std::nullopt;
+    }
+
+    return match;
+}
+
+bool RemoteOperationGraph::TryFuseWithNextLoop(size_t& index, const std::unordered_set<int>& unaliasedContainers)
+{
+    const auto first = MatchArrayLoop(index);
+    if (!first)
+    {
+        return false;
+    }
+
+    // Only instructions may come between the loops, and the last of them must set up the second loop.
+    auto next = index + 1;
+    while (next < m_nodes.size() && std::holds_alternative<InstructionNode>(m_nodes[next]))
+    {
+        ++next;
+    }
+    if (next == m_nodes.size() || next - index - 1 < c_arrayLoopSetupSize)
+    {
+        return false;
+    }
+
+    const auto second = MatchArrayLoop(next);
+    if (!second || second->arrayId != first->arrayId)
+    {
+        return false;
+    }
+
+    auto& firstLoop = std::get<WhileLoopNode>(m_nodes[index]);
+    auto& secondLoop = std::get<WhileLoopNode>(m_nodes[next]);
+
+    // The bodies, without the instruction that gets their element.
+    OperandAccesses firstBody;
+    firstLoop.body->CollectAccesses(firstBody, 1, firstLoop.body->m_nodes.size());
+    OperandAccesses secondBody;
+    secondLoop.body->CollectAccesses(secondBody, 1, secondLoop.body->m_nodes.size());
+    if (!firstBody.reorderable || !secondBody.reorderable)
+    {
+        return false;
+    }
+
+    // Containers that a body updates in place must not be reachable through other operands, or the update could
+    // affect operands that the accesses don't mention. The same goes for the instructions between the loops.
+    const auto updatesSharedContainer = [&](const OperandAccesses& accesses)
+    {
+        for (const auto operandId : accesses.updatedContainers)
+        {
+            if (unaliasedContainers.count(operandId) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (updatesSharedContainer(firstBody) || updatesSharedContainer(secondBody))
+    {
+        return false;
+    }
+
+    // The element is passed by value, so a body that writes it (v += 1, or element = element.GetParentElement())
+    // changes what the other body would see once they share it.
+    if (firstBody.writes.count(first->elementId) > 0 || secondBody.writes.count(second->elementId) > 0)
+    {
+        return false;
+    }
+
+    // Each body may only reach the array through the element it gets for the iteration, so that the merged loop
+    // can hand the same element to both, and the array keeps the size it had when the first loop started.
+    const std::unordered_set<int> firstState{ first->arrayId, first->sizeId, first->indexId, first->conditionId, first->elementId };
+    const std::unordered_set<int> secondState{ second->arrayId, second->sizeId, second->indexId, second->conditionId, second->elementId };
+    firstBody.references.erase(first->elementId);
+    secondBody.references.erase(second->elementId);
+    if (Intersects(firstState, firstBody.references) ||
+        Intersects(firstState, secondBody.references) ||
+        Intersects(secondState, secondBody.references))
+    {
+        return false;
+    }
+
+    // Neither body may refer to what the other writes, or the order in which they run would matter.
+    if (Intersects(firstBody.writes, secondBody.references) || Intersects(secondBody.writes, firstBody.references))
+    {
+        return false;
+    }
+
+    // The instructions between the loops are moved above the first one, along with its setup, so they can't
+    // refer to anything that loop writes either.
+    const auto firstSetup = index - c_arrayLoopSetupSize;
+    const auto secondSetup = next - c_arrayLoopSetupSize;
+    OperandAccesses firstWhole;
+    CollectAccesses(firstWhole, firstSetup, index + 1);
+    OperandAccesses between;
+    CollectAccesses(between, index + 1, secondSetup);
+    if (!between.reorderable ||
+        updatesSharedContainer(between) ||
+        Intersects(between.writes, firstWhole.references) ||
+        Intersects(firstWhole.writes, between.references))
+    {
+        return false;
+    }
+
+    // The second loop's state goes away, so nothing after it may refer to it.
+    OperandAccesses rest;
+    CollectAccesses(rest, next + 1, m_nodes.size());
+    if (Intersects(secondState, rest.references))
+    {
+        return false;
+    }
+
+    // Append the second body to the first, having it use the first loop's element.
+    secondLoop.body->RenameOperand(second->elementId, first->elementId);
+    auto& firstNodes = firstLoop.body->m_nodes;
+    auto& secondNodes = secondLoop.body->m_nodes;
+    firstNodes.insert(
+        firstNodes.end(),
+        std::make_move_iterator(secondNodes.begin() + 1),
+        std::make_move_iterator(secondNodes.end()));
+
+    // Then drop the second loop and its setup, and move the instructions in between above the first loop.
+    std::vector<Node> betweenNodes(
+        std::make_move_iterator(m_nodes.begin() + index + 1),
+        std::make_move_iterator(m_nodes.begin() + secondSetup));
+    m_nodes.erase(m_nodes.begin() + index + 1, m_nodes.begin() + next + 1);
+    m_nodes.insert(
+        m_nodes.begin() + firstSetup,
+        std::make_move_iterator(betweenNodes.begin()),
+        std::make_move_iterator(betweenNodes.end()));
+
+    index += betweenNodes.size();
+    return true;
+}
+
+void RemoteOperationGraph::CollectAccesses(OperandAccesses& accesses, size_t firstNode, size_t endNode, int loopDepth) const
+{
+    for (auto i = firstNode; i < endNode; ++i)
+    {
+        const auto& node = m_nodes[i];
+        if (const auto instructionNode = std::get_if<InstructionNode>(&node))
+        {
+            std::visit([&](const auto& instruction)
+            {
+                using InstructionT = std::decay_t<decltype(instruction)>;
+                if constexpr (std::is_same_v<InstructionT, bytecode::BreakLoop> || std::is_same_v<InstructionT, bytecode::ContinueLoop>)
+                {
+                    // Breaking out of a loop nested in the range is fine; breaking out of the range's own loop isn't.
+                    if (loopDepth == 0)
+                    {
+                        accesses.reorderable = false;
+                    }
+                }
+                else if constexpr (!IsReorderable<InstructionT>())
+                {
+                    accesses.reorderable = false;
+                }
+
+                if constexpr (std::is_same_v<InstructionT, bytecode::NewArray> || std::is_same_v<InstructionT, bytecode::NewStringMap>)
+                {
+                    accesses.createdContainers.insert(instruction.resultId.Value);
+                }
+                else if constexpr (
+                    std::is_same_v<InstructionT, bytecode::RemoteArrayAppend> ||
+                    std::is_same_v<InstructionT, bytecode::RemoteArraySetAt> ||
+                    std::is_same_v<InstructionT, bytecode::RemoteArrayRemoveAt> ||
+                    std::is_same_v<InstructionT, bytecode::RemoteStringMapInsert> ||
+                    std::is_same_v<InstructionT, bytecode::RemoteStringMapRemove>)
+                {
+                    accesses.updatedContainers.insert(instruction.targetId.Value);
+                }
+
+                if constexpr (std::is_same_v<InstructionT, bytecode::RemoteArrayAppend>)
+                {
+                    accesses.storedOperands.insert(instruction.operandId.Value);
+                }
+                else if constexpr (std::is_same_v<InstructionT, bytecode::RemoteArraySetAt>)
+                {
+                    accesses.storedOperands.insert(instruction.objectOperandId.Value);
+                }
+                else if constexpr (std::is_same_v<InstructionT, bytecode::RemoteStringMapInsert>)
+                {
+                    accesses.storedOperands.insert(instruction.valueId.Value);
+                }
+                else if constexpr (std::is_same_v<InstructionT, bytecode::Set>)
+                {
+                    accesses.storedOperands.insert(instruction.targetId.Value);
+                    accesses.storedOperands.insert(instruction.rhsId.Value);
+                }
+
+                VisitOperands(instruction, [&](const bytecode::OperandId& operandId, bool written)
+                {
+                    accesses.references.insert(operandId.Value);
+                    // Populating an element's cache doesn't change which element the operand holds, nor what
+                    // reading its properties returns.
+                    if (written && !std::is_same_v<InstructionT, bytecode::PopulateCache>)
+                    {
+                        accesses.writes.insert(operandId.Value);
+                    }
+                });
+            }, instructionNode->instruction);
+        }
+        else if (const auto ifNode = std::get_if<IfStatementNode>(&node))
+        {
+            accesses.references.insert(ifNode->conditionOperandId);
+            ifNode->trueBody->CollectAccesses(accesses, 0, ifNode->trueBody->m_nodes.size(), loopDepth);
+            ifNode->falseBody->CollectAccesses(accesses, 0, ifNode->falseBody->m_nodes.size(), loopDepth);
+        }
+        else if (const auto whileNode = std::get_if<WhileLoopNode>(&node))
+        {
+            accesses.references.insert(whileNode->conditionOperandId);
+            whileNode->body->CollectAccesses(accesses, 0, whileNode->body->m_nodes.size(), loopDepth + 1);
+            whileNode->conditionUpdate->CollectAccesses(accesses, 0, whileNode->conditionUpdate->m_nodes.size(), loopDepth + 1);
+        }
+        else if (const auto tryNode = std::get_if<TryStatementNode>(&node))
+        {
+            tryNode->tryBody->CollectAccesses(accesses, 0, tryNode->tryBody->m_nodes.size(), loopDepth);
+            tryNode->catchBody->CollectAccesses(accesses, 0, tryNode->catchBody->m_nodes.size(), loopDepth);
+        }
+    }
+}
+
+void RemoteOperationGraph::RenameOperand(int operandId, int newOperandId)
+{
+    const auto rename = [&](int& id)
+    {
+        if (id == operandId)
+        {
+            id = newOperandId;
+        }
+    };
+
+    for (auto& node : m_nodes)
+    {
+        if (const auto instructionNode = std::get_if<InstructionNode>(&node))
+        {
+            std::visit([&](auto& instruction)
+            {
+                VisitOperands(instruction, [&](bytecode::OperandId& id, bool /* written */)
+                {
+                    rename(id.Value);
+                });
+            }, instructionNode->instruction);
+        }
+        else if (const auto ifNode = std::get_if<IfStatementNode>(&node))
+        {
+            rename(ifNode->conditionOperandId);
+            ifNode->trueBody->RenameOperand(operandId, newOperandId);
+            ifNode->falseBody->RenameOperand(operandId, newOperandId);
+        }
+        else if (const auto whileNode = std::get_if<WhileLoopNode>(&node))
+        {
+            rename(whileNode->conditionOperandId);
+            whileNode->body->RenameOperand(operandId, newOperandId);
+            whileNode->conditionUpdate->RenameOperand(operandId, newOperandId);
+        }
+        else if (const auto tryNode = std::get_if<TryStatementNode>(&node))
+        {
+            tryNode->tryBody->RenameOperand(operandId, newOperandId);
+            tryNode->catchBody->RenameOperand(operandId, newOperandId);
+        }
+    }
+}
+
 void RemoteOperationGraph::InstructionNode::SerializeToBuilder(BytecodeBuilder& builder) const
 {
     builder.Emit(instruction);
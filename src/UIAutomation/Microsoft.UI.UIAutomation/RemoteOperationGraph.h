@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <unordered_set>
 #include <vector>
 
 #include "RemoteOperationInstructions.h"
@@ -18,14 +21,11 @@ public:
 
     int GetInstructionCount() const;
 
-    // Serializes the bytecode into a byte buffer.
-    std::vector<uint8_t> SerializeInstructionsToBuffer() const;
+    // Serializes the bytecode into a byte buffer. The buffer, if given, is reused.
+    std::vector<uint8_t> SerializeInstructionsToBuffer(std::vector<uint8_t>&& buffer = {}) const;
 
 private:
     std::vector<bytecode::Instruction> m_bytecodeInstructions;
-
-    // The current version of bytecode that this Builder emits.
-    static constexpr unsigned int c_bytecodeCurrentVersion = 0u;
 };
 
 class RemoteOperationGraph
@@ -56,7 +56,24 @@ public:
 
     void AddInstruction(const bytecode::Instruction& instruction);
 
-    std::vector<uint8_t> Serialize() const;
+    // Calls the visitor with every instruction of the graph in program order, including the instructions nested in
+    // if, while and try blocks. The visitor may replace the instruction it's given.
+    void VisitInstructions(const std::function<void(bytecode::Instruction&)>& visitor);
+
+    // Serializes the graph into a byte buffer. The buffer, if given, is reused, and the number of instructions is
+    // stored in instructionCount, if given.
+    std::vector<uint8_t> Serialize(std::vector<uint8_t>&& buffer = {}, int* instructionCount = nullptr) const;
+
+    // Removes everything from the graph, but keeps the storage of its top level.
+    void Clear();
+
+    // Merges adjacent loops over the same array, such as consecutive UiaOperationScope::ForEach calls, into a
+    // single loop whose body runs the bodies of both on the element that it gets once per iteration. Loops are
+    // only merged when neither touches what the other writes, neither changes its element, and every container
+    // they update in place was created by the graph and never stored or assigned anywhere in it, so that running
+    // them interleaved gives the same results as running them one after the other. Loops inside try blocks are
+    // never merged.
+    void FuseLoops();
 
 private:
     // Represents a single bytecode instruction.
@@ -103,6 +120,57 @@ private:
 
     using Node = std::variant<InstructionNode, IfStatementNode, WhileLoopNode, TryStatementNode>;
 
+    // A loop over every element of an array, as emitted by UiaOperationScope::For and ForEach. The loop node
+    // directly follows the three instructions that set it up:
+    //
+    //   size = RemoteArraySize(array)
+    //   index = NewUint(0)
+    //   condition = Compare(index < size)
+    //   while (condition)
+    //   {
+    //       element = RemoteArrayGetAt(array, index)
+    //       ...
+    //   update:
+    //       Add(index, NewUint(1))
+    //       Set(condition, Compare(index < size))
+    //   }
+    struct ArrayLoop
+    {
+        int arrayId;
+        int sizeId;
+        int indexId;
+        int conditionId;
+        int elementId;
+    };
+    static constexpr size_t c_arrayLoopSetupSize = 3;
+
+    // The operands that a range of nodes refers to, and those that it writes. Creating an operand counts as
+    // writing it.
+    struct OperandAccesses
+    {
+        std::unordered_set<int> references;
+        std::unordered_set<int> writes;
+        // The arrays and string maps that the nodes create, those that they update in place, and the operands that
+        // they store in a container or Set, either side. A stored or assigned container may be shared with other
+        // operands, so updating it in place may affect operands the accesses don't mention.
+        std::unordered_set<int> createdContainers;
+        std::unordered_set<int> updatedContainers;
+        std::unordered_set<int> storedOperands;
+        // Whether the nodes consist only of instructions whose order relative to other code doesn't matter beyond
+        // the operands they access. Pattern methods, for instance, act on the provider, and a break or continue
+        // would leave a merged loop early.
+        bool reorderable = true;
+    };
+
+    static const bytecode::Instruction* InstructionAt(const std::vector<Node>& nodes, size_t index);
+    std::optional<ArrayLoop> MatchArrayLoop(size_t index) const;
+    // Merges the array loop at the given index with the next one, if possible, and updates the index to where the
+    // merged loop ends up.
+    bool TryFuseWithNextLoop(size_t& index, const std::unordered_set<int>& unaliasedContainers);
+    void FuseLoops(const std::unordered_set<int>& unaliasedContainers);
+    void CollectAccesses(OperandAccesses& accesses, size_t firstNode, size_t endNode, int loopDepth = 0) const;
+    void RenameOperand(int operandId, int newOperandId);
+
     BytecodeBuilder CompileBytecode() const;
 
     std::vector<Node> m_nodes;
@@ -11,6 +11,9 @@
 namespace bytecode
 {
 
+// The current version of bytecode that BytecodeBuilder and StaticBytecodeBuilder emit.
+constexpr unsigned int c_bytecodeCurrentVersion = 0u;
+
 struct OperandId
 {
     int Value;
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "RemoteOperationRecordingFormat.h"
+
+#include <map>
+
+namespace winrt
+{
+    using namespace winrt::Windows::Foundation;
+    using namespace winrt::Windows::Foundation::Collections;
+}
+
+namespace
+{
+    enum class ValueTag : uint8_t
+    {
+        Null = 0,
+        Unsupported = 1,
+        Empty = 2,
+        Bool = 3,
+        Char16 = 4,
+        Int32 = 5,
+        UInt32 = 6,
+        Double = 7,
+        String = 8,
+        Guid = 9,
+        Point = 10,
+        Rect = 11,
+        UInt8Array = 12,
+        Int32Array = 13,
+        Array = 14,
+        StringMap = 15,
+    };
+
+    // Arrays and string maps can nest, so bound the recursion when reading a file we didn't necessarily write.
+    constexpr int c_maxNestingDepth = 64;
+
+    void WriteTag(MessageBuilder& builder, ValueTag tag)
+    {
+        builder.WriteByte(static_cast<uint8_t>(tag));
+    }
+
+    // Returns whether the value can be replayed, i.e. whether it and everything in it were written as they are.
+    bool WriteValueInternal(MessageBuilder& builder, const winrt::IInspectable& value)
+    {
+        if (!value)
+        {
+            WriteTag(builder, ValueTag::Null);
+            return true;
+        }
+
+        if (const auto propertyValue = value.try_as<winrt::IPropertyValue>())
+        {
+            switch (propertyValue.Type())
+            {
+            case winrt::PropertyType::Empty:
+                WriteTag(builder, ValueTag::Empty);
+                return true;
+            case winrt::PropertyType::Boolean:
+                WriteTag(builder, ValueTag::Bool);
+                builder.WriteBool(propertyValue.GetBoolean());
+                return true;
+            case winrt::PropertyType::Char16:
+                WriteTag(builder, ValueTag::Char16);
+                builder.WriteChar(propertyValue.GetChar16());
+                return true;
+            case winrt::PropertyType::Int32:
+                WriteTag(builder, ValueTag::Int32);
+                builder.WriteInt(propertyValue.GetInt32());
+                return true;
+            case winrt::PropertyType::UInt32:
+                WriteTag(builder, ValueTag::UInt32);
+                builder.WriteUnsignedInt(propertyValue.GetUInt32());
+                return true;
+            case winrt::PropertyType::Double:
+                WriteTag(builder, ValueTag::Double);
+                builder.WriteDouble(propertyValue.GetDouble());
+                return true;
+            case winrt::PropertyType::String:
+                WriteTag(builder, ValueTag::String);
+                builder.WriteString(propertyValue.GetString());
+                return true;
+            case winrt::PropertyType::Guid:
+                WriteTag(builder, ValueTag::Guid);
+                builder.WriteGuid(propertyValue.GetGuid());
+                return true;
+            case winrt::PropertyType::Point:
+            {
+                const auto point = propertyValue.GetPoint();
+                WriteTag(builder, ValueTag::Point);
+                builder.WriteDouble(point.X);
+                builder.WriteDouble(point.Y);
+                return true;
+            }
+            case winrt::PropertyType::Rect:
+            {
+                const auto rect = propertyValue.GetRect();
+                WriteTag(builder, ValueTag::Rect);
+                builder.WriteDouble(rect.X);
+                builder.WriteDouble(rect.Y);
+                builder.WriteDouble(rect.Width);
+                builder.WriteDouble(rect.Height);
+                return true;
+            }
+            case winrt::PropertyType::UInt8Array:
+            {
+                winrt::com_array<uint8_t> bytes;
+                propertyValue.GetUInt8Array(bytes);
+                WriteTag(builder, ValueTag::UInt8Array);
+                builder.WriteByteArray({ bytes.begin(), bytes.end() });
+                return true;
+            }
+            case winrt::PropertyType::Int32Array:
+            {
+                winrt::com_array<int32_t> ints;
+                propertyValue.GetInt32Array(ints);
+                WriteTag(builder, ValueTag::Int32Array);
+                builder.WriteInt(static_cast<int>(ints.size()));
+                for (const auto i : ints)
+                {
+                    builder.WriteInt(i);
+                }
+                return true;
+            }
+            default:
+                break;
+            }
+        }
+        else if (const auto vector = value.try_as<winrt::IVector<winrt::IInspectable>>())
+        {
+            WriteTag(builder, ValueTag::Array);
+            builder.WriteInt(static_cast<int>(vector.Size()));
+            bool replayable = true;
+            for (const auto& element : vector)
+            {
+                replayable = WriteValueInternal(builder, element) && replayable;
+            }
+            return replayable;
+        }
+        else if (const auto map = value.try_as<winrt::IMap<winrt::hstring, winrt::IInspectable>>())
+        {
+            WriteTag(builder, ValueTag::StringMap);
+            builder.WriteInt(static_cast<int>(map.Size()));
+            bool replayable = true;
+            for (const auto& pair : map)
+            {
+                builder.WriteString(pair.Key());
+                replayable = WriteValueInternal(builder, pair.Value()) && replayable;
+            }
+            return replayable;
+        }
+
+        // Elements, text ranges, etc. only make sense in the recording process, and types the format doesn't know
+        // would replay as something else, so they're marked as such rather than written as a stand-in value.
+        WriteTag(builder, ValueTag::Unsupported);
+        return false;
+    }
+
+    // Reads the count of a sequence whose items each take at least itemSize bytes, and checks that the rest of the
+    // buffer can hold that many, so that a corrupt count can't make the caller allocate more than the buffer.
+    size_t ReadCount(MessageReader& reader, size_t itemSize)
+    {
+        const auto count = reader.ReadInt();
+        if (count < 0 || static_cast<size_t>(count) > reader.GetRemainingSize() / itemSize)
+        {
+            winrt::throw_hresult(E_INVALIDARG);
+        }
+        return static_cast<size_t>(count);
+    }
+
+    winrt::IInspectable ReadValueInternal(MessageReader& reader, int depth)
+    {
+        if (depth > c_maxNestingDepth)
+        {
+            winrt::throw_hresult(E_INVALIDARG);
+        }
+
+        switch (static_cast<ValueTag>(reader.ReadByte()))
+        {
+        case ValueTag::Null:
+            return nullptr;
+        case ValueTag::Unsupported:
+            winrt::throw_hresult(E_NOTIMPL);
+        case ValueTag::Empty:
+            return winrt::PropertyValue::CreateEmpty();
+        case ValueTag::Bool:
+            return winrt::box_value(reader.ReadBool());
+        case ValueTag::Char16:
+            return winrt::box_value(static_cast<char16_t>(reader.ReadChar()));
+        case ValueTag::Int32:
+            return winrt::box_value(reader.ReadInt());
+        case ValueTag::UInt32:
+            return winrt::box_value(reader.ReadUnsignedInt());
+        case ValueTag::Double:
+            return winrt::box_value(reader.ReadDouble());
+        case ValueTag::String:
+            return winrt::box_value(winrt::hstring{ reader.ReadString() });
+        case ValueTag::Guid:
+            return winrt::box_value(winrt::guid{ reader.ReadGuid() });
+        case ValueTag::Point:
+        {
+            const auto x = static_cast<float>(reader.ReadDouble());
+            const auto y = static_cast<float>(reader.ReadDouble());
+            return winrt::box_value(winrt::Point{ x, y });
+        }
+        case ValueTag::Rect:
+        {
+            const auto x = static_cast<float>(reader.ReadDouble());
+            const auto y = static_cast<float>(reader.ReadDouble());
+            const auto width = static_cast<float>(reader.ReadDouble());
+            const auto height = static_cast<float>(reader.ReadDouble());
+            return winrt::box_value(winrt::Rect{ x, y, width, height });
+        }
+        case ValueTag::UInt8Array:
+        {
+            const auto bytes = reader.ReadByteArray();
+            return winrt::PropertyValue::CreateUInt8Array(bytes);
+        }
+        case ValueTag::Int32Array:
+        {
+            std::vector<int32_t> ints(ReadCount(reader, sizeof(int32_t)));
+            for (auto& i : ints)
+            {
+                i = reader.ReadInt();
+            }
+            return winrt::PropertyValue::CreateInt32Array(ints);
+        }
+        case ValueTag::Array:
+        {
+            // Every value takes at least its tag byte.
+            const auto count = ReadCount(reader, sizeof(uint8_t));
+            std::vector<winrt::IInspectable> elements;
+            elements.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                elements.emplace_back(ReadValueInternal(reader, depth + 1));
+            }
+            return winrt::single_threaded_vector<winrt::IInspectable>(std::move(elements));
+        }
+        case ValueTag::StringMap:
+        {
+            // Every entry takes at least its key's length and its value's tag byte.
+            const auto count = ReadCount(reader, sizeof(int) + sizeof(uint8_t));
+            std::map<winrt::hstring, winrt::IInspectable> entries;
+            for (size_t i = 0; i < count; ++i)
+            {
+                winrt::hstring key{ reader.ReadString() };
+                entries.insert_or_assign(std::move(key), ReadValueInternal(reader, depth + 1));
+            }
+            return winrt::single_threaded_map<winrt::hstring, winrt::IInspectable>(std::move(entries));
+        }
+        default:
+            winrt::throw_hresult(E_INVALIDARG);
+        }
+    }
+}
+
+namespace recording
+{
+    bool WriteValue(MessageBuilder& builder, const winrt::IInspectable& value)
+    {
+        return WriteValueInternal(builder, value);
+    }
+
+    winrt::IInspectable ReadValue(MessageReader& reader)
+    {
+        return ReadValueInternal(reader, 0);
+    }
+}
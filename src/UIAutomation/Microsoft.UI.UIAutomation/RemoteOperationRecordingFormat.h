@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <winrt/Windows.Foundation.h>
+
+#include "MessageBuilder.h"
+
+// Implements the file format shared by AutomationRemoteOperationRecorder and AutomationRemoteOperationReplayer.
+//
+// A recording is a header followed by one record per executed operation, all written with MessageBuilder:
+//
+//   header:  int magic ('UIAR'), int version
+//   record:  int byte count, followed by that many bytes of:
+//              byte array   serialized bytecode
+//              int count, then (int operand ID, byte import kind) per imported object
+//              int count, then int operand ID per requested result
+//              int status, int extended error
+//              byte array   results: int count, then (int operand ID, value) per result the platform returned
+//
+// Values are a tag byte followed by a tag-specific payload. Arrays and string maps nest values recursively. Objects
+// that only make sense in the recording process (elements, text ranges, etc.) can't be recorded: WriteValue writes
+// the Unsupported tag for them, and ReadValue throws E_NOTIMPL for it, so such records can't be replayed.
+namespace recording
+{
+    // "UIAR" once written out in little-endian order.
+    constexpr int c_magic = 0x52414955;
+    constexpr int c_version = 1;
+
+    enum class ImportKind : uint8_t
+    {
+        Element = 0,
+        TextRange = 1,
+        ConnectionBoundObject = 2,
+    };
+
+    using Imports = std::vector<std::pair<int, ImportKind>>;
+
+    // Returns false if any part of the value was written as Unsupported.
+    bool WriteValue(MessageBuilder& builder, const winrt::Windows::Foundation::IInspectable& value);
+    winrt::Windows::Foundation::IInspectable ReadValue(MessageReader& reader);
+}
@@ -0,0 +1,446 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "RemoteOperationInstructions.h"
+
+// Builds Remote Operations bytecode at compile time, for operations whose shape never changes (e.g. reading a fixed
+// set of properties from imported elements).
+//
+// The builder writes the same byte stream that RemoteOperationGraph and RemoteOperationInstructionSerializer produce
+// for the equivalent operation at runtime, including the version header and the jump offsets of If and While blocks,
+// so the result can be passed straight to CoreAutomationRemoteOperation::Execute. Build it in a constexpr lambda:
+//
+//     static constexpr auto c_getName = []()
+//     {
+//         bytecode::StaticBytecodeBuilder<128> builder;
+//         const auto element = builder.ImportElement();
+//         builder.AddToResults(builder.GetPropertyValue(element, UIA_NamePropertyId));
+//         return builder;
+//     }();
+//
+// Imported objects never appear in the bytecode itself; they are bound to their operand IDs when the operation is
+// executed. The builder records those operand IDs (GetImports) and the IDs of the requested results (GetResults),
+// which are the only parts the caller has to supply at runtime.
+//
+// Operations that overflow the capacity, or import or request more than the given maximums, fail to compile.
+namespace bytecode
+{
+
+template <size_t Capacity, size_t MaxImports = 8, size_t MaxResults = 8>
+class StaticBytecodeBuilder
+{
+public:
+    constexpr StaticBytecodeBuilder()
+    {
+        WriteUnsignedInt(c_bytecodeCurrentVersion);
+    }
+
+    // Emits a single instruction. Only the instructions that take fixed-size operands are supported; strings are
+    // emitted with NewString instead.
+    template <class InstructionT>
+    constexpr void Emit(const InstructionT& instruction)
+    {
+        WriteInt(static_cast<int>(InstructionT::type));
+        ++m_instructionCount;
+        WritePayload(instruction);
+    }
+
+    constexpr OperandId ImportElement()
+    {
+        const auto id = NextId();
+        if (m_importCount == MaxImports)
+        {
+            throw std::length_error("too many imports");
+        }
+        m_imports[m_importCount++] = id;
+        return id;
+    }
+
+    constexpr void AddToResults(OperandId id)
+    {
+        if (m_resultCount == MaxResults)
+        {
+            throw std::length_error("too many results");
+        }
+        m_results[m_resultCount++] = id;
+    }
+
+    constexpr OperandId NewBool(bool value)
+    {
+        const auto id = NextId();
+        Emit(bytecode::NewBool{ id, value });
+        return id;
+    }
+
+    constexpr OperandId NewInt(int value)
+    {
+        const auto id = NextId();
+        Emit(bytecode::NewInt{ id, value });
+        return id;
+    }
+
+    constexpr OperandId NewUint(unsigned value)
+    {
+        const auto id = NextId();
+        Emit(bytecode::NewUint{ id, value });
+        return id;
+    }
+
+    constexpr OperandId NewString(std::wstring_view value)
+    {
+        const auto id = NextId();
+        WriteInt(static_cast<int>(InstructionType::NewString));
+        ++m_instructionCount;
+        WriteOperand(id);
+        WriteInt(static_cast<int>(value.size()));
+        for (const auto character : value)
+        {
+            WriteChar(character);
+        }
+        return id;
+    }
+
+    constexpr OperandId NewNull()
+    {
+        const auto id = NextId();
+        Emit(bytecode::NewNull{ id });
+        return id;
+    }
+
+    constexpr OperandId NewArray()
+    {
+        const auto id = NextId();
+        Emit(bytecode::NewArray{ id });
+        return id;
+    }
+
+    constexpr void Set(OperandId target, OperandId value)
+    {
+        Emit(bytecode::Set{ target, value });
+    }
+
+    // Reads a property the same way AutomationRemoteElement does, i.e. without ignoring the default value.
+    constexpr OperandId GetPropertyValue(OperandId target, PROPERTYID propertyId)
+    {
+        const auto propertyIdId = NewInt(static_cast<int>(propertyId));
+        const auto ignoreDefaultValueId = NewBool(false);
+        const auto id = NextId();
+        Emit(bytecode::GetPropertyValue{ id, target, propertyIdId, ignoreDefaultValueId });
+        return id;
+    }
+
+    constexpr OperandId Navigate(OperandId target, NavigateDirection direction)
+    {
+        const auto directionId = NewInt(static_cast<int>(direction));
+        const auto id = NextId();
+        Emit(bytecode::Navigate{ id, target, directionId });
+        return id;
+    }
+
+    constexpr OperandId IsNull(OperandId target)
+    {
+        const auto id = NextId();
+        Emit(bytecode::IsNull{ { id, target } });
+        return id;
+    }
+
+    constexpr OperandId BoolNot(OperandId target)
+    {
+        const auto id = NextId();
+        Emit(bytecode::BoolNot{ id, target });
+        return id;
+    }
+
+    constexpr OperandId Compare(OperandId lhs, OperandId rhs, ComparisonType comparisonType)
+    {
+        const auto id = NextId();
+        Emit(bytecode::Compare{ id, lhs, rhs, comparisonType });
+        return id;
+    }
+
+    constexpr OperandId Stringify(OperandId target)
+    {
+        const auto id = NextId();
+        Emit(bytecode::Stringify{ id, target });
+        return id;
+    }
+
+    constexpr void ArrayAppend(OperandId array, OperandId value)
+    {
+        Emit(bytecode::RemoteArrayAppend{ array, value });
+    }
+
+    // Emits the same layout as RemoteOperationGraph::IfStatementNode. The blocks are called with the builder.
+    template <class TrueBlock, class FalseBlock>
+    constexpr void If(OperandId condition, TrueBlock&& trueBlock, FalseBlock&& falseBlock)
+    {
+        const auto forkIfFalse = EmitJump(bytecode::ForkIfFalse{ condition, 0 });
+        const auto trueStart = m_instructionCount;
+        trueBlock(*this);
+        const auto trueCount = m_instructionCount - trueStart;
+        PatchInt(forkIfFalse, trueCount + 2);
+
+        const auto fork = EmitJump(bytecode::Fork{ 0 });
+        const auto falseStart = m_instructionCount;
+        falseBlock(*this);
+        const auto falseCount = m_instructionCount - falseStart;
+        PatchInt(fork, falseCount + 1);
+
+        if (falseCount == 0)
+        {
+            Emit(bytecode::Nop{});
+        }
+    }
+
+    template <class TrueBlock>
+    constexpr void If(OperandId condition, TrueBlock&& trueBlock)
+    {
+        If(condition, std::forward<TrueBlock>(trueBlock), [](StaticBytecodeBuilder&) {});
+    }
+
+    // Emits the same layout as RemoteOperationGraph::WhileLoopNode. conditionUpdate must recompute condition (e.g.
+    // with Set), since the condition operand is only read, never re-evaluated.
+    template <class Body, class ConditionUpdate>
+    constexpr void While(OperandId condition, Body&& body, ConditionUpdate&& conditionUpdate)
+    {
+        const auto newLoopBlock = EmitJump(bytecode::NewLoopBlock{ 0, 0 });
+        const auto forkIfFalse = EmitJump(bytecode::ForkIfFalse{ condition, 0 });
+
+        const auto bodyStart = m_instructionCount;
+        body(*this);
+        const auto bodyCount = m_instructionCount - bodyStart;
+        conditionUpdate(*this);
+        const auto totalBodyCount = m_instructionCount - bodyStart;
+
+        // NewLoopBlock's break offset is written first, followed by its continue offset.
+        PatchInt(newLoopBlock, totalBodyCount + 4);
+        PatchInt(newLoopBlock + sizeof(int), bodyCount + 2);
+        PatchInt(forkIfFalse, totalBodyCount + 2);
+
+        Emit(bytecode::Fork{ -(totalBodyCount + 1) });
+        Emit(bytecode::EndLoopBlock{});
+    }
+
+    constexpr void BreakLoop()
+    {
+        Emit(bytecode::BreakLoop{});
+    }
+
+    constexpr void ContinueLoop()
+    {
+        Emit(bytecode::ContinueLoop{});
+    }
+
+    constexpr void Halt()
+    {
+        Emit(bytecode::Halt{});
+    }
+
+    constexpr const uint8_t* Data() const { return m_buffer.data(); }
+    constexpr size_t Size() const { return m_size; }
+    constexpr int GetInstructionCount() const { return m_instructionCount; }
+
+    constexpr const OperandId* GetImports() const { return m_imports.data(); }
+    constexpr size_t GetImportCount() const { return m_importCount; }
+    constexpr const OperandId* GetResults() const { return m_results.data(); }
+    constexpr size_t GetResultCount() const { return m_resultCount; }
+
+private:
+    constexpr OperandId NextId()
+    {
+        return OperandId{ m_nextId++ };
+    }
+
+    // Emits a jump instruction whose offsets are patched once the target is known, and returns the position of its
+    // first offset.
+    template <class InstructionT>
+    constexpr size_t EmitJump(const InstructionT& instruction)
+    {
+        Emit(instruction);
+        constexpr size_t offsetBytes = std::is_same_v<InstructionT, bytecode::NewLoopBlock> ? 2 * sizeof(int) : sizeof(int);
+        return m_size - offsetBytes;
+    }
+
+    // The payloads are written in the same order as RemoteOperationInstructionSerializer writes them.
+    template <class InstructionT>
+    constexpr void WritePayload(const InstructionT& instruction)
+    {
+        if constexpr (std::is_base_of_v<bytecode::GetterBase, InstructionT>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteOperand(instruction.targetId);
+        }
+        else if constexpr (
+            std::is_same_v<InstructionT, bytecode::Nop> ||
+            std::is_same_v<InstructionT, bytecode::EndLoopBlock> ||
+            std::is_same_v<InstructionT, bytecode::BreakLoop> ||
+            std::is_same_v<InstructionT, bytecode::ContinueLoop> ||
+            std::is_same_v<InstructionT, bytecode::Halt>)
+        {
+            // No payload.
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::Set>)
+        {
+            WriteOperand(instruction.targetId);
+            WriteOperand(instruction.rhsId);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewBool>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteByte(instruction.initialValue ? 1 : 0);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewInt>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteInt(instruction.initialValue);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewUint>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteUnsignedInt(instruction.initialValue);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewChar>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteChar(instruction.initialValue);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewGuid>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteGuid(instruction.initialValue);
+        }
+        else if constexpr (
+            std::is_same_v<InstructionT, bytecode::NewNull> ||
+            std::is_same_v<InstructionT, bytecode::NewArray> ||
+            std::is_same_v<InstructionT, bytecode::NewStringMap>)
+        {
+            WriteOperand(instruction.resultId);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::ForkIfFalse> || std::is_same_v<InstructionT, bytecode::ForkIfTrue>)
+        {
+            WriteOperand(instruction.operandId);
+            WriteInt(instruction.targetOffset);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::Fork>)
+        {
+            WriteInt(instruction.targetOffset);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::NewLoopBlock>)
+        {
+            WriteInt(instruction.breakLoopOffset);
+            WriteInt(instruction.continueLoopOffset);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::RemoteArrayAppend>)
+        {
+            WriteOperand(instruction.targetId);
+            WriteOperand(instruction.operandId);
+        }
+        else if constexpr (
+            std::is_same_v<InstructionT, bytecode::RemoteArraySize> ||
+            std::is_same_v<InstructionT, bytecode::BoolNot> ||
+            std::is_same_v<InstructionT, bytecode::Stringify>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteOperand(instruction.targetId);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::Compare>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteOperand(instruction.lhsId);
+            WriteOperand(instruction.rhsId);
+            WriteInt(static_cast<int>(instruction.comparisonType));
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::GetPropertyValue>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteOperand(instruction.targetId);
+            WriteOperand(instruction.propertyIdId);
+            WriteOperand(instruction.ignoreDefaultValueId);
+        }
+        else if constexpr (std::is_same_v<InstructionT, bytecode::Navigate>)
+        {
+            WriteOperand(instruction.resultId);
+            WriteOperand(instruction.targetId);
+            WriteOperand(instruction.directionId);
+        }
+        else
+        {
+            static_assert(!std::is_same_v<InstructionT, InstructionT>, "This instruction isn't supported at compile time.");
+        }
+    }
+
+    // The primitives are written in the same little-endian representation as MessageBuilder.
+    constexpr void WriteByte(uint8_t value)
+    {
+        if (m_size == Capacity)
+        {
+            throw std::length_error("bytecode exceeds capacity");
+        }
+        m_buffer[m_size++] = value;
+    }
+
+    constexpr void WriteUnsignedInt(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            WriteByte(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    constexpr void WriteInt(int value)
+    {
+        WriteUnsignedInt(static_cast<uint32_t>(value));
+    }
+
+    constexpr void WriteChar(wchar_t value)
+    {
+        WriteByte(static_cast<uint8_t>(value));
+        WriteByte(static_cast<uint8_t>(value >> 8));
+    }
+
+    constexpr void WriteGuid(const GUID& value)
+    {
+        WriteUnsignedInt(value.Data1);
+        WriteChar(static_cast<wchar_t>(value.Data2));
+        WriteChar(static_cast<wchar_t>(value.Data3));
+        for (const auto byte : value.Data4)
+        {
+            WriteByte(byte);
+        }
+    }
+
+    constexpr void WriteOperand(OperandId id)
+    {
+        WriteInt(id.Value);
+    }
+
+    constexpr void PatchInt(size_t position, int value)
+    {
+        const auto bits = static_cast<uint32_t>(value);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            m_buffer[position + i] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+    }
+
+    std::array<uint8_t, Capacity> m_buffer{};
+    size_t m_size = 0;
+    int m_instructionCount = 0;
+    // Operand IDs start at 1, like AutomationRemoteOperation's.
+    int m_nextId = 1;
+
+    std::array<OperandId, MaxImports> m_imports{};
+    size_t m_importCount = 0;
+    std::array<OperandId, MaxResults> m_results{};
+    size_t m_resultCount = 0;
+};
+
+} // namespace bytecode
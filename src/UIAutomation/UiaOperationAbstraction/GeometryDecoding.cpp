@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <type_traits>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define GEOMETRY_DECODING_HAS_X86_INTRINSICS
+#endif
+
+#include "GeometryDecoding.h"
+
+namespace GeometryDecoding
+{
+    // The decoders below rely on these types being plain arrays of floats.
+    static_assert(std::is_standard_layout_v<winrt::Windows::Foundation::Rect> && sizeof(winrt::Windows::Foundation::Rect) == 4 * sizeof(float));
+    static_assert(std::is_standard_layout_v<winrt::Windows::Foundation::Point> && sizeof(winrt::Windows::Foundation::Point) == 2 * sizeof(float));
+
+    void NarrowToFloatScalar(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = static_cast<float>(source[i]);
+        }
+    }
+
+#ifdef GEOMETRY_DECODING_HAS_X86_INTRINSICS
+    void NarrowToFloatSse2(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            // Each conversion yields two floats in the low half of the register; pack two of them into four.
+            const __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(source + i));
+            const __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(source + i + 2));
+            _mm_storeu_ps(destination + i, _mm_movelh_ps(low, high));
+        }
+
+        NarrowToFloatScalar(source + i, count - i, destination + i);
+    }
+
+    void NarrowToFloatAvx(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128 low = _mm256_cvtpd_ps(_mm256_loadu_pd(source + i));
+            const __m128 high = _mm256_cvtpd_ps(_mm256_loadu_pd(source + i + 4));
+            _mm_storeu_ps(destination + i, low);
+            _mm_storeu_ps(destination + i + 4, high);
+        }
+
+        // Avoid the penalty for mixing AVX and legacy SSE instructions in the remainder.
+        _mm256_zeroupper();
+
+        NarrowToFloatSse2(source + i, count - i, destination + i);
+    }
+
+    bool IsAvxSupported() noexcept
+    {
+        static const bool isSupported = []()
+        {
+            int cpuInfo[4]{};
+            __cpuid(cpuInfo, 1);
+
+            // AVX needs both the instructions (bit 28) and the OS saving the YMM registers on context switches
+            // (OSXSAVE in bit 27, and the XMM and YMM state enabled in XCR0).
+            constexpr int c_osxsaveBit = 1 << 27;
+            constexpr int c_avxBit = 1 << 28;
+            if ((cpuInfo[2] & (c_osxsaveBit | c_avxBit)) != (c_osxsaveBit | c_avxBit))
+            {
+                return false;
+            }
+
+            constexpr unsigned long long c_xmmAndYmmState = 0x6;
+            return (_xgetbv(0) & c_xmmAndYmmState) == c_xmmAndYmmState;
+        }();
+
+        return isSupported;
+    }
+#else
+    void NarrowToFloatSse2(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        NarrowToFloatScalar(source, count, destination);
+    }
+
+    void NarrowToFloatAvx(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        NarrowToFloatScalar(source, count, destination);
+    }
+
+    bool IsAvxSupported() noexcept
+    {
+        return false;
+    }
+#endif
+
+    void NarrowToFloat(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept
+    {
+        if (IsAvxSupported())
+        {
+            NarrowToFloatAvx(source, count, destination);
+        }
+        else
+        {
+            NarrowToFloatSse2(source, count, destination);
+        }
+    }
+
+    void DecodeRects(_In_reads_(rectCount * 4) const double* source, size_t rectCount, _Out_writes_(rectCount) winrt::Windows::Foundation::Rect* destination) noexcept
+    {
+        NarrowToFloat(source, rectCount * 4, reinterpret_cast<float*>(destination));
+    }
+
+    void DecodePoints(_In_reads_(pointCount * 2) const double* source, size_t pointCount, _Out_writes_(pointCount) winrt::Windows::Foundation::Point* destination) noexcept
+    {
+        NarrowToFloat(source, pointCount * 2, reinterpret_cast<float*>(destination));
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+
+#include <winrt/Windows.Foundation.h>
+
+// Decodes the packed arrays of doubles that UIA uses for rectangles and points into their float-based WinRT
+// counterparts.
+//
+// Each function writes exactly as many values as it reads into a destination that the caller has already sized.
+// The vectorized versions convert with the same rounding as a static_cast, so all of them produce bit-for-bit
+// identical results.
+namespace GeometryDecoding
+{
+    // Converts count doubles to floats, using the widest instruction set the processor supports.
+    void NarrowToFloat(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept;
+
+    // Converts one value at a time.
+    void NarrowToFloatScalar(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept;
+
+    // Converts two values at a time with SSE2, and the remainder with the scalar version.
+    void NarrowToFloatSse2(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept;
+
+    // Converts four values at a time with AVX, and the remainder with the SSE2 version. Must only be called when
+    // IsAvxSupported returns true.
+    void NarrowToFloatAvx(_In_reads_(count) const double* source, size_t count, _Out_writes_(count) float* destination) noexcept;
+
+    // Whether the processor and the OS both support AVX. Always false on architectures other than x86 and x64.
+    bool IsAvxSupported() noexcept;
+
+    // Decodes rectCount rectangles, each stored as left, top, width and height.
+    void DecodeRects(_In_reads_(rectCount * 4) const double* source, size_t rectCount, _Out_writes_(rectCount) winrt::Windows::Foundation::Rect* destination) noexcept;
+
+    // Decodes pointCount points, each stored as x and y.
+    void DecodePoints(_In_reads_(pointCount * 2) const double* source, size_t pointCount, _Out_writes_(pointCount) winrt::Windows::Foundation::Point* destination) noexcept;
+}
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include "UiaAccessibilityRules.h"
+
+namespace UiaOperationAbstraction
+{
+    UiaAccessibilityRule MissingNameOnFocusableRule()
+    {
+        return {
+            L"MissingNameOnFocusable",
+            UiaRuleProperty_Name | UiaRuleProperty_IsKeyboardFocusable,
+            [](const UiaRuleElement& element)
+            {
+                return element.isKeyboardFocusable && element.name.Length() == 0u;
+            } };
+    }
+
+    UiaAccessibilityRule ZeroSizeVisibleElementRule()
+    {
+        return {
+            L"ZeroSizeVisibleElement",
+            UiaRuleProperty_IsOffscreen | UiaRuleProperty_BoundingRectangle,
+            [](const UiaRuleElement& element)
+            {
+                return !element.isOffscreen &&
+                    (element.boundingRectangle.GetWidth() == 0.0 || element.boundingRectangle.GetHeight() == 0.0);
+            } };
+    }
+
+    UiaAccessibilityRule DuplicateAutomationIdAmongSiblingsRule()
+    {
+        return {
+            L"DuplicateAutomationIdAmongSiblings",
+            UiaRuleProperty_HasDuplicateAutomationId,
+            [](const UiaRuleElement& element)
+            {
+                return element.hasDuplicateAutomationId;
+            } };
+    }
+
+    UiaAccessibilityRuleEngine::UiaAccessibilityRuleEngine(std::vector<UiaAccessibilityRule> rules) :
+        m_rules(std::move(rules))
+    {
+        for (const auto& rule : m_rules)
+        {
+            m_requiredProperties |= rule.requiredProperties;
+        }
+
+        if (m_requiredProperties & UiaRuleProperty_HasDuplicateAutomationId)
+        {
+            m_requiredProperties |= UiaRuleProperty_AutomationId;
+        }
+    }
+
+    std::vector<UiaRuleViolation> UiaAccessibilityRuleEngine::Evaluate(UiaElement root) const
+    {
+        const auto needs = [this](uint32_t property)
+        {
+            return (m_requiredProperties & property) != 0;
+        };
+
+        auto scope = UiaOperationScope::StartNew();
+        scope.BindInput(root);
+
+        // For each violating element, its runtime ID and the indices of the rules it violates.
+        UiaArray<UiaArray<UiaInt>> violatingRuntimeIds;
+        UiaArray<UiaArray<UiaInt>> violatedRuleIndices;
+
+        // Walk the subtree breadth first. The AutomationId and duplicate flag of each pending element are filled in
+        // while enumerating its parent's children, which is where duplicates are detected, so that the AutomationId
+        // is only read once per element.
+        UiaArray<UiaElement> pending;
+        UiaArray<UiaString> pendingAutomationIds;
+        UiaArray<UiaBool> pendingDuplicates;
+        UiaUint next = 0;
+
+        pending.Append(root);
+        if (needs(UiaRuleProperty_AutomationId))
+        {
+            pendingAutomationIds.Append(root.GetAutomationId());
+        }
+        pendingDuplicates.Append(false);
+
+        scope.While([&]()
+        {
+            return next < pending.Size();
+        },
+        [&]()
+        {
+            UiaUint index = 0;
+            index = next;
+            next += 1;
+            UiaElement element = pending.GetAt(index);
+
+            // Only read the properties that some rule asked for; the rest keep their defaults.
+            UiaRuleElement view{
+                needs(UiaRuleProperty_Name) ? element.GetName() : UiaString(L""),
+                needs(UiaRuleProperty_AutomationId) ? pendingAutomationIds.GetAt(index) : UiaString(L""),
+                needs(UiaRuleProperty_IsKeyboardFocusable) ? element.GetIsKeyboardFocusable() : UiaBool(false),
+                needs(UiaRuleProperty_IsEnabled) ? element.GetIsEnabled() : UiaBool(false),
+                needs(UiaRuleProperty_IsOffscreen) ? element.GetIsOffscreen() : UiaBool(false),
+                needs(UiaRuleProperty_BoundingRectangle) ? element.GetBoundingRectangle() : UiaRect(),
+                pendingDuplicates.GetAt(index) };
+
+            UiaArray<UiaInt> violated;
+            for (size_t i = 0; i < m_rules.size(); ++i)
+            {
+                scope.If(m_rules[i].isViolatedBy(view), [&]()
+                {
+                    violated.Append(static_cast<int>(i));
+                });
+            }
+
+            scope.If(violated.Size() > 0u, [&]()
+            {
+                violatingRuntimeIds.Append(element.GetRuntimeId());
+                violatedRuleIndices.Append(violated);
+            });
+
+            // Siblings whose AutomationId has already been seen under this parent are duplicates.
+            UiaStringMap<UiaBool> seenAutomationIds;
+            ForEachChildElement(element, [&](UiaElement child)
+            {
+                pending.Append(child);
+
+                UiaBool isDuplicate = false;
+                if (needs(UiaRuleProperty_AutomationId))
+                {
+                    UiaString automationId = child.GetAutomationId();
+                    pendingAutomationIds.Append(automationId);
+
+                    if (needs(UiaRuleProperty_HasDuplicateAutomationId))
+                    {
+                        scope.If(automationId.Length() > 0u, [&]()
+                        {
+                            scope.If(seenAutomationIds.HasKey(automationId), [&]()
+                            {
+                                isDuplicate = true;
+                            },
+                            [&]()
+                            {
+                                seenAutomationIds.Insert(automationId, true);
+                            });
+                        });
+                    }
+                }
+                pendingDuplicates.Append(isDuplicate);
+            });
+        });
+
+        scope.BindResult(violatingRuntimeIds, violatedRuleIndices);
+        scope.Resolve();
+
+        std::vector<UiaRuleViolation> violations;
+        const auto& localRuntimeIds = *violatingRuntimeIds;
+        const auto& localRuleIndices = *violatedRuleIndices;
+        for (size_t i = 0; i < localRuntimeIds.size(); ++i)
+        {
+            for (const int ruleIndex : *localRuleIndices[i])
+            {
+                violations.push_back({ m_rules[ruleIndex].id, *localRuntimeIds[i] });
+            }
+        }
+        return violations;
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements an accessibility rule engine that evaluates rules on the provider side and only brings violations back
+// to the client.
+namespace UiaOperationAbstraction
+{
+    // The element properties a rule can read. Rules declare the ones they need, and each needed property is read
+    // once per element however many rules use it.
+    enum UiaRuleProperty : uint32_t
+    {
+        UiaRuleProperty_None = 0x0,
+        UiaRuleProperty_Name = 0x1,
+        UiaRuleProperty_AutomationId = 0x2,
+        UiaRuleProperty_IsKeyboardFocusable = 0x4,
+        UiaRuleProperty_IsEnabled = 0x8,
+        UiaRuleProperty_IsOffscreen = 0x10,
+        UiaRuleProperty_BoundingRectangle = 0x20,
+        // Implies UiaRuleProperty_AutomationId.
+        UiaRuleProperty_HasDuplicateAutomationId = 0x40,
+    };
+
+    // The view of an element that rules are evaluated against. Properties the rules didn't ask for hold default
+    // values.
+    struct UiaRuleElement
+    {
+        UiaString name;
+        UiaString automationId;
+        UiaBool isKeyboardFocusable;
+        UiaBool isEnabled;
+        UiaBool isOffscreen;
+        UiaRect boundingRectangle;
+        // Whether an earlier sibling has the same non-empty AutomationId.
+        UiaBool hasDuplicateAutomationId;
+    };
+
+    struct UiaAccessibilityRule
+    {
+        // Identifies the rule in violation records.
+        std::wstring id;
+        // A combination of UiaRuleProperty values.
+        uint32_t requiredProperties;
+        // Builds the check for a single element, returning true where the element violates the rule.
+        std::function<UiaBool(const UiaRuleElement& element)> isViolatedBy;
+    };
+
+    // Focusable controls must have a name.
+    UiaAccessibilityRule MissingNameOnFocusableRule();
+    // Elements that aren't offscreen must have a non-zero size.
+    UiaAccessibilityRule ZeroSizeVisibleElementRule();
+    // Siblings must not share a non-empty AutomationId.
+    UiaAccessibilityRule DuplicateAutomationIdAmongSiblingsRule();
+
+    struct UiaRuleViolation
+    {
+        std::wstring ruleId;
+        std::vector<int> runtimeId;
+    };
+
+    class UiaAccessibilityRuleEngine
+    {
+    public:
+        explicit UiaAccessibilityRuleEngine(std::vector<UiaAccessibilityRule> rules);
+
+        // Evaluates every rule against every element in the subtree under root, in a single operation. Only the
+        // runtime IDs of violating elements and the indices of the rules they violate are returned from the
+        // provider.
+        std::vector<UiaRuleViolation> Evaluate(UiaElement root) const;
+
+    private:
+        std::vector<UiaAccessibilityRule> m_rules;
+        uint32_t m_requiredProperties = UiaRuleProperty_None;
+    };
+}
@@ -0,0 +1,548 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+
+#include "UiaCrawler.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        // The pool and worker that the current thread belongs to, if any.
+        struct CurrentWorker
+        {
+            UiaWorkStealingPool* pool = nullptr;
+            size_t index = 0;
+        };
+
+        thread_local CurrentWorker t_currentWorker;
+
+        std::wstring ToWstring(const wil::shared_bstr& value)
+        {
+            return std::wstring(value ? value.get() : L"");
+        }
+
+        struct CrawlRoot
+        {
+            UiaElement element;
+            std::wstring parentRuntimeId;
+            uint32_t depth;
+        };
+
+        // The roots that one operation starts its walk from. The roots of a task are assumed to belong to the same
+        // process.
+        struct CrawlTask
+        {
+            std::vector<CrawlRoot> roots;
+            // The process id of the roots, once it's known. Only needed with a sizer.
+            uint64_t connectionId;
+        };
+
+        // The results of one crawl operation. The parents of the roots are numbered from one in the order of the
+        // roots, and the visited elements are numbered after them in the order they were visited.
+        struct CrawlOperationResult
+        {
+            // The visited elements.
+            std::vector<UiaString::LocalType> runtimeIds;
+            std::vector<UiaString::LocalType> names;
+            std::vector<UiaControlType::LocalType> controlTypes;
+            std::vector<UiaUint::LocalType> parentNumbers;
+            std::vector<UiaUint::LocalType> depths;
+
+            // The elements that were found but not visited.
+            std::vector<UiaElement::LocalType> frontier;
+            std::vector<UiaUint::LocalType> frontierParentNumbers;
+            std::vector<UiaUint::LocalType> frontierDepths;
+
+            // The elements that failed while they were being visited, typically because they went away, by the
+            // number of their parent, or of the element itself if it failed while listing its children.
+            std::vector<UiaUint::LocalType> failureParentNumbers;
+            std::vector<UiaInt::LocalType> failureCodes;
+        };
+
+        // Walks breadth first from the roots, visiting at most the given number of elements and levels below each
+        // root, in a single operation.
+        CrawlOperationResult RunCrawlOperation(const std::vector<CrawlRoot>& roots, uint32_t maxElements, uint32_t maxDepth)
+        {
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaArray<UiaString> runtimeIds;
+            UiaArray<UiaString> names;
+            UiaArray<UiaControlType> controlTypes;
+            UiaArray<UiaUint> parentNumbers;
+            UiaArray<UiaUint> depths;
+
+            UiaArray<UiaElement> frontier;
+            UiaArray<UiaUint> frontierParentNumbers;
+            UiaArray<UiaUint> frontierDepths;
+
+            UiaArray<UiaUint> failureParentNumbers;
+            UiaArray<UiaInt> failureCodes;
+
+            UiaArray<UiaElement> pending;
+            UiaArray<UiaUint> pendingParentNumbers;
+            UiaArray<UiaUint> pendingDepths;
+            for (size_t i = 0; i < roots.size(); ++i)
+            {
+                // Bind a copy, so that the task's root stays local.
+                UiaElement root = roots[i].element;
+                scope.BindInput(root);
+                pending.Append(root);
+                pendingParentNumbers.Append(UiaUint{ static_cast<unsigned int>(i + 1) });
+                pendingDepths.Append(UiaUint{ 0 });
+            }
+            const auto rootCount = static_cast<unsigned int>(roots.size());
+
+            UiaUint visitedCount{ 0 };
+            UiaUint next{ 0 };
+            scope.While([&]()
+            {
+                return next < pending.Size();
+            },
+            [&]()
+            {
+                UiaElement element = pending.GetAt(next);
+                UiaUint parentNumber = pendingParentNumbers.GetAt(next);
+                UiaUint depth = pendingDepths.GetAt(next);
+                next += 1;
+
+                scope.If(visitedCount >= maxElements || depth >= maxDepth,
+                [&]()
+                {
+                    frontier.Append(element);
+                    frontierParentNumbers.Append(parentNumber);
+                    frontierDepths.Append(depth);
+                },
+                [&]()
+                {
+                    // The parent of whatever fails: the element's own parent until the element has been recorded,
+                    // and the element itself while its children are being listed.
+                    UiaUint number{ 0 };
+                    number = parentNumber;
+
+                    scope.TryCatch([&]()
+                    {
+                        // Read everything before recording anything, so that an element that goes away halfway
+                        // doesn't leave the arrays out of step.
+                        UiaString runtimeId = element.GetRuntimeId().Stringify();
+                        UiaString name = element.GetName();
+                        UiaControlType controlType = element.GetControlType();
+
+                        runtimeIds.Append(runtimeId);
+                        names.Append(name);
+                        controlTypes.Append(controlType);
+                        parentNumbers.Append(parentNumber);
+                        depths.Append(depth);
+                        visitedCount += 1;
+
+                        number = visitedCount;
+                        number += rootCount;
+                        // A copy, so that later changes to the depth don't affect it.
+                        UiaUint childDepth{ 0 };
+                        childDepth = depth;
+                        childDepth += 1;
+
+                        ForEachChildElement(element, [&](UiaElement child)
+                        {
+                            pending.Append(child);
+                            pendingParentNumbers.Append(number);
+                            pendingDepths.Append(childDepth);
+                        });
+                    },
+                    [&](UiaFailure failure)
+                    {
+                        failureParentNumbers.Append(number);
+                        failureCodes.Append(failure.GetCurrentFailureCode());
+                    });
+                });
+            });
+
+            scope.BindResult(runtimeIds, names, controlTypes, parentNumbers, depths, frontier, frontierParentNumbers,
+                frontierDepths, failureParentNumbers, failureCodes);
+            scope.Resolve();
+
+            return {
+                std::move(*runtimeIds),
+                std::move(*names),
+                std::move(*controlTypes),
+                std::move(*parentNumbers),
+                std::move(*depths),
+                std::move(*frontier),
+                std::move(*frontierParentNumbers),
+                std::move(*frontierDepths),
+                std::move(*failureParentNumbers),
+                std::move(*failureCodes) };
+        }
+
+        uint64_t GetConnectionId(const UiaElement& element)
+        {
+            auto scope = UiaOperationScope::StartNew();
+            UiaElement boundElement = element;
+            scope.BindInput(boundElement);
+            UiaInt processId = boundElement.GetProcessId();
+            scope.BindResult(processId);
+            scope.Resolve();
+            return static_cast<uint64_t>(static_cast<int>(processId));
+        }
+
+        // Whether the failure means that the elements, or their whole process, went away during the crawl.
+        bool IsVanishedElementError(HRESULT hr)
+        {
+            return hr == UIA_E_ELEMENTNOTAVAILABLE ||
+                hr == RPC_E_DISCONNECTED ||
+                hr == HRESULT_FROM_WIN32(RPC_S_SERVER_UNAVAILABLE);
+        }
+
+        void ReportFailure(const UiaCrawlOptions& options, const std::wstring& parentRuntimeId, HRESULT hr)
+        {
+            if (options.failureCallback)
+            {
+                options.failureCallback(UiaCrawlFailure{ parentRuntimeId, hr });
+            }
+        }
+
+        // Runs the task's operation, sized by the sizer if there is one.
+        CrawlOperationResult RunSizedCrawlOperation(const CrawlTask& task, uint64_t connectionId, const UiaCrawlOptions& options)
+        {
+            const auto& sizer = options.sizer;
+            while (true)
+            {
+                const auto maxElements = sizer ? sizer->GetSize(connectionId) : options.maxElementsPerOperation;
+                CrawlOperationResult result;
+                try
+                {
+                    result = RunCrawlOperation(task.roots, maxElements, options.maxDepthPerOperation);
+                }
+                catch (const InstructionLimitExceededException&)
+                {
+                    if (!sizer)
+                    {
+                        throw;
+                    }
+
+                    // Try again with a smaller operation, unless the sizer can't go any smaller.
+                    sizer->Record(connectionId, maxElements,
+                        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::InstructionLimitExceeded);
+                    if (sizer->GetSize(connectionId) >= maxElements)
+                    {
+                        throw;
+                    }
+                    continue;
+                }
+
+                if (sizer)
+                {
+                    // Operations that ran out of elements before reaching the cap are recorded at their actual
+                    // size, so they don't grow the size.
+                    sizer->Record(connectionId, static_cast<uint32_t>(result.runtimeIds.size()),
+                        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::Success);
+                }
+                return result;
+            }
+        }
+
+        // Visits the elements under the task's roots up to the limits in the options, hands them to the callback,
+        // and spawns tasks for the elements of the frontier that were left unvisited.
+        void Crawl(
+            UiaWorkStealingPool& pool,
+            const CrawlTask& task,
+            const UiaCrawlCallback& callback,
+            const UiaCrawlOptions& options)
+        {
+            auto connectionId = task.connectionId;
+            CrawlOperationResult result;
+            HRESULT vanishedHr = S_OK;
+            try
+            {
+                if (options.sizer && connectionId == 0)
+                {
+                    connectionId = GetConnectionId(task.roots.front().element);
+                }
+                result = RunSizedCrawlOperation(task, connectionId, options);
+            }
+            catch (const winrt::hresult_error& error)
+            {
+                vanishedHr = error.code();
+                if (!IsVanishedElementError(vanishedHr))
+                {
+                    throw;
+                }
+            }
+            catch (const wil::ResultException& error)
+            {
+                vanishedHr = error.GetErrorCode();
+                if (!IsVanishedElementError(vanishedHr))
+                {
+                    throw;
+                }
+            }
+
+            // Elements that fail within the operation are caught there; this is for the ones that take the whole
+            // operation down with them, such as a root whose process has exited.
+            if (FAILED(vanishedHr))
+            {
+                for (const auto& root : task.roots)
+                {
+                    ReportFailure(options, root.parentRuntimeId, vanishedHr);
+                }
+                return;
+            }
+
+            const auto rootCount = task.roots.size();
+            std::vector<UiaCrawledElement> elements;
+            elements.reserve(result.runtimeIds.size());
+            // The index of the root that each visited element is under.
+            std::vector<size_t> elementRoots;
+            elementRoots.reserve(result.runtimeIds.size());
+
+            // Finds the runtime ID of the parent with the given number, and the root that its children are under.
+            // Parents are always visited before their children.
+            const auto findParent = [&](UiaUint::LocalType parentNumber) -> std::pair<std::wstring, size_t>
+            {
+                const auto number = static_cast<size_t>(parentNumber);
+                if (number <= rootCount)
+                {
+                    return { task.roots[number - 1].parentRuntimeId, number - 1 };
+                }
+                return { elements[number - rootCount - 1].runtimeId, elementRoots[number - rootCount - 1] };
+            };
+
+            for (size_t i = 0; i < result.runtimeIds.size(); ++i)
+            {
+                auto [parentRuntimeId, rootIndex] = findParent(result.parentNumbers[i]);
+
+                UiaCrawledElement crawled;
+                crawled.runtimeId = ToWstring(result.runtimeIds[i]);
+                crawled.parentRuntimeId = std::move(parentRuntimeId);
+                crawled.name = ToWstring(result.names[i]);
+                crawled.controlType = result.controlTypes[i];
+                crawled.depth = task.roots[rootIndex].depth + result.depths[i];
+                elements.emplace_back(std::move(crawled));
+                elementRoots.emplace_back(rootIndex);
+            }
+
+            for (size_t i = 0; i < result.failureCodes.size(); ++i)
+            {
+                ReportFailure(options, findParent(result.failureParentNumbers[i]).first, static_cast<HRESULT>(result.failureCodes[i]));
+            }
+
+            // Spawn before handing the elements over, so that idle workers can start on the frontier right away. The
+            // frontier is split into batches that each start one operation, rather than a task per element, so that
+            // wide levels don't take a round trip per element.
+            const auto batchSize = std::max<size_t>(
+                options.sizer ? options.sizer->GetSize(connectionId) : options.maxElementsPerOperation, 1);
+            for (size_t batchStart = 0; batchStart < result.frontier.size(); batchStart += batchSize)
+            {
+                const auto batchEnd = std::min(batchStart + batchSize, result.frontier.size());
+
+                CrawlTask frontierTask{ {}, connectionId };
+                frontierTask.roots.reserve(batchEnd - batchStart);
+                for (auto i = batchStart; i < batchEnd; ++i)
+                {
+                    auto [parentRuntimeId, rootIndex] = findParent(result.frontierParentNumbers[i]);
+                    frontierTask.roots.push_back(CrawlRoot{
+                        result.frontier[i],
+                        std::move(parentRuntimeId),
+                        task.roots[rootIndex].depth + result.frontierDepths[i] });
+                }
+
+                pool.Spawn([frontierTask = std::move(frontierTask), &callback, &options](UiaWorkStealingPool& taskPool)
+                {
+                    Crawl(taskPool, frontierTask, callback, options);
+                });
+            }
+
+            if (!elements.empty())
+            {
+                callback(std::move(elements));
+            }
+        }
+    }
+
+    UiaWorkStealingPool::UiaWorkStealingPool(size_t workerCount)
+    {
+        // hardware_concurrency returns zero when it can't tell.
+        workerCount = std::max<size_t>(workerCount, 1);
+
+        m_workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            m_workers.emplace_back(std::make_unique<Worker>());
+        }
+    }
+
+    UiaWorkStealingMetrics UiaWorkStealingPool::Run(std::vector<Task> tasks)
+    {
+        m_failure = nullptr;
+        m_taskCount = 0;
+        m_stealCount = 0;
+
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            Push(i % m_workers.size(), std::move(tasks[i]));
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(m_workers.size());
+        for (size_t i = 0; i < m_workers.size(); ++i)
+        {
+            threads.emplace_back([this, i]()
+            {
+                RunWorker(i);
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        if (m_failure)
+        {
+            std::rethrow_exception(m_failure);
+        }
+
+        UiaWorkStealingMetrics metrics;
+        metrics.taskCount = m_taskCount;
+        metrics.stealCount = m_stealCount;
+        return metrics;
+    }
+
+    void UiaWorkStealingPool::Spawn(Task task)
+    {
+        THROW_HR_IF(E_ILLEGAL_METHOD_CALL, t_currentWorker.pool != this);
+        Push(t_currentWorker.index, std::move(task));
+    }
+
+    void UiaWorkStealingPool::Push(size_t workerIndex, Task task)
+    {
+        // Count the task before it can be taken, so that the counts never drop below the number of tasks.
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            ++m_queuedCount;
+            ++m_outstandingCount;
+        }
+
+        {
+            auto& worker = *m_workers[workerIndex];
+            std::lock_guard<std::mutex> lock(worker.lock);
+            worker.tasks.emplace_back(std::move(task));
+        }
+        m_workAvailable.notify_one();
+    }
+
+    bool UiaWorkStealingPool::TryTake(size_t workerIndex, Task& task)
+    {
+        for (size_t offset = 0; offset < m_workers.size(); ++offset)
+        {
+            const auto victimIndex = (workerIndex + offset) % m_workers.size();
+            auto& victim = *m_workers[victimIndex];
+
+            std::unique_lock<std::mutex> lock(victim.lock);
+            if (victim.tasks.empty())
+            {
+                continue;
+            }
+
+            // Our own newest task, or the oldest one of another worker.
+            if (victimIndex == workerIndex)
+            {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                ++m_stealCount;
+            }
+            lock.unlock();
+
+            std::lock_guard<std::mutex> countLock(m_lock);
+            --m_queuedCount;
+            return true;
+        }
+        return false;
+    }
+
+    void UiaWorkStealingPool::RunWorker(size_t workerIndex)
+    {
+        auto coInit = wil::CoInitializeEx(COINIT_MULTITHREADED);
+        t_currentWorker = { this, workerIndex };
+        auto clearCurrentWorker = wil::scope_exit([]()
+        {
+            t_currentWorker = {};
+        });
+
+        while (true)
+        {
+            Task task;
+            if (TryTake(workerIndex, task))
+            {
+                bool failed = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    failed = static_cast<bool>(m_failure);
+                }
+
+                if (!failed)
+                {
+                    try
+                    {
+                        task(*this);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        if (!m_failure)
+                        {
+                            m_failure = std::current_exception();
+                        }
+                    }
+                    ++m_taskCount;
+                }
+
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (--m_outstandingCount == 0)
+                {
+                    m_workAvailable.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_workAvailable.wait(lock, [&]()
+            {
+                return m_queuedCount > 0 || m_outstandingCount == 0;
+            });
+
+            if (m_outstandingCount == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    UiaWorkStealingMetrics CrawlSubtrees(
+        const std::vector<UiaElement>& roots,
+        const UiaCrawlCallback& callback,
+        const UiaCrawlOptions& options)
+    {
+        THROW_HR_IF(E_INVALIDARG, options.maxDepthPerOperation == 0 || (!options.sizer && options.maxElementsPerOperation == 0));
+
+        std::vector<UiaWorkStealingPool::Task> tasks;
+        tasks.reserve(roots.size());
+        for (const auto& root : roots)
+        {
+            tasks.emplace_back([rootTask = CrawlTask{ { CrawlRoot{ root, std::wstring(), 0 } }, 0 }, &callback, &options](UiaWorkStealingPool& taskPool)
+            {
+                Crawl(taskPool, rootTask, callback, options);
+            });
+        }
+
+        UiaWorkStealingPool pool(options.workerCount);
+        return pool.Run(std::move(tasks));
+    }
+}
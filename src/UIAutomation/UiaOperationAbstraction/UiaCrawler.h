@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+#include "UiaOperationSizer.h"
+
+// Implements a crawler that walks many subtrees at once, such as those of every top-level window on the desktop,
+// with each worker thread building and resolving its own operations.
+namespace UiaOperationAbstraction
+{
+    struct UiaWorkStealingMetrics
+    {
+        uint64_t taskCount = 0;
+        // Tasks that a worker took from another worker's deque.
+        uint64_t stealCount = 0;
+    };
+
+    // Runs tasks, and the tasks that they spawn, on a fixed number of worker threads.
+    //
+    // Each worker has its own deque. A worker pushes the tasks it spawns onto the back of its deque and takes its
+    // next task from the back too, so it stays within the subtree it's working on. Idle workers steal from the
+    // front of other workers' deques, where the oldest and typically largest pieces of work are. Workers are
+    // initialized for the multithreaded apartment.
+    class UiaWorkStealingPool
+    {
+    public:
+        using Task = std::function<void(UiaWorkStealingPool& pool)>;
+
+        explicit UiaWorkStealingPool(size_t workerCount = std::thread::hardware_concurrency());
+
+        UiaWorkStealingPool(const UiaWorkStealingPool&) = delete;
+        UiaWorkStealingPool& operator=(const UiaWorkStealingPool&) = delete;
+
+        // Runs the tasks and everything they spawn, and returns once all of them have finished. The tasks are
+        // dealt out to the workers in turn. If a task throws, the tasks that haven't started yet are dropped, and
+        // the first exception is rethrown once the running ones have finished.
+        UiaWorkStealingMetrics Run(std::vector<Task> tasks);
+
+        // Queues a task on the calling worker's deque. Must be called from a task run by this pool.
+        void Spawn(Task task);
+
+        size_t GetWorkerCount() const { return m_workers.size(); }
+
+    private:
+        struct Worker
+        {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        void Push(size_t workerIndex, Task task);
+        bool TryTake(size_t workerIndex, Task& task);
+        void RunWorker(size_t workerIndex);
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+
+        // Guards the counts and the failure, and is what idle workers wait on.
+        std::mutex m_lock;
+        std::condition_variable m_workAvailable;
+        // Tasks waiting in a deque.
+        size_t m_queuedCount = 0;
+        // Tasks waiting in a deque or running. Run returns once this drops to zero.
+        size_t m_outstandingCount = 0;
+        std::exception_ptr m_failure;
+
+        std::atomic<uint64_t> m_taskCount{ 0 };
+        std::atomic<uint64_t> m_stealCount{ 0 };
+    };
+
+    struct UiaCrawledElement
+    {
+        // The Stringify'd runtime IDs of the element and of its parent. The parent's is empty for the roots.
+        std::wstring runtimeId;
+        std::wstring parentRuntimeId;
+        std::wstring name;
+        CONTROLTYPEID controlType = 0;
+        // How far below its root the element is.
+        uint32_t depth = 0;
+    };
+
+    struct UiaCrawlFailure
+    {
+        // The Stringify'd runtime ID of the parent of what was skipped, empty for the roots.
+        std::wstring parentRuntimeId;
+        HRESULT hr = S_OK;
+    };
+
+    struct UiaCrawlOptions
+    {
+        size_t workerCount = std::thread::hardware_concurrency();
+
+        // Each operation walks at most this many levels below its starting elements and visits at most this many
+        // elements. Whatever is left of its frontier is queued as new tasks of up to maxElementsPerOperation
+        // starting elements each, which idle workers can steal. This keeps each operation well within the
+        // instruction limit, and splits up large subtrees, so that one huge window doesn't keep a single worker busy
+        // while the others sit idle.
+        uint32_t maxDepthPerOperation = 8;
+        uint32_t maxElementsPerOperation = 256;
+
+        // If given, the sizer chooses the number of elements per operation for each process instead, and
+        // operations that hit the instruction limit are retried at the size it cuts them to. Finding a root's
+        // process takes an extra round trip per root.
+        std::shared_ptr<UiaOperationSizer> sizer;
+
+        // If given, called for every element or subtree that's skipped because it failed, typically because it
+        // went away during the crawl. It's called on the worker threads, possibly several at once.
+        std::function<void(const UiaCrawlFailure& failure)> failureCallback;
+    };
+
+    // Receives the elements visited by one operation, parents before their children. It's called on the worker
+    // threads, possibly several at once.
+    using UiaCrawlCallback = std::function<void(std::vector<UiaCrawledElement>&& elements)>;
+
+    // Visits every element in the subtrees under the given roots, such as the children of the desktop, spreading
+    // the work over a UiaWorkStealingPool. Since operations against different providers don't wait on each other,
+    // throughput grows with the number of workers for as long as there are both cores and target processes to go
+    // around. Elements that go away during the crawl are reported to the failure callback and skipped along with
+    // their subtrees; any other failure ends the crawl and is rethrown.
+    UiaWorkStealingMetrics CrawlSubtrees(
+        const std::vector<UiaElement>& roots,
+        const UiaCrawlCallback& callback,
+        const UiaCrawlOptions& options = {});
+}
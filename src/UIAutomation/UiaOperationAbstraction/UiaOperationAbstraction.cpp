@@ -2,8 +2,11 @@
 // Licensed under the MIT License.
 #include "pch.h"
 
+#include <algorithm>
+
 #include "UiaOperationAbstraction.h"
 #include "SafeArrayUtil.h"
+#include "GeometryDecoding.h"
 
 using namespace winrt::Microsoft::UI::UIAutomation;
 using namespace winrt::Windows::UI::UIAutomation;
@@ -367,13 +370,36 @@ namespace UiaOperationAbstraction
         bool g_useRemoteOperations = false;
         wil::object_without_destructor_on_shutdown<wil::com_ptr<IUIAutomation>> g_automation;
 
+        // The raw view walker and condition of g_automation. They never change for a given IUIAutomation, so they're
+        // fetched once in Initialize rather than on every local navigation. If that failed, they're null and are
+        // fetched on demand instead.
+        wil::object_without_destructor_on_shutdown<wil::com_ptr<IUIAutomationTreeWalker>> g_rawViewWalker;
+        wil::object_without_destructor_on_shutdown<wil::com_ptr<IUIAutomationCondition>> g_rawViewCondition;
+
         wil::com_ptr<IUIAutomationTreeWalker> GetRawViewWalker()
         {
+            if (g_rawViewWalker.get())
+            {
+                return g_rawViewWalker.get();
+            }
+
             wil::com_ptr<IUIAutomationTreeWalker> walker;
             THROW_IF_FAILED(g_automation.get()->get_RawViewWalker(&walker));
             return walker;
         }
 
+        wil::com_ptr<IUIAutomationCondition> GetRawViewCondition()
+        {
+            if (g_rawViewCondition.get())
+            {
+                return g_rawViewCondition.get();
+            }
+
+            wil::com_ptr<IUIAutomationCondition> condition;
+            THROW_IF_FAILED(g_automation.get()->get_RawViewCondition(&condition));
+            return condition;
+        }
+
         // Converts an IInspectable to an appropriate VARIANT.
         wil::unique_variant InspectableToVariant(const winrt::IInspectable& value, int depth = 0);
 
@@ -748,6 +774,117 @@ namespace UiaOperationAbstraction
         m_member = winrt::unbox_value<GUID>(result);
     }
 
+    void UiaStringTable::Reserve(size_t stringCount, size_t characterCount)
+    {
+        m_characters.reserve(m_characters.size() + characterCount);
+        m_offsets.reserve(m_offsets.size() + stringCount);
+        m_isNull.reserve(m_isNull.size() + stringCount);
+    }
+
+    void UiaStringTable::Append(std::wstring_view value)
+    {
+        m_characters.append(value);
+        m_offsets.push_back(m_characters.size());
+        m_isNull.push_back(false);
+    }
+
+    void UiaStringTable::AppendNull()
+    {
+        m_offsets.push_back(m_characters.size());
+        m_isNull.push_back(true);
+    }
+
+    void UiaStringTable::Clear()
+    {
+        m_characters.clear();
+        m_offsets.assign(1, 0);
+        m_isNull.clear();
+    }
+
+    void UiaStringTable::FromRemoteResult(const winrt::Windows::Foundation::IInspectable& result)
+    {
+        Clear();
+
+        // A result that isn't an array fails the same way it would for UiaArray, rather than leaving an empty table
+        // that can't be told apart from an empty array. A null result is still an empty table.
+        const auto items = result.as<winrt::Windows::Foundation::Collections::IVector<winrt::Windows::Foundation::IInspectable>>();
+        if (!items)
+        {
+            return;
+        }
+
+        // Fetch all of the items with one call, rather than one call per item.
+        std::vector<winrt::Windows::Foundation::IInspectable> boxedItems(items.Size());
+        items.GetMany(0, boxedItems);
+
+        Reserve(boxedItems.size(), 0);
+        for (const auto& item : boxedItems)
+        {
+            if (item)
+            {
+                // Unboxing only adds a reference to the string, so the characters are copied once, into the table.
+                Append(winrt::unbox_value<winrt::hstring>(item));
+            }
+            else
+            {
+                AppendNull();
+            }
+        }
+    }
+
+    void UiaStringTable::FromSafeArray(unique_safearray&& array)
+    {
+        Clear();
+
+        // The array still owns the strings, and frees them when it's destroyed on return.
+        SafeArrayAccessor<BSTR> sa(array.get(), VT_BSTR);
+        const UINT count = sa.Count();
+
+        // BSTRs carry their length, so sizing the buffer up front is cheap.
+        size_t characterCount = 0;
+        for (UINT i = 0; i < count; ++i)
+        {
+            characterCount += ::SysStringLen(sa[i]);
+        }
+        Reserve(count, characterCount);
+
+        for (UINT i = 0; i < count; ++i)
+        {
+            if (sa[i])
+            {
+                Append(std::wstring_view(sa[i], ::SysStringLen(sa[i])));
+            }
+            else
+            {
+                AppendNull();
+            }
+        }
+    }
+
+    void UiaStringTable::FromLocalArray(const std::vector<UiaString::LocalType>& strings)
+    {
+        Clear();
+
+        size_t characterCount = 0;
+        for (const auto& string : strings)
+        {
+            characterCount += ::SysStringLen(string.get());
+        }
+        Reserve(strings.size(), characterCount);
+
+        for (const auto& string : strings)
+        {
+            if (string)
+            {
+                Append(std::wstring_view(string.get(), ::SysStringLen(string.get())));
+            }
+            else
+            {
+                AppendNull();
+            }
+        }
+    }
+
 
     namespace impl
     {
@@ -781,21 +918,47 @@ namespace UiaOperationAbstraction
                 throw winrt::hresult_error(E_UNEXPECTED);
             }
             const auto rectCount = len / 4;
-            result.reserve(rectCount);
+            result.resize(rectCount);
+            GeometryDecoding::DecodeRects(accessor.Ptr(), rectCount, result.data());
 
-            for (unsigned int i = 0; i < rectCount; ++i)
-            {
-                const auto left = static_cast<float>(accessor[(4 * i) + 0]);
-                const auto top = static_cast<float>(accessor[(4 * i) + 1]);
-                const auto width = static_cast<float>(accessor[(4 * i) + 2]);
-                const auto height = static_cast<float>(accessor[(4 * i) + 3]);
+            return result;
+        }
+
+        template <>
+        std::vector<winrt::Windows::Foundation::Point> ConvertSafeArray<UiaPoint>(unique_safearray&& array)
+        {
+            SafeArrayAccessor<double> accessor(array.get(), VT_R8);
+            std::vector<winrt::Windows::Foundation::Point> result;
 
-                result.emplace_back(left, top, width, height);
+            const unsigned int len = accessor.Count();
+            if ((len % 2) != 0)
+            {
+                throw winrt::hresult_error(E_UNEXPECTED);
             }
+            const auto pointCount = len / 2;
+            result.resize(pointCount);
+            GeometryDecoding::DecodePoints(accessor.Ptr(), pointCount, result.data());
 
             return result;
         }
 
+        void GetComPattern(
+            const winrt::com_ptr<IUIAutomationElement>& element,
+            bool useCachedApi,
+            PATTERNID patternId,
+            REFIID patternInterfaceId,
+            _COM_Outptr_ void** pattern)
+        {
+            if (useCachedApi)
+            {
+                winrt::check_hresult(element->GetCachedPatternAs(patternId, patternInterfaceId, pattern));
+            }
+            else
+            {
+                winrt::check_hresult(element->GetCurrentPatternAs(patternId, patternInterfaceId, pattern));
+            }
+        }
+
         void PopulateCacheHelper(
             const winrt::Microsoft::UI::UIAutomation::AutomationRemoteElement& element,
             const winrt::Microsoft::UI::UIAutomation::AutomationRemoteCacheRequest& cacheRequest)
@@ -820,21 +983,141 @@ namespace UiaOperationAbstraction
                     elements.GetAt(i).AsElement().PopulateCache(cacheRequest);
                 });
         }
+
+        UiaLocalPropertyBatch* GetCurrentLocalPropertyBatch()
+        {
+            const auto delegator = UiaOperationScope::GetCurrentDelegator();
+            if (!delegator || delegator->GetUseRemoteApi())
+            {
+                return nullptr;
+            }
+
+            return delegator->GetLocalPropertyBatch();
+        }
     } // namespace impl
 
     void Initialize(bool useRemoteOperations, _In_ IUIAutomation* automation) noexcept
     {
+#ifdef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
+        FAIL_FAST_IF(useRemoteOperations);
+#endif
         UiaOperationScope::EnsureContextManagersAreAllocated();
         g_useRemoteOperations = useRemoteOperations;
         g_automation.get() = automation;
+
+        g_rawViewWalker.get().reset();
+        g_rawViewCondition.get().reset();
+        if (automation)
+        {
+            // Failures here aren't fatal; GetRawViewWalker and GetRawViewCondition try again when they're needed.
+            LOG_IF_FAILED(automation->get_RawViewWalker(&g_rawViewWalker.get()));
+            LOG_IF_FAILED(automation->get_RawViewCondition(&g_rawViewCondition.get()));
+        }
     }
 
     void Cleanup() noexcept
     {
         UiaOperationScope::FreeContextManagers();
+        g_rawViewWalker.get().reset();
+        g_rawViewCondition.get().reset();
         g_automation.get().reset();
     }
 
+    UiaArray<UiaElement> GetChildElements(UiaElement element, std::optional<UiaCacheRequest> cacheRequest /* = std::nullopt */)
+    {
+        if (ShouldUseRemoteApi())
+        {
+            UiaArray<UiaElement> children;
+            ForEachChildElement(element, [&](UiaElement child)
+            {
+                children.Append(child);
+            }, cacheRequest);
+            return children;
+        }
+
+        const auto condition = GetRawViewCondition();
+        winrt::com_ptr<IUIAutomationElementArray> localChildren;
+        if (cacheRequest)
+        {
+            winrt::check_hresult(element->FindAllBuildCache(
+                TreeScope_Children,
+                condition.get(),
+                (*cacheRequest.value()).get(),
+                localChildren.put()));
+        }
+        else
+        {
+            winrt::check_hresult(element->FindAll(TreeScope_Children, condition.get(), localChildren.put()));
+        }
+
+        if (!localChildren)
+        {
+            return UiaArray<UiaElement>();
+        }
+        return localChildren;
+    }
+
+    // UiaLocalPropertyBatch
+    void UiaLocalPropertyBatch::AddProperty(PROPERTYID propertyId)
+    {
+        if (std::find(m_properties.begin(), m_properties.end(), propertyId) == m_properties.end())
+        {
+            m_properties.push_back(propertyId);
+        }
+    }
+
+    winrt::com_ptr<IUIAutomationElement> UiaLocalPropertyBatch::GetCachedElement(
+        const winrt::com_ptr<IUIAutomationElement>& element,
+        PROPERTYID propertyId)
+    {
+        AddProperty(propertyId);
+
+        // Elements are only remembered for a while, so that a scope visiting a large tree doesn't keep every
+        // element it has read alive until it ends.
+        if (m_elements.size() >= c_maxCachedElements && m_elements.count(element.get()) == 0)
+        {
+            m_elements.clear();
+        }
+
+        auto& entry = m_elements[element.get()];
+        if (entry.failed)
+        {
+            return nullptr;
+        }
+
+        const auto propertyIndex = static_cast<size_t>(
+            std::find(m_properties.begin(), m_properties.end(), propertyId) - m_properties.begin());
+        if (entry.cachedElement && propertyIndex < entry.propertyCount)
+        {
+            return entry.cachedElement;
+        }
+
+        // Either the element hasn't been seen yet, or the property is new to the batch. Either way, the cache is
+        // rebuilt with every property seen so far, so that later properties are likely to be in it already.
+        winrt::com_ptr<IUIAutomationCacheRequest> cacheRequest;
+        THROW_HR_IF_NULL(E_ILLEGAL_METHOD_CALL, g_automation.get());
+        THROW_IF_FAILED(g_automation.get()->CreateCacheRequest(cacheRequest.put()));
+        for (const auto property : m_properties)
+        {
+            THROW_IF_FAILED(cacheRequest->AddProperty(property));
+        }
+
+        // A failure here is left to the direct read, which reports it the same way it would without batching. The
+        // element is then read directly from here on rather than paying for a build that is likely to fail again.
+        winrt::com_ptr<IUIAutomationElement> cachedElement;
+        ++m_buildCount;
+        entry.element = element;
+        if (FAILED(element->BuildUpdatedCache(cacheRequest.get(), cachedElement.put())) || !cachedElement)
+        {
+            entry.failed = true;
+            return nullptr;
+        }
+
+        entry.cachedElement = std::move(cachedElement);
+        entry.propertyCount = m_properties.size();
+        return entry.cachedElement;
+    }
+
     // UiaFailure
     UiaInt UiaFailure::GetCurrentFailureCode()
     {
@@ -855,15 +1138,18 @@ namespace UiaOperationAbstraction
     {
     }
 
-    UiaOperationDelegator::UiaOperationDelegator(bool useRemoteApi) : 
-        m_useRemoteApi(useRemoteApi)
+#ifdef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
+    UiaOperationDelegator::UiaOperationDelegator(bool useRemoteApi) :
+        m_remoteOperation(nullptr)
     {
+        THROW_HR_IF(E_INVALIDARG, useRemoteApi);
     }
-
-    bool UiaOperationDelegator::GetUseRemoteApi() const
+#else
+    UiaOperationDelegator::UiaOperationDelegator(bool useRemoteApi) : 
+        m_useRemoteApi(useRemoteApi)
     {
-        return m_useRemoteApi;
     }
+#endif
 
     bool UiaOperationDelegator::IsOpcodeSupported(const uint32_t opcode) const
     {
@@ -1645,6 +1931,32 @@ namespace UiaOperationAbstraction
         return localVal[index];
     }
 
+    UiaString UiaString::Concat(const UiaString& rhs) const
+    {
+        if (ShouldUseRemoteApi())
+        {
+            auto delegator = UiaOperationScope::GetCurrentDelegator();
+            FAIL_FAST_IF(!delegator);
+
+            auto mutableThis = *this;
+            delegator->ConvertVariantDataToRemote(mutableThis.m_member);
+            auto mutableRhs = rhs;
+            delegator->ConvertVariantDataToRemote(mutableRhs.m_member);
+            return std::get<winrt::Microsoft::UI::UIAutomation::AutomationRemoteString>(mutableThis.m_member).Concat(std::get<winrt::Microsoft::UI::UIAutomation::AutomationRemoteString>(mutableRhs.m_member));
+        }
+
+        const auto lhsLocal = std::get<wil::shared_bstr>(m_member).get();
+        const auto rhsLocal = std::get<wil::shared_bstr>(rhs.m_member).get();
+        const auto lhsLength = ::SysStringLen(lhsLocal);
+        const auto rhsLength = ::SysStringLen(rhsLocal);
+
+        wil::unique_bstr result{ ::SysAllocStringLen(nullptr, lhsLength + rhsLength) };
+        THROW_IF_NULL_ALLOC(result.get());
+        std::copy_n(lhsLocal, lhsLength, result.get());
+        std::copy_n(rhsLocal, rhsLength, result.get() + lhsLength);
+        return std::move(result);
+    }
+
     UiaPoint::UiaPoint() : UiaPoint(winrt::Windows::Foundation::Point{ 0.0f /* X */, 0.0f /* Y */ })
     {
     }
@@ -2287,7 +2599,9 @@ namespace UiaOperationAbstraction
     }
 
     UiaOperationScope::UiaOperationScope(UiaOperationScope&& other):
-        m_ownContext(other.m_ownContext)
+        m_ownContext(other.m_ownContext),
+        m_deadline(other.m_deadline),
+        m_deadlineExceeded(other.m_deadlineExceeded)
     {
         other.m_ownContext = false;
     }
@@ -2305,6 +2619,8 @@ namespace UiaOperationAbstraction
     UiaOperationScope& UiaOperationScope::operator=(UiaOperationScope&& other)
     {
         m_ownContext = other.m_ownContext;
+        m_deadline = other.m_deadline;
+        m_deadlineExceeded = other.m_deadlineExceeded;
         other.m_ownContext = false;
         return *this;
     }
@@ -2344,6 +2660,12 @@ namespace UiaOperationAbstraction
         auto status = winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::Success;
         HRESULT extendedError = S_OK;
 
+        // The remote operation of a scope whose deadline has passed may still be running.
+        if (m_deadlineExceeded)
+        {
+            throw DeadlineExceededException();
+        }
+
         // Resolve does nothing if we don't own the current context. 
         if (m_ownContext)
         {
@@ -2355,7 +2677,7 @@ namespace UiaOperationAbstraction
                     binding(this);
                 }
 
-                auto result = delegator->Execute();
+                auto result = m_deadline ? ExecuteWithDeadline(*delegator) : delegator->Execute();
 
                 status = result.Status();
                 extendedError = result.ExtendedError();
@@ -2391,6 +2713,22 @@ namespace UiaOperationAbstraction
         return {status, extendedError};
     }
 
+    winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultSet UiaOperationScope::ExecuteWithDeadline(UiaOperationDelegator& delegator)
+    {
+        // The execution is abandoned if the deadline passes, so it holds on to nothing but the remote operation. The
+        // delegator stays with this scope, out of reach of a thread that may still be running.
+        auto remoteOperation = delegator.PrepareToExecute();
+        try
+        {
+            return RunWithDeadline([remoteOperation]() { return remoteOperation.Execute(); }, *m_deadline);
+        }
+        catch (const DeadlineExceededException&)
+        {
+            m_deadlineExceeded = true;
+            throw;
+        }
+    }
+
     UiaOperationScope UiaOperationScope::StartNew()
     {
         s_scopeContextManager.Get().PushContext();
@@ -2417,9 +2755,11 @@ namespace UiaOperationAbstraction
         return UiaOperationScope(true /* ownContext */);
     }
 
+#ifndef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
     bool ShouldUseRemoteApi()
     {
         auto delegator = UiaOperationScope::GetCurrentDelegator();
         return delegator && delegator->GetUseRemoteApi();
     }
+#endif
 } // namespace UiaOperationAbstraction
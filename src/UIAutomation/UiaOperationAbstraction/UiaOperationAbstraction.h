@@ -4,10 +4,19 @@
 #pragma once
 
 #include <variant>
+#include <map>
 #include <memory>
 #include <optional>
 #include <functional>
 #include <sstream>
+#include <string_view>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <combaseapi.h>
 #include <UIAutomation.h>
@@ -25,6 +34,11 @@
 //
 // The user can switch between the two modes simply by setting a bool value indicating whether to use remote operations
 // or not.
+//
+// Programs that never use remote operations can define UIA_OPERATION_ABSTRACTION_LOCAL_ONLY for the whole build. The
+// mode checks then become compile-time constants, so the remote code paths compile away and no remote operation is
+// created per scope, while the API stays the same. Requesting remote operations in such a build fails. The
+// LocalOnlyTests project builds the abstraction this way.
 namespace UiaOperationAbstraction
 {
     using unique_safearray = wil::unique_any<SAFEARRAY*, decltype(&::SafeArrayDestroy), ::SafeArrayDestroy>;
@@ -43,7 +57,8 @@ namespace UiaOperationAbstraction
     template <typename StandinT>
     using CastFuncType = StandinT (winrt::Microsoft::UI::UIAutomation::AutomationRemoteAnyObject::*)() const;
 
-    // This function must be called before using the abstraction.
+    // This function must be called before using the abstraction. useRemoteOperations must be false in builds that
+    // define UIA_OPERATION_ABSTRACTION_LOCAL_ONLY.
     void Initialize(bool useRemoteOperations, _In_ IUIAutomation* automation) noexcept;
 
     // This function must be called before process shutdown.
@@ -99,6 +114,111 @@ namespace UiaOperationAbstraction
         }
     };
 
+    // Thrown when a deadline passes before the operation it applies to has completed. The code is always
+    // HRESULT_FROM_WIN32(ERROR_TIMEOUT).
+    class DeadlineExceededException: public winrt::hresult_error {
+        public:
+        DeadlineExceededException(): winrt::hresult_error(HRESULT_FROM_WIN32(ERROR_TIMEOUT))
+        {
+        }
+    };
+
+    // Runs `work` on a separate thread and waits for it until `deadline`. If the deadline passes first, this
+    // throws DeadlineExceededException without waiting any longer. The abandoned work keeps running in the
+    // background until it returns, and its result (or exception) is discarded. If the deadline has already
+    // passed, `work` is never started.
+    //
+    // Anything `work` captures by reference must outlive it even if the deadline passes, so prefer capturing
+    // by value (e.g. shared_ptrs) for work that might be abandoned.
+    template <class Work>
+    auto RunWithDeadline(Work work, std::chrono::steady_clock::time_point deadline) -> decltype(work())
+    {
+        using Result = decltype(work());
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            throw DeadlineExceededException();
+        }
+
+        auto promise = std::make_shared<std::promise<Result>>();
+        auto future = promise->get_future();
+        std::thread([promise, work = std::move(work)]() mutable
+        {
+            try
+            {
+                auto coInit = wil::CoInitializeEx(COINIT_MULTITHREADED);
+                if constexpr (std::is_void_v<Result>)
+                {
+                    work();
+                    promise->set_value();
+                }
+                else
+                {
+                    promise->set_value(work());
+                }
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        }).detach();
+
+        if (future.wait_until(deadline) != std::future_status::ready)
+        {
+            throw DeadlineExceededException();
+        }
+        return future.get();
+    }
+
+    // Batches the local property reads of a scope that opted in with UiaOperationScope::BatchLocalPropertyReads.
+    //
+    // Each current property read on an element is served from a cache built for that element with a single
+    // BuildUpdatedCache call, whose cache request holds every property the batch has seen so far. So once the set
+    // of properties has been learned from the first element, reading any number of them from each further element
+    // costs one cross-process call rather than one per property. The first element gets no saving: each property it
+    // reads that the batch hasn't seen yet costs a build of its own, unless the properties were passed to
+    // UiaOperationScope::BatchLocalPropertyReads up front. The values are those of when the element's cache was
+    // built, so reads within the scope won't observe changes made in the meantime. An element whose cache can't be
+    // built is read directly from then on. Only the property getters of UiaElement are batched; GetPropertyValue
+    // still reads from the provider directly.
+    class UiaLocalPropertyBatch
+    {
+    public:
+        // Adds a property to the cache requests ahead of its first read, e.g. so that the first element doesn't
+        // need a cache built for each newly seen property.
+        void AddProperty(PROPERTYID propertyId);
+
+        // Returns an element whose cache holds the given property, or null if the cache couldn't be built, in which
+        // case the property should be read directly.
+        winrt::com_ptr<IUIAutomationElement> GetCachedElement(const winrt::com_ptr<IUIAutomationElement>& element, PROPERTYID propertyId);
+
+        // The number of BuildUpdatedCache calls made, i.e. the cross-process calls spent on property reads.
+        uint64_t GetBuildCount() const
+        {
+            return m_buildCount;
+        }
+
+    private:
+        struct CachedElement
+        {
+            // Holds the element that the entry is keyed on, so that its address isn't reused while the entry lives.
+            winrt::com_ptr<IUIAutomationElement> element;
+            winrt::com_ptr<IUIAutomationElement> cachedElement;
+            // Properties are only ever appended, so the cache holds those before this index.
+            size_t propertyCount = 0;
+            // Whether building the cache failed, in which case the element is read directly.
+            bool failed = false;
+        };
+
+        // The number of elements remembered before they're all forgotten, which bounds what the batch holds on to.
+        // Elements are typically read one after another, so this rarely costs a rebuild.
+        static constexpr size_t c_maxCachedElements = 256;
+
+        std::vector<PROPERTYID> m_properties;
+        std::map<IUIAutomationElement*, CachedElement> m_elements;
+        uint64_t m_buildCount = 0;
+    };
+
     class UiaFailure
     {
     public:
@@ -150,7 +270,10 @@ namespace UiaOperationAbstraction
         UiaOperationDelegator();
         UiaOperationDelegator(bool useRemoteApi);
 
-        bool GetUseRemoteApi() const;
+        bool GetUseRemoteApi() const
+        {
+            return m_useRemoteApi;
+        }
 
         // Returns whether the given opcode is supported in the current remote
         // operation connection if remote, returns true if local. Throws E_FAIL
@@ -378,13 +501,97 @@ namespace UiaOperationAbstraction
 
         void AbortOperationWithHresult(HRESULT hr);
 
+        // Opts the remote operation in to sharing results with byte-identical operations through the given
+        // cache. This has no effect on local operations.
+        void UseResultCache(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultCache& cache)
+        {
+            if (m_useRemoteApi)
+            {
+                m_remoteOperation.UseResultCache(cache);
+            }
+        }
+
+        // Opts the remote operation in to emitting the identifier lookups that the given cache already knows as
+        // constants. This has no effect on local operations.
+        void UseIdentifierCache(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteIdentifierCache& cache)
+        {
+            if (m_useRemoteApi)
+            {
+                m_remoteOperation.UseIdentifierCache(cache);
+            }
+        }
+
+        // Records the remote operation when it executes. Results that can't be recorded, such as elements, don't fail
+        // the operation; replaying its record fails with E_NOTIMPL instead. This has no effect on local operations.
+        void UseRecorder(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationRecorder& recorder)
+        {
+            if (m_useRemoteApi)
+            {
+                m_remoteOperation.UseRecorder(recorder);
+            }
+        }
+
+        // Serves the remote operation's results from a recording instead of executing it. Must be called before
+        // anything is bound into the operation. This has no effect on local operations.
+        void UseReplayer(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationReplayer& replayer)
+        {
+            if (m_useRemoteApi)
+            {
+                m_remoteOperation.UseReplayer(replayer);
+            }
+        }
+
+        // Keeps the remote operation from merging adjacent loops over the same array, so that it executes them as
+        // they were built. This has no effect on local operations, which never merge loops.
+        void DisableLoopFusion()
+        {
+            if (m_useRemoteApi)
+            {
+                m_remoteOperation.IsLoopFusionEnabled(false);
+            }
+        }
+
+        // Opts local property reads in to being batched per element, starting with the given properties. See
+        // UiaLocalPropertyBatch. This has no effect on remote operations, which already read all of their
+        // properties in one call.
+        void BatchLocalPropertyReads(const std::vector<PROPERTYID>& properties = {})
+        {
+            if (!m_useRemoteApi)
+            {
+                if (!m_localPropertyBatch)
+                {
+                    m_localPropertyBatch = std::make_shared<UiaLocalPropertyBatch>();
+                }
+
+                for (const auto propertyId : properties)
+                {
+                    m_localPropertyBatch->AddProperty(propertyId);
+                }
+            }
+        }
+
+        // Returns null unless local property reads are being batched.
+        UiaLocalPropertyBatch* GetLocalPropertyBatch() const
+        {
+            return m_localPropertyBatch.get();
+        }
+
         winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultSet Execute()
+        {
+            return PrepareToExecute().Execute();
+        }
+
+        // Does everything Execute does on the delegator and returns the remote operation to execute, so that it can
+        // be executed without going through the delegator again, e.g. on a thread that may be abandoned.
+        winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperation PrepareToExecute()
         {
             // At this point, the remote operation is complete, so we no longer want to create stand-ins,
             // e.g. when creating local wrappers while converting an array result.
+#ifndef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
             m_useRemoteApi = false;
+#endif
 
-            return m_remoteOperation.Execute();
+            return m_remoteOperation;
         }
 
         template<class Type>
@@ -503,8 +710,13 @@ namespace UiaOperationAbstraction
         }
 
     private:
+#ifdef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
+        static constexpr bool m_useRemoteApi = false;
+#else
         bool m_useRemoteApi;
+#endif
         winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperation m_remoteOperation;
+        std::shared_ptr<UiaLocalPropertyBatch> m_localPropertyBatch;
 
         // This method is deleted because of the risk of passing an expression that should be a block.
         // See above for why that's a problem.
@@ -1058,6 +1270,10 @@ namespace UiaOperationAbstraction
         UiaUint Length() const;
         UiaChar At(UiaUint index);
 
+        // Returns a new string; neither operand is modified. Each call copies both operands, so prefer
+        // UiaStringBuilder when joining many fragments.
+        UiaString Concat(const UiaString& rhs) const;
+
         UiaString Stringify();
 
         void FromRemoteResult(const winrt::Windows::Foundation::IInspectable& result);
@@ -1269,6 +1485,9 @@ namespace UiaOperationAbstraction
         template <>
         std::vector<winrt::Windows::Foundation::Rect> ConvertSafeArray<UiaRect>(unique_safearray&& array);
 
+        template <>
+        std::vector<winrt::Windows::Foundation::Point> ConvertSafeArray<UiaPoint>(unique_safearray&& array);
+
         template <class ItemWrapperType, class ArrayInterfaceType>
         std::vector<typename ItemWrapperType::LocalType> ConvertUiaObjectArray(_In_ ArrayInterfaceType* array)
         {
@@ -1288,6 +1507,146 @@ namespace UiaOperationAbstraction
             return result;
         }
 
+        // Returns the out parameter through which a COM getter fills in the given value.
+        template <class T>
+        auto PutOutParam(T& value)
+        {
+            return &value;
+        }
+
+        template <class T>
+        T** PutOutParam(winrt::com_ptr<T>& value)
+        {
+            return value.put();
+        }
+
+        // Returns the batch of the current scope if it batches local property reads. Otherwise, returns null.
+        UiaLocalPropertyBatch* GetCurrentLocalPropertyBatch();
+
+        // The current getters of the element properties, with the IDs of the properties they read, for the getters
+        // that GetComProperty serves from a UiaLocalPropertyBatch.
+        inline const auto c_elementPropertyGetters = std::make_tuple(
+            std::make_pair(&IUIAutomationElement::get_CurrentProcessId, UIA_ProcessIdPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentControlType, UIA_ControlTypePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentLocalizedControlType, UIA_LocalizedControlTypePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentName, UIA_NamePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentAcceleratorKey, UIA_AcceleratorKeyPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentAccessKey, UIA_AccessKeyPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentHasKeyboardFocus, UIA_HasKeyboardFocusPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsKeyboardFocusable, UIA_IsKeyboardFocusablePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsEnabled, UIA_IsEnabledPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentAutomationId, UIA_AutomationIdPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentClassName, UIA_ClassNamePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentHelpText, UIA_HelpTextPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentCulture, UIA_CulturePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsControlElement, UIA_IsControlElementPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsContentElement, UIA_IsContentElementPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsPassword, UIA_IsPasswordPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentNativeWindowHandle, UIA_NativeWindowHandlePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentItemType, UIA_ItemTypePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsOffscreen, UIA_IsOffscreenPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentOrientation, UIA_OrientationPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentFrameworkId, UIA_FrameworkIdPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsRequiredForForm, UIA_IsRequiredForFormPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentItemStatus, UIA_ItemStatusPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentBoundingRectangle, UIA_BoundingRectanglePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentLabeledBy, UIA_LabeledByPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentAriaRole, UIA_AriaRolePropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentAriaProperties, UIA_AriaPropertiesPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentIsDataValidForForm, UIA_IsDataValidForFormPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentControllerFor, UIA_ControllerForPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentDescribedBy, UIA_DescribedByPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentFlowsTo, UIA_FlowsToPropertyId),
+            std::make_pair(&IUIAutomationElement::get_CurrentProviderDescription, UIA_ProviderDescriptionPropertyId),
+            std::make_pair(&IUIAutomationElement2::get_CurrentOptimizeForVisualContent, UIA_OptimizeForVisualContentPropertyId),
+            std::make_pair(&IUIAutomationElement2::get_CurrentLiveSetting, UIA_LiveSettingPropertyId),
+            std::make_pair(&IUIAutomationElement2::get_CurrentFlowsFrom, UIA_FlowsFromPropertyId),
+            std::make_pair(&IUIAutomationElement3::get_CurrentIsPeripheral, UIA_IsPeripheralPropertyId),
+            std::make_pair(&IUIAutomationElement4::get_CurrentPositionInSet, UIA_PositionInSetPropertyId),
+            std::make_pair(&IUIAutomationElement4::get_CurrentSizeOfSet, UIA_SizeOfSetPropertyId),
+            std::make_pair(&IUIAutomationElement4::get_CurrentLevel, UIA_LevelPropertyId),
+            std::make_pair(&IUIAutomationElement4::get_CurrentAnnotationTypes, UIA_AnnotationTypesPropertyId),
+            std::make_pair(&IUIAutomationElement4::get_CurrentAnnotationObjects, UIA_AnnotationObjectsPropertyId),
+            std::make_pair(&IUIAutomationElement5::get_CurrentLandmarkType, UIA_LandmarkTypePropertyId),
+            std::make_pair(&IUIAutomationElement5::get_CurrentLocalizedLandmarkType, UIA_LocalizedLandmarkTypePropertyId),
+            std::make_pair(&IUIAutomationElement6::get_CurrentFullDescription, UIA_FullDescriptionPropertyId),
+            std::make_pair(&IUIAutomationElement8::get_CurrentHeadingLevel, UIA_HeadingLevelPropertyId),
+            std::make_pair(&IUIAutomationElement9::get_CurrentIsDialog, UIA_IsDialogPropertyId));
+
+        // Returns the ID of the element property that the given current getter reads, or 0 if it isn't known.
+        template <class Getter>
+        PROPERTYID GetElementPropertyId(Getter currentGetter)
+        {
+            return std::apply([currentGetter](const auto&... entries)
+            {
+                PROPERTYID propertyId = 0;
+                ([&](const auto& entry)
+                {
+                    // Only getters of the same type can be compared, and there are few of each.
+                    if constexpr (std::is_same_v<std::decay_t<decltype(entry.first)>, Getter>)
+                    {
+                        if (entry.first == currentGetter)
+                        {
+                            propertyId = entry.second;
+                        }
+                    }
+                }(entries), ...);
+                return propertyId;
+            }, c_elementPropertyGetters);
+        }
+
+        // The local half of the generated property getters, shared by every getter that returns the same type from
+        // the same interface. Calls the cached or current getter, querying for the interface that declares it if
+        // the object doesn't already implement it. Current element properties are served from the element's cache
+        // instead when the scope batches local property reads.
+        template <class LocalType, class ComInterface, class ComObject, class OutParamType>
+        LocalType GetComProperty(
+            const winrt::com_ptr<ComObject>& object,
+            bool useCachedApi,
+            HRESULT (STDMETHODCALLTYPE ComInterface::*cachedGetter)(OutParamType),
+            HRESULT (STDMETHODCALLTYPE ComInterface::*currentGetter)(OutParamType))
+        {
+            if constexpr (std::is_same_v<ComObject, IUIAutomationElement>)
+            {
+                if (!useCachedApi && object)
+                {
+                    if (const auto batch = GetCurrentLocalPropertyBatch())
+                    {
+                        if (const auto propertyId = GetElementPropertyId(currentGetter))
+                        {
+                            if (const auto cachedElement = batch->GetCachedElement(object, propertyId))
+                            {
+                                return GetComProperty<LocalType>(cachedElement, true /* useCachedApi */, cachedGetter, currentGetter);
+                            }
+                        }
+                    }
+                }
+            }
+
+            const auto getter = useCachedApi ? cachedGetter : currentGetter;
+
+            LocalType value{};
+            if constexpr (std::is_base_of_v<ComInterface, ComObject>)
+            {
+                winrt::check_hresult((object.get()->*getter)(PutOutParam(value)));
+            }
+            else
+            {
+                winrt::check_hresult((object.template as<ComInterface>().get()->*getter)(PutOutParam(value)));
+            }
+
+            return value;
+        }
+
+        // The local half of the generated pattern getters, shared by all patterns. Pass IID_PPV_ARGS of the
+        // pattern's com_ptr for the last two arguments.
+        void GetComPattern(
+            const winrt::com_ptr<IUIAutomationElement>& element,
+            bool useCachedApi,
+            PATTERNID patternId,
+            REFIID patternInterfaceId,
+            _COM_Outptr_ void** pattern);
+
         // Each of these helpers is an overload which populates the cache(s)
         // for its first argument. The one which takes a single element will
         // populate the cache just for that element, while the one which takes
@@ -2228,6 +2587,47 @@ namespace UiaOperationAbstraction
         void FromRemoteResult(const winrt::Windows::Foundation::IInspectable& result);
     };
 
+    // Holds an array of strings as one contiguous buffer of characters plus the offset of each string within it.
+    //
+    // Resolving a UiaArray<UiaString> allocates a BSTR for every item, so an array of thousands of names costs
+    // thousands of allocations scattered across the heap. Decoding into a table instead costs a few allocations
+    // overall, and reading the strings back walks a single buffer. Use UiaOperationScope::BindStringTableResult to
+    // resolve an array into a table.
+    class UiaStringTable
+    {
+    public:
+        UiaStringTable() = default;
+
+        size_t Size() const { return m_isNull.size(); }
+        size_t GetCharacterCount() const { return m_characters.size(); }
+
+        // The view is valid until the table is next modified. Null strings read as empty.
+        std::wstring_view operator[](size_t index) const
+        {
+            return std::wstring_view(m_characters).substr(m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+        }
+
+        bool IsNull(size_t index) const { return m_isNull[index]; }
+
+        void Reserve(size_t stringCount, size_t characterCount);
+        void Append(std::wstring_view value);
+        void AppendNull();
+        void Clear();
+
+        // Each of these replaces the contents of the table. They decode the strings in a single pass, straight
+        // into the table's buffer.
+        void FromRemoteResult(const winrt::Windows::Foundation::IInspectable& result);
+        // Takes ownership of a SAFEARRAY of BSTRs, as returned by the COM API.
+        void FromSafeArray(unique_safearray&& array);
+        void FromLocalArray(const std::vector<UiaString::LocalType>& strings);
+
+    private:
+        std::wstring m_characters;
+        // One more than there are strings: string i spans from offset i up to offset i + 1.
+        std::vector<size_t> m_offsets{ 0 };
+        std::vector<bool> m_isNull;
+    };
+
 
 #include "UiaTypeAbstraction.g.h"
 
@@ -2461,6 +2861,36 @@ namespace UiaOperationAbstraction
             // In all other cases (strictly local operation, nested remote operation) bind is a no-op.
         }
 
+        // Binds an array of strings so that it resolves into the given table rather than into the array itself,
+        // which is left unresolved. A local operation has already run by the time it's bound, so the table is filled
+        // from the array right away; bind it once the array is complete, as with any other result.
+        //
+        // Unlike BindResult, this throws E_ILLEGAL_METHOD_CALL in a nested remote operation instead of doing nothing:
+        // the array never resolves, so the table would silently stay empty. Return the array to the outermost scope
+        // and bind it there.
+        void BindStringTableResult(UiaArray<UiaString>& array, UiaStringTable& table)
+        {
+            auto delegator = GetCurrentDelegator();
+            if (!delegator->GetUseRemoteApi())
+            {
+                table.FromLocalArray(*array);
+            }
+            else
+            {
+                THROW_HR_IF(E_ILLEGAL_METHOD_CALL, !m_ownContext);
+
+                array.ToRemote();
+                auto token = delegator->RequestResponse(static_cast<UiaArray<UiaString>::RemoteType>(array));
+
+                remoteOperationResolvers.emplace_back(
+                    [token, &table](winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultSet& result)
+                    {
+                        table.FromRemoteResult(result.GetResult(token));
+                    }
+                );
+            }
+        }
+
         // BindNonlocalResult is used to bind results that are not local in scope. The binding will be
         // deferred until just before the outermost remote operation is executed, and will execute as a
         // local binding in that operation's scope.
@@ -2482,6 +2912,24 @@ namespace UiaOperationAbstraction
         void Resolve();
         HRESULT ResolveHr() noexcept;
 
+        // Sets a deadline for resolving this scope. If the remote operation hasn't completed by then, Resolve
+        // throws DeadlineExceededException (and ResolveHr returns its code) right away. The blocked execution is
+        // abandoned rather than waited for, and none of the bound results are resolved, so they must not be read.
+        // This has no effect on local scopes, since local operations run as they are built.
+        //
+        // A scope whose deadline has passed is poisoned: the abandoned execution may still be running its remote
+        // operation, so neither the scope nor anything built in it can be used again. Resolving it again throws
+        // DeadlineExceededException once more. Let it go out of scope and start a new one.
+        void SetDeadline(std::chrono::steady_clock::time_point deadline)
+        {
+            m_deadline = deadline;
+        }
+
+        void SetTimeout(std::chrono::milliseconds timeout)
+        {
+            SetDeadline(std::chrono::steady_clock::now() + timeout);
+        }
+
         template<class Operation>
         inline void CompileOrRun(Operation&& operation)
         {
@@ -2607,6 +3055,41 @@ namespace UiaOperationAbstraction
             GetCurrentDelegator()->AbortOperationWithHresult(hr);
         }
 
+        inline void UseResultCache(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultCache& cache)
+        {
+            GetCurrentDelegator()->UseResultCache(cache);
+        }
+
+        inline void UseIdentifierCache(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteIdentifierCache& cache)
+        {
+            GetCurrentDelegator()->UseIdentifierCache(cache);
+        }
+
+        inline void UseRecorder(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationRecorder& recorder)
+        {
+            GetCurrentDelegator()->UseRecorder(recorder);
+        }
+
+        inline void UseReplayer(const winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationReplayer& replayer)
+        {
+            GetCurrentDelegator()->UseReplayer(replayer);
+        }
+
+        inline void DisableLoopFusion()
+        {
+            GetCurrentDelegator()->DisableLoopFusion();
+        }
+
+        inline void BatchLocalPropertyReads(const std::vector<PROPERTYID>& properties = {})
+        {
+            GetCurrentDelegator()->BatchLocalPropertyReads(properties);
+        }
+
+        inline UiaLocalPropertyBatch* GetLocalPropertyBatch() const
+        {
+            return GetCurrentDelegator()->GetLocalPropertyBatch();
+        }
+
         // StartNew creates a new remote execution context, regardless of whether there's an existing one.
         // If there is an existing one, it is suspended while this new scope exists and resumes when this
         // scope is resolved or destroyed.
@@ -2643,6 +3126,9 @@ namespace UiaOperationAbstraction
 
         bool m_ownContext = false;
 
+        std::optional<std::chrono::steady_clock::time_point> m_deadline;
+        bool m_deadlineExceeded = false;
+
         std::vector<Resolver> remoteOperationResolvers;
 
         // This method is deleted because of the risk of passing an expression that should be a block.
@@ -2651,8 +3137,49 @@ namespace UiaOperationAbstraction
         void While(UiaBool&&, Body body) = delete;
 
         std::pair<winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus, HRESULT> ResolveInternal();
+        winrt::Microsoft::UI::UIAutomation::AutomationRemoteOperationResultSet ExecuteWithDeadline(UiaOperationDelegator& delegator);
 
     };
 
+#ifdef UIA_OPERATION_ABSTRACTION_LOCAL_ONLY
+    constexpr bool ShouldUseRemoteApi()
+    {
+        return false;
+    }
+#else
     bool ShouldUseRemoteApi();
+#endif
+
+    // Returns the children of the element in the raw view. Walking them one sibling at a time costs a cross-process
+    // call per child when running locally, so locally they are all fetched with a single FindAll call instead, along
+    // with the properties and patterns in the cache request, if one is given.
+    UiaArray<UiaElement> GetChildElements(UiaElement element, std::optional<UiaCacheRequest> cacheRequest = std::nullopt);
+
+    // Calls the body with each child of the element in the raw view, in order. Remotely, the siblings are walked
+    // within the operation; locally, the children are fetched with GetChildElements. The local walk is a plain loop,
+    // so the body mustn't call Break or Continue.
+    template <class Body>
+    void ForEachChildElement(UiaElement element, Body body, std::optional<UiaCacheRequest> cacheRequest = std::nullopt)
+    {
+        if (ShouldUseRemoteApi())
+        {
+            UiaElement child = element.GetFirstChildElement(cacheRequest);
+            UiaOperationScope::GetCurrentDelegator()->While([&]()
+            {
+                return !child.IsNull();
+            },
+            [&]()
+            {
+                body(child);
+                child = child.GetNextSiblingElement(cacheRequest);
+            });
+            return;
+        }
+
+        const auto children = GetChildElements(element, cacheRequest);
+        for (const auto& localChild : *children)
+        {
+            body(UiaElement(localChild));
+        }
+    }
 };
@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "UiaOperationBatcher.h"
+
+namespace UiaOperationAbstraction
+{
+    UiaOperationBatcher::ConnectionQueue::~ConnectionQueue()
+    {
+        // Anything still queued here was never picked up by a leader; break the promises so waiters don't hang.
+        for (auto& operation : DetachAll())
+        {
+            operation->completion.set_exception(std::make_exception_ptr(winrt::hresult_error(E_ABORT)));
+        }
+    }
+
+    void UiaOperationBatcher::ConnectionQueue::Push(_In_ PendingOperation* operation)
+    {
+        operation->next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(operation->next, operation, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::vector<std::unique_ptr<UiaOperationBatcher::PendingOperation>> UiaOperationBatcher::ConnectionQueue::DetachAll()
+    {
+        std::vector<std::unique_ptr<PendingOperation>> operations;
+        for (auto operation = m_head.exchange(nullptr, std::memory_order_acquire); operation; )
+        {
+            auto next = operation->next;
+            operations.emplace_back(operation);
+            operation = next;
+        }
+
+        // The stack hands items back newest first.
+        std::reverse(operations.begin(), operations.end());
+        return operations;
+    }
+
+    UiaOperationBatcher::UiaOperationBatcher() :
+        UiaOperationBatcher(Options{})
+    {
+    }
+
+    UiaOperationBatcher::UiaOperationBatcher(Options options, BatchExecutor executor) :
+        m_options(options),
+        m_executor(std::move(executor))
+    {
+        THROW_HR_IF(E_INVALIDARG, m_options.maxBatchSize == 0);
+        THROW_HR_IF(E_INVALIDARG, !m_executor);
+    }
+
+    std::future<void> UiaOperationBatcher::Submit(uint64_t connectionId, BatchedOperation operation)
+    {
+        auto& queue = GetQueue(connectionId);
+
+        auto pending = std::make_unique<PendingOperation>();
+        pending->body = std::move(operation);
+        pending->enqueueTime = std::chrono::steady_clock::now();
+        auto future = pending->completion.get_future();
+        queue.Push(pending.release());
+
+        // The first submitter to find the connection idle becomes the consumer for this round.
+        if (!queue.draining.exchange(true, std::memory_order_acq_rel))
+        {
+            std::this_thread::sleep_for(m_options.coalescingWindow);
+            Drain(queue);
+        }
+
+        return future;
+    }
+
+    UiaOperationBatcher::ConnectionQueue& UiaOperationBatcher::GetQueue(uint64_t connectionId)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_queuesLock);
+            auto it = m_queues.find(connectionId);
+            if (it != m_queues.end())
+            {
+                return *it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_queuesLock);
+        auto& queue = m_queues[connectionId];
+        if (!queue)
+        {
+            queue = std::make_unique<ConnectionQueue>();
+        }
+        return *queue;
+    }
+
+    void UiaOperationBatcher::Drain(ConnectionQueue& queue)
+    {
+        do
+        {
+            auto operations = queue.DetachAll();
+            for (auto begin = operations.begin(); begin != operations.end(); )
+            {
+                const auto count = std::min<size_t>(m_options.maxBatchSize, std::distance(begin, operations.end()));
+                const auto end = begin + count;
+                ExecuteBatch(begin, end);
+                begin = end;
+            }
+
+            queue.draining.store(false, std::memory_order_release);
+
+            // An operation may have been pushed after we detached but before we released the queue, in which case
+            // its submitter saw us still draining and is relying on us to pick it up.
+        } while (!queue.IsEmpty() && !queue.draining.exchange(true, std::memory_order_acq_rel));
+    }
+
+    void UiaOperationBatcher::ExecuteBatch(
+        std::vector<std::unique_ptr<PendingOperation>>::iterator begin,
+        std::vector<std::unique_ptr<PendingOperation>>::iterator end)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<BatchedOperation> batch;
+        batch.reserve(std::distance(begin, end));
+        std::chrono::microseconds totalLatency{ 0 };
+        std::chrono::microseconds maxLatency{ 0 };
+        for (auto it = begin; it != end; ++it)
+        {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(start - (*it)->enqueueTime);
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+            batch.emplace_back(std::move((*it)->body));
+        }
+        RecordBatch(batch.size(), totalLatency, maxLatency);
+
+        std::vector<HRESULT> results;
+        try
+        {
+            results = m_executor(batch);
+            THROW_HR_IF(E_UNEXPECTED, results.size() != batch.size());
+        }
+        catch (...)
+        {
+            results.assign(batch.size(), wil::ResultFromCaughtException());
+        }
+
+        auto result = results.begin();
+        for (auto it = begin; it != end; ++it, ++result)
+        {
+            if (SUCCEEDED(*result))
+            {
+                (*it)->completion.set_value();
+            }
+            else
+            {
+                (*it)->completion.set_exception(std::make_exception_ptr(winrt::hresult_error(*result)));
+            }
+        }
+    }
+
+    void UiaOperationBatcher::RecordBatch(size_t batchSize, std::chrono::microseconds totalLatency, std::chrono::microseconds maxLatency)
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        m_metrics.batchCount += 1;
+        m_metrics.operationCount += batchSize;
+
+        auto& statistics = m_metrics.statisticsByBatchSize[batchSize];
+        statistics.batchCount += 1;
+        statistics.operationCount += batchSize;
+        statistics.totalQueueLatency += totalLatency;
+        statistics.maxQueueLatency = std::max(statistics.maxQueueLatency, maxLatency);
+    }
+
+    UiaBatchMetrics UiaOperationBatcher::GetMetrics() const
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        return m_metrics;
+    }
+
+    void UiaOperationBatcher::ResetMetrics()
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        m_metrics = {};
+    }
+
+    /* static */ std::vector<HRESULT> UiaOperationBatcher::ExecuteBatchInScope(const std::vector<BatchedOperation>& batch)
+    {
+        auto scope = UiaOperationScope::StartNew();
+
+        std::vector<UiaInt> failureCodes;
+        failureCodes.reserve(batch.size());
+        for (const auto& operation : batch)
+        {
+            auto& failureCode = failureCodes.emplace_back(S_OK);
+
+            // Make the failure code remote outside of the try block, so that it is initialized even if the catch
+            // body never runs.
+            scope.BindInput(failureCode);
+            scope.TryCatch([&]()
+            {
+                operation(scope);
+            },
+            [&](UiaFailure failure)
+            {
+                failureCode = failure.GetCurrentFailureCode();
+            });
+            scope.BindResult(failureCode);
+        }
+
+        const HRESULT batchHr = scope.ResolveHr();
+
+        std::vector<HRESULT> results;
+        results.reserve(failureCodes.size());
+        for (const auto& failureCode : failureCodes)
+        {
+            results.emplace_back(FAILED(batchHr) ? batchHr : static_cast<HRESULT>(static_cast<int>(failureCode)));
+        }
+        return results;
+    }
+
+    /* static */ BatchExecutor UiaOperationBatcher::MakeLatencyInjectingExecutor(
+        std::chrono::microseconds latency,
+        BatchExecutor inner)
+    {
+        return [latency, inner = std::move(inner)](const std::vector<BatchedOperation>& batch)
+        {
+            std::this_thread::sleep_for(latency);
+            return inner(batch);
+        };
+    }
+}
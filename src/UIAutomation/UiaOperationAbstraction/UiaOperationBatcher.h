@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements an opt-in scheduler that coalesces small operations submitted concurrently against the same
+// connection into a single UiaOperationScope, so that they share one cross-process round trip.
+namespace UiaOperationAbstraction
+{
+    // A unit of work submitted to the batcher. The body is invoked inside the batch's scope and should build
+    // its operation and bind its results through the scope it is given. Bound values are written before the
+    // future returned by Submit becomes ready, so they must outlive that future.
+    //
+    // Note: sub-operations share a single remote operation, so a body MUST NOT call AbortOperationWithHresult
+    // with a success code, as that would end the operation for every other sub-operation in the batch.
+    using BatchedOperation = std::function<void(UiaOperationScope& scope)>;
+
+    // Executes a batch of operations and returns one HRESULT per operation, in submission order.
+    using BatchExecutor = std::function<std::vector<HRESULT>(const std::vector<BatchedOperation>& batch)>;
+
+    // Aggregated queue latency (time from Submit until the batch containing the operation starts executing)
+    // for all batches of a given size.
+    struct UiaBatchSizeStatistics
+    {
+        uint64_t batchCount = 0;
+        uint64_t operationCount = 0;
+        std::chrono::microseconds totalQueueLatency{ 0 };
+        std::chrono::microseconds maxQueueLatency{ 0 };
+    };
+
+    struct UiaBatchMetrics
+    {
+        uint64_t batchCount = 0;
+        uint64_t operationCount = 0;
+
+        // Keyed by batch size.
+        std::map<size_t, UiaBatchSizeStatistics> statisticsByBatchSize;
+    };
+
+    class UiaOperationBatcher
+    {
+    public:
+        struct Options
+        {
+            // How long the first operation to arrive at an idle connection waits for others to join its batch.
+            std::chrono::microseconds coalescingWindow{ 500 };
+
+            // Upper bound on the number of operations executed in one scope, so that coalescing cannot push a
+            // batch over the remote operation instruction limit. Larger backlogs are split into several batches.
+            size_t maxBatchSize = 64;
+        };
+
+        UiaOperationBatcher();
+        UiaOperationBatcher(Options options, BatchExecutor executor = ExecuteBatchInScope);
+
+        UiaOperationBatcher(const UiaOperationBatcher&) = delete;
+        UiaOperationBatcher& operator=(const UiaOperationBatcher&) = delete;
+
+        // Queues an operation against the given connection (typically the process id of the target provider)
+        // and returns a future that becomes ready once the batch containing it has been resolved. The future
+        // throws winrt::hresult_error if the operation, or the batch as a whole, failed.
+        //
+        // No dedicated thread is used: the caller that finds a connection idle waits out the coalescing window
+        // and then executes queued batches for that connection on its own thread until the queue is empty.
+        std::future<void> Submit(uint64_t connectionId, BatchedOperation operation);
+
+        UiaBatchMetrics GetMetrics() const;
+        void ResetMetrics();
+
+        // The default executor. Builds all operations into one new scope, isolating each in its own try block,
+        // and reports each operation's failure code individually.
+        static std::vector<HRESULT> ExecuteBatchInScope(const std::vector<BatchedOperation>& batch);
+
+        // Returns an executor that sleeps for the given duration before forwarding to `inner`. This stands in
+        // for the cross-process round trip when measuring batching behavior without a live provider.
+        static BatchExecutor MakeLatencyInjectingExecutor(
+            std::chrono::microseconds latency,
+            BatchExecutor inner = ExecuteBatchInScope);
+
+    private:
+        struct PendingOperation
+        {
+            BatchedOperation body;
+            std::promise<void> completion;
+            std::chrono::steady_clock::time_point enqueueTime;
+            PendingOperation* next = nullptr;
+        };
+
+        // A lock-free multiple-producer, single-consumer queue. Producers push onto an intrusive stack and the
+        // single consumer (whichever thread holds `draining`) detaches the whole stack at once and restores
+        // submission order.
+        struct ConnectionQueue
+        {
+            ~ConnectionQueue();
+
+            void Push(_In_ PendingOperation* operation);
+            std::vector<std::unique_ptr<PendingOperation>> DetachAll();
+
+            bool IsEmpty() const
+            {
+                return m_head.load(std::memory_order_acquire) == nullptr;
+            }
+
+            std::atomic<bool> draining{ false };
+
+        private:
+            std::atomic<PendingOperation*> m_head{ nullptr };
+        };
+
+        ConnectionQueue& GetQueue(uint64_t connectionId);
+        void Drain(ConnectionQueue& queue);
+        void ExecuteBatch(std::vector<std::unique_ptr<PendingOperation>>::iterator begin,
+            std::vector<std::unique_ptr<PendingOperation>>::iterator end);
+        void RecordBatch(size_t batchSize, std::chrono::microseconds totalLatency, std::chrono::microseconds maxLatency);
+
+        const Options m_options;
+        const BatchExecutor m_executor;
+
+        mutable std::shared_mutex m_queuesLock;
+        std::map<uint64_t, std::unique_ptr<ConnectionQueue>> m_queues;
+
+        mutable std::mutex m_metricsLock;
+        UiaBatchMetrics m_metrics;
+    };
+}
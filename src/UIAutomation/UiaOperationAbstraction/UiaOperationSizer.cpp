@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "UiaOperationSizer.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        // How much of the learned instruction budget an operation may use. Estimates are only estimates, so
+        // sizing right up to the budget would hit the limit about half the time.
+        constexpr double c_budgetMargin = 0.9;
+
+        // How much each new estimate moves the average instructions per item.
+        constexpr double c_instructionsPerItemWeight = 0.2;
+    }
+
+    UiaOperationSizer::UiaOperationSizer() :
+        UiaOperationSizer(Options{})
+    {
+    }
+
+    UiaOperationSizer::UiaOperationSizer(Options options) :
+        m_options(options)
+    {
+        THROW_HR_IF(E_INVALIDARG,
+            m_options.minSize == 0 ||
+            m_options.minSize > m_options.maxSize ||
+            m_options.decreaseFactor <= 0.0 ||
+            m_options.decreaseFactor >= 1.0);
+    }
+
+    uint32_t UiaOperationSizer::GetSize(uint64_t connectionId)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return GetBudgetedSize(GetState(connectionId));
+    }
+
+    void UiaOperationSizer::Record(
+        uint64_t connectionId,
+        uint32_t size,
+        winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus status,
+        std::optional<uint64_t> estimatedInstructions)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto& state = GetState(connectionId);
+
+        if (estimatedInstructions && size > 0)
+        {
+            const auto sample = static_cast<double>(*estimatedInstructions) / size;
+            state.instructionsPerItem = (state.instructionsPerItem == 0.0) ?
+                sample :
+                state.instructionsPerItem + c_instructionsPerItemWeight * (sample - state.instructionsPerItem);
+        }
+
+        switch (status)
+        {
+        case winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::Success:
+        {
+            ++state.successCount;
+            state.largestSucceededSize = std::max(state.largestSucceededSize, size);
+
+            // The provider allowed more than the budget we had learned, so the estimates were off or the limit
+            // went up. Either way, the budget no longer holds.
+            if (estimatedInstructions && state.instructionBudget != 0 && *estimatedInstructions >= state.instructionBudget)
+            {
+                state.instructionBudget = 0;
+            }
+
+            // Operations capped by the budget don't show that the uncapped size would work.
+            if (size >= state.size)
+            {
+                const uint64_t grown = (state.size < state.threshold) ?
+                    std::min<uint64_t>(static_cast<uint64_t>(state.size) * 2, state.threshold) :
+                    static_cast<uint64_t>(state.size) + m_options.additiveIncrease;
+                state.size = static_cast<uint32_t>(std::min<uint64_t>(grown, m_options.maxSize));
+            }
+            break;
+        }
+
+        case winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus::InstructionLimitExceeded:
+        {
+            ++state.limitExceededCount;
+            state.smallestLimitExceededSize = (state.smallestLimitExceededSize == 0) ?
+                size :
+                std::min(state.smallestLimitExceededSize, size);
+
+            if (estimatedInstructions)
+            {
+                state.instructionBudget = (state.instructionBudget == 0) ?
+                    *estimatedInstructions :
+                    std::min(state.instructionBudget, *estimatedInstructions);
+            }
+
+            // Operations that were started before an earlier cut fail at sizes above the current one. The cut
+            // already accounted for them, so only cut again for operations at or below the current size.
+            if (size <= state.size)
+            {
+                const auto reduced = static_cast<uint32_t>(std::floor(size * m_options.decreaseFactor));
+                state.size = std::max(reduced, m_options.minSize);
+                state.threshold = state.size;
+            }
+            break;
+        }
+
+        default:
+            ++state.failureCount;
+            break;
+        }
+    }
+
+    std::map<uint64_t, UiaLearnedOperationSize> UiaOperationSizer::GetLearnedSizes() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_connections;
+    }
+
+    void UiaOperationSizer::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_connections.clear();
+    }
+
+    UiaLearnedOperationSize& UiaOperationSizer::GetState(uint64_t connectionId)
+    {
+        auto [it, inserted] = m_connections.try_emplace(connectionId);
+        if (inserted)
+        {
+            it->second.size = std::clamp(m_options.initialSize, m_options.minSize, m_options.maxSize);
+            it->second.threshold = m_options.maxSize;
+        }
+        return it->second;
+    }
+
+    uint32_t UiaOperationSizer::GetBudgetedSize(const UiaLearnedOperationSize& state) const
+    {
+        if (state.instructionBudget == 0 || state.instructionsPerItem <= 0.0)
+        {
+            return state.size;
+        }
+
+        const auto budgetedSize = std::floor(state.instructionBudget * c_budgetMargin / state.instructionsPerItem);
+        if (budgetedSize >= state.size)
+        {
+            return state.size;
+        }
+        return std::max(static_cast<uint32_t>(budgetedSize), m_options.minSize);
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements a controller that learns how much work each provider accepts in a single operation, so that work split
+// into chunks (elements per operation, items per page, etc.) can use chunks as large as each provider allows.
+namespace UiaOperationAbstraction
+{
+    // What the sizer has learned about one connection.
+    struct UiaLearnedOperationSize
+    {
+        // The size that GetSize returns for the connection.
+        uint32_t size = 0;
+        // Below this size, successes double the size; at or above it, they add to it. It's set to the reduced size
+        // whenever an operation hits the instruction limit.
+        uint32_t threshold = 0;
+
+        uint64_t successCount = 0;
+        uint64_t limitExceededCount = 0;
+        // Operations that failed for any other reason, which say nothing about their size.
+        uint64_t failureCount = 0;
+
+        uint32_t largestSucceededSize = 0;
+        // Zero until an operation hits the instruction limit.
+        uint32_t smallestLimitExceededSize = 0;
+
+        // Learned from the instruction estimates given to Record, if any. The average estimated instructions per
+        // item, and the smallest estimate of an operation that hit the limit (zero if unknown).
+        double instructionsPerItem = 0.0;
+        uint64_t instructionBudget = 0;
+    };
+
+    // Chooses the number of items to put in each operation against a connection (typically the process id of the
+    // target provider), based on the outcomes of the operations before it.
+    //
+    // Sizing is AIMD, like TCP congestion control: an operation that hits the instruction limit cuts the size by a
+    // constant factor, and one that succeeds at the full size grows it, by doubling until the first cut and by a
+    // constant step after that. The size settles just under each provider's limit while probing for more now and
+    // then, so limit failures stay rare even if the limit changes.
+    //
+    // When operations come with instruction estimates, the sizer also learns the provider's instruction budget, and
+    // keeps the size below it even for items that cost more than the ones it has seen so far.
+    class UiaOperationSizer
+    {
+    public:
+        struct Options
+        {
+            uint32_t initialSize = 64;
+            uint32_t minSize = 1;
+            uint32_t maxSize = 4096;
+
+            uint32_t additiveIncrease = 1;
+            double decreaseFactor = 0.5;
+        };
+
+        UiaOperationSizer();
+        explicit UiaOperationSizer(Options options);
+
+        UiaOperationSizer(const UiaOperationSizer&) = delete;
+        UiaOperationSizer& operator=(const UiaOperationSizer&) = delete;
+
+        // Returns the number of items to put in the next operation against the connection.
+        uint32_t GetSize(uint64_t connectionId);
+
+        // Records the outcome of an operation with the given number of items. A success only grows the size if
+        // the operation was at least as large as the current size, since smaller ones (such as the last chunk of a
+        // job) don't show that a larger size would work. The estimate, if given, is the number of instructions the
+        // caller expects the operation to execute.
+        void Record(
+            uint64_t connectionId,
+            uint32_t size,
+            winrt::Windows::UI::UIAutomation::Core::AutomationRemoteOperationStatus status,
+            std::optional<uint64_t> estimatedInstructions = std::nullopt);
+
+        // For diagnostics. Keyed by connection.
+        std::map<uint64_t, UiaLearnedOperationSize> GetLearnedSizes() const;
+        void Reset();
+
+    private:
+        UiaLearnedOperationSize& GetState(uint64_t connectionId);
+        uint32_t GetBudgetedSize(const UiaLearnedOperationSize& state) const;
+
+        const Options m_options;
+
+        mutable std::mutex m_lock;
+        std::map<uint64_t, UiaLearnedOperationSize> m_connections;
+    };
+}
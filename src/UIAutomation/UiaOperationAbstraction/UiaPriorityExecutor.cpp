@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "UiaPriorityExecutor.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        std::chrono::microseconds ElapsedSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        }
+
+        std::exception_ptr AbortedException()
+        {
+            return std::make_exception_ptr(winrt::hresult_error(E_ABORT));
+        }
+    }
+
+    // UiaLatencyHistogram
+    void UiaLatencyHistogram::Record(std::chrono::microseconds duration)
+    {
+        auto value = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+        size_t bucket = 0;
+        while (value != 0 && bucket < c_bucketCount - 1)
+        {
+            value >>= 1;
+            ++bucket;
+        }
+
+        ++m_buckets[bucket];
+        ++m_count;
+    }
+
+    std::chrono::microseconds UiaLatencyHistogram::GetPercentile(double percentile) const
+    {
+        if (m_count == 0)
+        {
+            return std::chrono::microseconds{ 0 };
+        }
+
+        const auto target = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * m_count));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < c_bucketCount; ++bucket)
+        {
+            seen += m_buckets[bucket];
+            if (seen >= std::max<uint64_t>(target, 1))
+            {
+                return GetBucketUpperBound(bucket);
+            }
+        }
+        return GetBucketUpperBound(c_bucketCount - 1);
+    }
+
+    /* static */ std::chrono::microseconds UiaLatencyHistogram::GetBucketUpperBound(size_t bucket)
+    {
+        return std::chrono::microseconds{ 1LL << std::min(bucket, c_bucketCount - 1) };
+    }
+
+    // UiaPriorityExecutor
+    UiaPriorityExecutor::~UiaPriorityExecutor()
+    {
+        std::lock_guard<std::mutex> connectionsLock(m_connectionsLock);
+        for (auto& [connectionId, connection] : m_connections)
+        {
+            {
+                std::lock_guard<std::mutex> lock(connection->lock);
+                connection->stopping = true;
+            }
+            connection->workAvailable.notify_all();
+            connection->worker.join();
+
+            // The worker exits without draining, so fail whatever is left rather than leaving callers waiting.
+            for (auto& item : connection->interactive)
+            {
+                item.completion.set_exception(AbortedException());
+            }
+            for (auto& item : connection->background)
+            {
+                item.completion.set_exception(AbortedException());
+            }
+        }
+    }
+
+    std::future<void> UiaPriorityExecutor::SubmitInteractive(uint64_t connectionId, Operation operation)
+    {
+        auto& connection = GetConnection(connectionId);
+
+        InteractiveItem item{ std::move(operation), {}, std::chrono::steady_clock::now() };
+        auto future = item.completion.get_future();
+        {
+            std::lock_guard<std::mutex> lock(connection.lock);
+            connection.interactive.emplace_back(std::move(item));
+        }
+        connection.workAvailable.notify_one();
+        return future;
+    }
+
+    std::future<void> UiaPriorityExecutor::SubmitBackground(uint64_t connectionId, ChunkedOperation operation)
+    {
+        auto& connection = GetConnection(connectionId);
+
+        BackgroundItem item{ std::move(operation), {}, std::chrono::steady_clock::now() };
+        auto future = item.completion.get_future();
+        {
+            std::lock_guard<std::mutex> lock(connection.lock);
+            connection.background.emplace_back(std::move(item));
+        }
+        connection.workAvailable.notify_one();
+        return future;
+    }
+
+    UiaPriorityExecutor::Connection& UiaPriorityExecutor::GetConnection(uint64_t connectionId)
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsLock);
+        auto& connection = m_connections[connectionId];
+        if (!connection)
+        {
+            connection = std::make_unique<Connection>();
+            connection->worker = std::thread([this, rawConnection = connection.get()]()
+            {
+                RunWorker(*rawConnection);
+            });
+        }
+        return *connection;
+    }
+
+    void UiaPriorityExecutor::RunWorker(Connection& connection)
+    {
+        auto coInit = wil::CoInitializeEx(COINIT_MULTITHREADED);
+
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(connection.lock);
+            connection.workAvailable.wait(lock, [&]()
+            {
+                return connection.stopping || !connection.interactive.empty() || !connection.background.empty();
+            });
+
+            if (connection.stopping)
+            {
+                return;
+            }
+
+            // Interactive work always goes first. Background work only ever gets one chunk before we look again,
+            // which bounds how long an interactive operation can wait behind it to a single chunk.
+            if (!connection.interactive.empty())
+            {
+                auto item = std::move(connection.interactive.front());
+                connection.interactive.pop_front();
+                lock.unlock();
+
+                const auto queueWait = ElapsedSince(item.readyTime);
+                const auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    auto scope = UiaOperationScope::StartNew();
+                    scope.CompileOrRun([&]()
+                    {
+                        item.operation(scope);
+                    });
+                    scope.Resolve();
+                    item.completion.set_value();
+                }
+                catch (...)
+                {
+                    item.completion.set_exception(std::current_exception());
+                }
+                Record(UiaOperationPriority::Interactive, queueWait, ElapsedSince(start));
+            }
+            else
+            {
+                auto item = std::move(connection.background.front());
+                connection.background.pop_front();
+                lock.unlock();
+
+                const auto queueWait = ElapsedSince(item.readyTime);
+                const auto start = std::chrono::steady_clock::now();
+                bool moreChunks = false;
+                try
+                {
+                    auto scope = UiaOperationScope::StartNew();
+                    scope.CompileOrRun([&]()
+                    {
+                        moreChunks = item.operation(scope);
+                    });
+                    scope.Resolve();
+                    if (!moreChunks)
+                    {
+                        item.completion.set_value();
+                    }
+                }
+                catch (...)
+                {
+                    moreChunks = false;
+                    item.completion.set_exception(std::current_exception());
+                }
+                Record(UiaOperationPriority::Background, queueWait, ElapsedSince(start));
+
+                if (moreChunks)
+                {
+                    // Requeue at the back so that background operations on the same connection share the lane.
+                    item.readyTime = std::chrono::steady_clock::now();
+                    lock.lock();
+                    connection.background.emplace_back(std::move(item));
+                }
+            }
+        }
+    }
+
+    void UiaPriorityExecutor::Record(UiaOperationPriority priority, std::chrono::microseconds queueWait, std::chrono::microseconds executionTime)
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        auto& lane = (priority == UiaOperationPriority::Interactive) ? m_metrics.interactive : m_metrics.background;
+        lane.queueWait.Record(queueWait);
+        lane.executionTime.Record(executionTime);
+    }
+
+    UiaPriorityExecutorMetrics UiaPriorityExecutor::GetMetrics() const
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        return m_metrics;
+    }
+
+    void UiaPriorityExecutor::ResetMetrics()
+    {
+        std::lock_guard<std::mutex> lock(m_metricsLock);
+        m_metrics = {};
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements an executor that serializes operations per connection while letting latency-sensitive interactive
+// operations run ahead of long background work.
+namespace UiaOperationAbstraction
+{
+    // A fixed-size histogram of durations with power-of-two microsecond buckets. Bucket i counts samples in
+    // [2^(i-1), 2^i) microseconds; bucket 0 counts samples under one microsecond and the last bucket absorbs
+    // everything above its lower bound.
+    class UiaLatencyHistogram
+    {
+    public:
+        static constexpr size_t c_bucketCount = 32;
+
+        void Record(std::chrono::microseconds duration);
+
+        uint64_t GetCount() const { return m_count; }
+        const std::array<uint64_t, c_bucketCount>& GetBuckets() const { return m_buckets; }
+
+        // Returns the upper bound of the bucket containing the given percentile (0-100), which is the tightest
+        // bound this histogram can give.
+        std::chrono::microseconds GetPercentile(double percentile) const;
+
+        static std::chrono::microseconds GetBucketUpperBound(size_t bucket);
+
+    private:
+        std::array<uint64_t, c_bucketCount> m_buckets{};
+        uint64_t m_count = 0;
+    };
+
+    enum class UiaOperationPriority
+    {
+        Interactive,
+        Background,
+    };
+
+    struct UiaLaneMetrics
+    {
+        // Time from submission (or, for background chunks, from the previous chunk completing) until execution.
+        UiaLatencyHistogram queueWait;
+        UiaLatencyHistogram executionTime;
+    };
+
+    struct UiaPriorityExecutorMetrics
+    {
+        UiaLaneMetrics interactive;
+        UiaLaneMetrics background;
+    };
+
+    class UiaPriorityExecutor
+    {
+    public:
+        // An interactive operation is built and resolved in a single scope.
+        using Operation = std::function<void(UiaOperationScope& scope)>;
+
+        // A background operation is built one chunk at a time. Each call should build an amount of work that fits
+        // within the remote instruction budget, and return true if more chunks remain. Each chunk is resolved in
+        // its own scope, and pending interactive operations for the same connection run between chunks.
+        using ChunkedOperation = std::function<bool(UiaOperationScope& scope)>;
+
+        UiaPriorityExecutor() = default;
+        ~UiaPriorityExecutor();
+
+        UiaPriorityExecutor(const UiaPriorityExecutor&) = delete;
+        UiaPriorityExecutor& operator=(const UiaPriorityExecutor&) = delete;
+
+        // Queues an operation against the given connection (typically the process id of the target provider).
+        // The future throws winrt::hresult_error if resolving the operation failed.
+        std::future<void> SubmitInteractive(uint64_t connectionId, Operation operation);
+
+        // Queues a background operation. The future becomes ready once the last chunk has been resolved, or
+        // throws if any chunk fails, in which case no further chunks are built.
+        std::future<void> SubmitBackground(uint64_t connectionId, ChunkedOperation operation);
+
+        UiaPriorityExecutorMetrics GetMetrics() const;
+        void ResetMetrics();
+
+    private:
+        struct InteractiveItem
+        {
+            Operation operation;
+            std::promise<void> completion;
+            std::chrono::steady_clock::time_point readyTime;
+        };
+
+        struct BackgroundItem
+        {
+            ChunkedOperation operation;
+            std::promise<void> completion;
+            std::chrono::steady_clock::time_point readyTime;
+        };
+
+        // Each connection gets its own worker thread so that a slow provider cannot hold up other connections,
+        // while operations against the same provider never run concurrently.
+        struct Connection
+        {
+            std::mutex lock;
+            std::condition_variable workAvailable;
+            std::deque<InteractiveItem> interactive;
+            std::deque<BackgroundItem> background;
+            bool stopping = false;
+            std::thread worker;
+        };
+
+        Connection& GetConnection(uint64_t connectionId);
+        void RunWorker(Connection& connection);
+        void Record(UiaOperationPriority priority, std::chrono::microseconds queueWait, std::chrono::microseconds executionTime);
+
+        std::mutex m_connectionsLock;
+        std::map<uint64_t, std::unique_ptr<Connection>> m_connections;
+
+        mutable std::mutex m_metricsLock;
+        UiaPriorityExecutorMetrics m_metrics;
+    };
+}
@@ -0,0 +1,543 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "UiaSnapshot.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        // "UIAS", read as a little-endian integer.
+        constexpr uint32_t c_snapshotMagic = 0x53414955;
+        constexpr uint32_t c_snapshotVersion = 1;
+
+        // How many distinct strings the writer remembers in order to store them only once. Names and class names
+        // repeat a lot; runtime IDs never do, so past this point they only crowd out strings that would have.
+        constexpr size_t c_maxRememberedStrings = 64 * 1024;
+
+        // The largest amount WriteFile and ReadFile are asked to transfer at once.
+        constexpr size_t c_maxTransferSize = 1024 * 1024;
+
+        enum SnapshotSection : size_t
+        {
+            // One uint32_t per node.
+            SnapshotSection_Parents,
+            // One string index (uint32_t) per node.
+            SnapshotSection_RuntimeIds,
+            SnapshotSection_Names,
+            SnapshotSection_AutomationIds,
+            SnapshotSection_ClassNames,
+            // One CONTROLTYPEID per node.
+            SnapshotSection_ControlTypes,
+            // One Rect per node.
+            SnapshotSection_BoundingRectangles,
+            // One uint32_t of SnapshotFlags per node.
+            SnapshotSection_Flags,
+            // One uint64_t per string plus one: string i is the characters from offset i up to offset i + 1.
+            SnapshotSection_StringOffsets,
+            // The characters of all the strings, without terminators.
+            SnapshotSection_StringCharacters,
+            SnapshotSection_Count
+        };
+
+        enum SnapshotFlags : uint32_t
+        {
+            SnapshotFlags_IsEnabled = 0x1,
+            SnapshotFlags_IsOffscreen = 0x2,
+        };
+
+        struct SnapshotSectionEntry
+        {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct SnapshotHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t nodeCount;
+            uint32_t stringCount;
+            SnapshotSectionEntry sections[SnapshotSection_Count];
+        };
+
+        // Every section starts at a multiple of this, so that the reader can use the mapped columns in place.
+        constexpr uint64_t c_sectionAlignment = 8;
+
+        void WriteAll(HANDLE file, const void* data, size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(data);
+            while (size > 0)
+            {
+                const auto chunkSize = static_cast<DWORD>(std::min(size, c_maxTransferSize));
+                DWORD written = 0;
+                THROW_IF_WIN32_BOOL_FALSE(::WriteFile(file, bytes, chunkSize, &written, nullptr));
+                bytes += written;
+                size -= written;
+            }
+        }
+
+        uint64_t GetFilePosition(HANDLE file)
+        {
+            LARGE_INTEGER position{};
+            THROW_IF_WIN32_BOOL_FALSE(::SetFilePointerEx(file, LARGE_INTEGER{}, &position, FILE_CURRENT));
+            return static_cast<uint64_t>(position.QuadPart);
+        }
+
+        void SetFilePosition(HANDLE file, uint64_t position)
+        {
+            LARGE_INTEGER distance{};
+            distance.QuadPart = static_cast<LONGLONG>(position);
+            THROW_IF_WIN32_BOOL_FALSE(::SetFilePointerEx(file, distance, nullptr, FILE_BEGIN));
+        }
+
+        wil::unique_hfile CreateTemporaryFile()
+        {
+            wchar_t directory[MAX_PATH + 1]{};
+            THROW_LAST_ERROR_IF(::GetTempPathW(ARRAYSIZE(directory), directory) == 0);
+
+            wchar_t path[MAX_PATH]{};
+            THROW_LAST_ERROR_IF(::GetTempFileNameW(directory, L"uia", 0, path) == 0);
+
+            // The file is deleted as soon as it's closed, including when the writer is abandoned.
+            wil::unique_hfile file(::CreateFileW(
+                path,
+                GENERIC_READ | GENERIC_WRITE,
+                0 /* dwShareMode */,
+                nullptr /* lpSecurityAttributes */,
+                CREATE_ALWAYS,
+                FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                nullptr /* hTemplateFile */));
+            THROW_LAST_ERROR_IF(!file);
+            return file;
+        }
+
+        std::wstring ToWstring(const wil::shared_bstr& value)
+        {
+            return std::wstring(value ? value.get() : L"");
+        }
+    }
+
+    UiaSnapshotWriter::Column::Column(size_t pageBytes) :
+        m_file(CreateTemporaryFile()),
+        m_pageBytes(pageBytes)
+    {
+        m_page.reserve(m_pageBytes);
+    }
+
+    void UiaSnapshotWriter::Column::Write(const void* data, size_t size)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        m_page.insert(m_page.end(), bytes, bytes + size);
+        m_size += size;
+        if (m_page.size() >= m_pageBytes)
+        {
+            Flush();
+        }
+    }
+
+    void UiaSnapshotWriter::Column::Flush()
+    {
+        WriteAll(m_file.get(), m_page.data(), m_page.size());
+        m_page.clear();
+    }
+
+    uint64_t UiaSnapshotWriter::Column::CopyTo(HANDLE file)
+    {
+        Flush();
+        SetFilePosition(m_file.get(), 0);
+
+        // Copy through the page buffer, which is empty now.
+        m_page.resize(std::min(m_pageBytes, c_maxTransferSize));
+        uint64_t remaining = m_size;
+        while (remaining > 0)
+        {
+            const auto chunkSize = static_cast<DWORD>(std::min<uint64_t>(remaining, m_page.size()));
+            DWORD read = 0;
+            THROW_IF_WIN32_BOOL_FALSE(::ReadFile(m_file.get(), m_page.data(), chunkSize, &read, nullptr));
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_HANDLE_EOF), read == 0);
+            WriteAll(file, m_page.data(), read);
+            remaining -= read;
+        }
+
+        m_page.clear();
+        m_file.reset();
+        return m_size;
+    }
+
+    UiaSnapshotWriter::UiaSnapshotWriter(const std::wstring& path, size_t pageSize)
+    {
+        m_file.reset(::CreateFileW(
+            path.c_str(),
+            GENERIC_WRITE,
+            0 /* dwShareMode */,
+            nullptr /* lpSecurityAttributes */,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr /* hTemplateFile */));
+        THROW_LAST_ERROR_IF(!m_file);
+
+        // The header is written again by Finish. Until then, the magic is zero, so an unfinished snapshot
+        // doesn't open.
+        const SnapshotHeader header{};
+        WriteAll(m_file.get(), &header, sizeof(header));
+
+        // Size each column's page by the width of its entries, so that every column spills after the same
+        // number of nodes.
+        const size_t entrySizes[SnapshotSection_Count] = {
+            sizeof(uint32_t),
+            sizeof(uint32_t),
+            sizeof(uint32_t),
+            sizeof(uint32_t),
+            sizeof(uint32_t),
+            sizeof(CONTROLTYPEID),
+            sizeof(winrt::Windows::Foundation::Rect),
+            sizeof(uint32_t),
+            sizeof(uint64_t),
+            // Assume names of a few dozen characters.
+            32 * sizeof(wchar_t),
+        };
+
+        m_columns.reserve(SnapshotSection_Count);
+        for (const auto entrySize : entrySizes)
+        {
+            m_columns.emplace_back(std::max<size_t>(pageSize, 1) * entrySize);
+        }
+
+        // String 0 is the empty string.
+        WriteValue(m_columns[SnapshotSection_StringOffsets], uint64_t{ 0 });
+        WriteValue(m_columns[SnapshotSection_StringOffsets], uint64_t{ 0 });
+        m_stringCount = 1;
+    }
+
+    UiaSnapshotWriter::~UiaSnapshotWriter() = default;
+
+    uint32_t UiaSnapshotWriter::Append(const UiaSnapshotNode& node)
+    {
+        THROW_HR_IF(E_ILLEGAL_METHOD_CALL, m_finished);
+        THROW_HR_IF(E_BOUNDS, m_nodeCount == c_snapshotNoParent);
+
+        if (m_nodeCount == 0)
+        {
+            THROW_HR_IF(E_INVALIDARG, node.parentIndex != c_snapshotNoParent);
+        }
+        else
+        {
+            THROW_HR_IF(E_INVALIDARG, node.parentIndex >= m_nodeCount || node.parentIndex < m_lastParentIndex);
+            m_lastParentIndex = node.parentIndex;
+        }
+
+        uint32_t flags = 0;
+        if (node.isEnabled)
+        {
+            flags |= SnapshotFlags_IsEnabled;
+        }
+        if (node.isOffscreen)
+        {
+            flags |= SnapshotFlags_IsOffscreen;
+        }
+
+        WriteValue(m_columns[SnapshotSection_Parents], node.parentIndex);
+        WriteValue(m_columns[SnapshotSection_RuntimeIds], AddString(node.runtimeId));
+        WriteValue(m_columns[SnapshotSection_Names], AddString(node.name));
+        WriteValue(m_columns[SnapshotSection_AutomationIds], AddString(node.automationId));
+        WriteValue(m_columns[SnapshotSection_ClassNames], AddString(node.className));
+        WriteValue(m_columns[SnapshotSection_ControlTypes], node.controlType);
+        WriteValue(m_columns[SnapshotSection_BoundingRectangles], node.boundingRectangle);
+        WriteValue(m_columns[SnapshotSection_Flags], flags);
+
+        return m_nodeCount++;
+    }
+
+    uint32_t UiaSnapshotWriter::AddString(std::wstring_view value)
+    {
+        if (value.empty())
+        {
+            return 0;
+        }
+
+        std::wstring key(value);
+        const auto it = m_stringIndices.find(key);
+        if (it != m_stringIndices.end())
+        {
+            return it->second;
+        }
+
+        THROW_HR_IF(E_BOUNDS, m_stringCount == UINT32_MAX);
+        const auto index = m_stringCount++;
+        m_columns[SnapshotSection_StringCharacters].Write(value.data(), value.size() * sizeof(wchar_t));
+        m_stringCharacterCount += value.size();
+        WriteValue(m_columns[SnapshotSection_StringOffsets], m_stringCharacterCount);
+
+        if (m_stringIndices.size() < c_maxRememberedStrings)
+        {
+            m_stringIndices.emplace(std::move(key), index);
+        }
+        return index;
+    }
+
+    void UiaSnapshotWriter::Finish()
+    {
+        THROW_HR_IF(E_ILLEGAL_METHOD_CALL, m_finished);
+        m_finished = true;
+
+        SnapshotHeader header{};
+        header.magic = c_snapshotMagic;
+        header.version = c_snapshotVersion;
+        header.nodeCount = m_nodeCount;
+        header.stringCount = m_stringCount;
+
+        for (size_t section = 0; section < SnapshotSection_Count; ++section)
+        {
+            const auto position = GetFilePosition(m_file.get());
+            const auto padding = (c_sectionAlignment - position % c_sectionAlignment) % c_sectionAlignment;
+            const uint8_t zeros[c_sectionAlignment]{};
+            WriteAll(m_file.get(), zeros, static_cast<size_t>(padding));
+
+            header.sections[section].offset = position + padding;
+            header.sections[section].size = m_columns[section].CopyTo(m_file.get());
+        }
+
+        SetFilePosition(m_file.get(), 0);
+        WriteAll(m_file.get(), &header, sizeof(header));
+
+        m_columns.clear();
+        m_stringIndices.clear();
+        m_file.reset();
+    }
+
+    UiaSnapshotReader::UiaSnapshotReader(const std::wstring& path)
+    {
+        m_file.reset(::CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr /* lpSecurityAttributes */,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr /* hTemplateFile */));
+        THROW_LAST_ERROR_IF(!m_file);
+
+        LARGE_INTEGER fileSize{};
+        THROW_IF_WIN32_BOOL_FALSE(::GetFileSizeEx(m_file.get(), &fileSize));
+        m_fileSize = static_cast<uint64_t>(fileSize.QuadPart);
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), m_fileSize < sizeof(SnapshotHeader));
+
+        m_mapping.reset(::CreateFileMappingW(m_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+        THROW_LAST_ERROR_IF(!m_mapping);
+
+        m_view.reset(static_cast<uint8_t*>(::MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+        THROW_LAST_ERROR_IF(!m_view);
+
+        const auto header = reinterpret_cast<const SnapshotHeader*>(m_view.get());
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), header->magic != c_snapshotMagic);
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_UNSUPPORTED_TYPE), header->version != c_snapshotVersion);
+
+        m_nodeCount = header->nodeCount;
+        m_stringCount = header->stringCount;
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), m_stringCount == 0);
+
+        m_parents = GetColumn<uint32_t>(SnapshotSection_Parents, m_nodeCount);
+        m_runtimeIds = GetColumn<uint32_t>(SnapshotSection_RuntimeIds, m_nodeCount);
+        m_names = GetColumn<uint32_t>(SnapshotSection_Names, m_nodeCount);
+        m_automationIds = GetColumn<uint32_t>(SnapshotSection_AutomationIds, m_nodeCount);
+        m_classNames = GetColumn<uint32_t>(SnapshotSection_ClassNames, m_nodeCount);
+        m_controlTypes = GetColumn<CONTROLTYPEID>(SnapshotSection_ControlTypes, m_nodeCount);
+        m_boundingRectangles = GetColumn<winrt::Windows::Foundation::Rect>(SnapshotSection_BoundingRectangles, m_nodeCount);
+        m_flags = GetColumn<uint32_t>(SnapshotSection_Flags, m_nodeCount);
+        m_stringOffsets = GetColumn<uint64_t>(SnapshotSection_StringOffsets, static_cast<uint64_t>(m_stringCount) + 1);
+
+        const auto& characters = header->sections[SnapshotSection_StringCharacters];
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), characters.size % sizeof(wchar_t) != 0);
+        m_stringCharacters = GetColumn<wchar_t>(SnapshotSection_StringCharacters, characters.size / sizeof(wchar_t));
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA),
+            m_stringOffsets[m_stringCount] != characters.size / sizeof(wchar_t));
+    }
+
+    template <class T>
+    const T* UiaSnapshotReader::GetColumn(size_t section, uint64_t count) const
+    {
+        const auto& entry = reinterpret_cast<const SnapshotHeader*>(m_view.get())->sections[section];
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA),
+            entry.offset % alignof(T) != 0 ||
+            entry.offset > m_fileSize ||
+            entry.size > m_fileSize - entry.offset ||
+            entry.size != count * sizeof(T));
+        return reinterpret_cast<const T*>(m_view.get() + entry.offset);
+    }
+
+    std::wstring_view UiaSnapshotReader::GetString(uint32_t stringIndex) const
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), stringIndex >= m_stringCount);
+
+        // The offsets were checked against the size of the table when the last one was, but not against each
+        // other.
+        const auto begin = m_stringOffsets[stringIndex];
+        const auto end = m_stringOffsets[stringIndex + 1];
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), begin > end || end > m_stringOffsets[m_stringCount]);
+        return std::wstring_view(m_stringCharacters + begin, static_cast<size_t>(end - begin));
+    }
+
+    UiaSnapshotNode UiaSnapshotReader::GetNode(uint32_t index) const
+    {
+        THROW_HR_IF(E_BOUNDS, index >= m_nodeCount);
+
+        UiaSnapshotNode node;
+        node.parentIndex = m_parents[index];
+        node.runtimeId = GetString(m_runtimeIds[index]);
+        node.name = GetString(m_names[index]);
+        node.automationId = GetString(m_automationIds[index]);
+        node.className = GetString(m_classNames[index]);
+        node.controlType = m_controlTypes[index];
+        node.boundingRectangle = m_boundingRectangles[index];
+        node.isEnabled = (m_flags[index] & SnapshotFlags_IsEnabled) != 0;
+        node.isOffscreen = (m_flags[index] & SnapshotFlags_IsOffscreen) != 0;
+        return node;
+    }
+
+    uint32_t UiaSnapshotReader::GetParentIndex(uint32_t index) const
+    {
+        THROW_HR_IF(E_BOUNDS, index >= m_nodeCount);
+        return m_parents[index];
+    }
+
+    std::pair<uint32_t, uint32_t> UiaSnapshotReader::GetChildRange(uint32_t index) const
+    {
+        THROW_HR_IF(E_BOUNDS, index >= m_nodeCount);
+
+        // Every node but the root has a parent with a lower index, so the children come after it. The parents of
+        // the nodes after the root are sorted, since nodes are in breadth-first order.
+        const auto first = m_parents + index + 1;
+        const auto last = m_parents + m_nodeCount;
+        const auto [begin, end] = std::equal_range(first, last, index);
+        return { static_cast<uint32_t>(begin - m_parents), static_cast<uint32_t>(end - m_parents) };
+    }
+
+    uint32_t WriteSubtreeSnapshot(UiaElement root, const std::wstring& path, size_t elementsPerOperation)
+    {
+        THROW_HR_IF(E_INVALIDARG, elementsPerOperation == 0);
+
+        UiaSnapshotWriter writer(path);
+
+        struct PendingElement
+        {
+            UiaElement element;
+            uint32_t parentIndex;
+        };
+
+        std::deque<PendingElement> pending;
+        pending.push_back({ std::move(root), c_snapshotNoParent });
+
+        while (!pending.empty())
+        {
+            const auto pageSize = std::min(pending.size(), elementsPerOperation);
+
+            auto scope = UiaOperationScope::StartNew();
+
+            UiaArray<UiaString> runtimeIds;
+            UiaArray<UiaString> names;
+            UiaArray<UiaString> automationIds;
+            UiaArray<UiaString> classNames;
+            UiaArray<UiaControlType> controlTypes;
+            UiaArray<UiaRect> boundingRectangles;
+            UiaArray<UiaBool> isEnabled;
+            UiaArray<UiaBool> isOffscreen;
+            UiaArray<UiaArray<UiaElement>> children;
+
+            // The arrays above only hold the elements that were read successfully.
+            std::vector<UiaInt> failureCodes;
+            failureCodes.reserve(pageSize);
+
+            for (size_t i = 0; i < pageSize; ++i)
+            {
+                // Bind a copy, so that the pending element stays local.
+                UiaElement element = pending[i].element;
+                scope.BindInput(element);
+
+                auto& failureCode = failureCodes.emplace_back(S_OK);
+                scope.BindInput(failureCode);
+                scope.TryCatch([&]()
+                {
+                    // Read everything before appending anything, so that an element that goes away halfway leaves
+                    // no trace in the arrays.
+                    UiaString runtimeId = element.GetRuntimeId().Stringify();
+                    UiaString name = element.GetName();
+                    UiaString automationId = element.GetAutomationId();
+                    UiaString className = element.GetClassName();
+                    UiaControlType controlType = element.GetControlType();
+                    UiaRect boundingRectangle = element.GetBoundingRectangle();
+                    UiaBool elementIsEnabled = element.GetIsEnabled();
+                    UiaBool elementIsOffscreen = element.GetIsOffscreen();
+
+                    UiaArray<UiaElement> elementChildren;
+                    ForEachChildElement(element, [&](UiaElement child)
+                    {
+                        elementChildren.Append(child);
+                    });
+
+                    runtimeIds.Append(runtimeId);
+                    names.Append(name);
+                    automationIds.Append(automationId);
+                    classNames.Append(className);
+                    controlTypes.Append(controlType);
+                    boundingRectangles.Append(boundingRectangle);
+                    isEnabled.Append(elementIsEnabled);
+                    isOffscreen.Append(elementIsOffscreen);
+                    children.Append(elementChildren);
+                },
+                [&](UiaFailure failure)
+                {
+                    failureCode = failure.GetCurrentFailureCode();
+                });
+                scope.BindResult(failureCode);
+            }
+
+            scope.BindResult(runtimeIds, names, automationIds, classNames, controlTypes, boundingRectangles, isEnabled,
+                isOffscreen, children);
+            scope.Resolve();
+
+            size_t next = 0;
+            for (size_t i = 0; i < pageSize; ++i)
+            {
+                const auto parentIndex = pending.front().parentIndex;
+                pending.pop_front();
+
+                // An element that failed, typically because it went away, is left out along with its subtree.
+                if (FAILED(static_cast<HRESULT>(static_cast<int>(failureCodes[i]))))
+                {
+                    continue;
+                }
+
+                const auto runtimeId = ToWstring((*runtimeIds)[next]);
+                const auto name = ToWstring((*names)[next]);
+                const auto automationId = ToWstring((*automationIds)[next]);
+                const auto className = ToWstring((*classNames)[next]);
+
+                UiaSnapshotNode node;
+                node.parentIndex = parentIndex;
+                node.runtimeId = runtimeId;
+                node.name = name;
+                node.automationId = automationId;
+                node.className = className;
+                node.controlType = (*controlTypes)[next];
+                node.boundingRectangle = (*boundingRectangles)[next];
+                node.isEnabled = (*isEnabled)[next];
+                node.isOffscreen = (*isOffscreen)[next];
+                const auto index = writer.Append(node);
+
+                for (auto& child : *(*children)[next])
+                {
+                    pending.push_back({ std::move(child), index });
+                }
+                ++next;
+            }
+        }
+
+        writer.Finish();
+        return writer.GetNodeCount();
+    }
+}
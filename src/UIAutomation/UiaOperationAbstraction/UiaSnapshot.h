@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements a compact on-disk format for snapshots of element subtrees, so that dumps too large to hold in memory
+// can be written as they are fetched and analyzed offline without loading them.
+//
+// A snapshot is columnar: each property is stored as a fixed-width array with one entry per node, and strings are
+// stored once in a string table and referred to by index. Nodes are stored in breadth-first order, so the children
+// of each node are contiguous and the parent column is sorted, which is all the reader needs to find them.
+namespace UiaOperationAbstraction
+{
+    // The parent index of the root.
+    constexpr uint32_t c_snapshotNoParent = UINT32_MAX;
+
+    // The properties of one node. The strings only need to live until the node is appended; when read back, they
+    // point into the mapped file.
+    struct UiaSnapshotNode
+    {
+        uint32_t parentIndex = c_snapshotNoParent;
+        std::wstring_view runtimeId;
+        std::wstring_view name;
+        std::wstring_view automationId;
+        std::wstring_view className;
+        CONTROLTYPEID controlType = 0;
+        winrt::Windows::Foundation::Rect boundingRectangle{};
+        bool isEnabled = false;
+        bool isOffscreen = false;
+    };
+
+    // Writes a snapshot one node at a time.
+    //
+    // Each column is buffered a page at a time and spilled to a temporary file, and Finish copies the columns into
+    // the snapshot one after the other. Strings are appended to the string table as they are first seen; the
+    // writer remembers a bounded number of them to avoid storing repeats, so its memory use doesn't grow with the
+    // size of the tree.
+    class UiaSnapshotWriter
+    {
+    public:
+        // Creates the snapshot file, replacing any existing one.
+        explicit UiaSnapshotWriter(const std::wstring& path, size_t pageSize = 4096);
+        ~UiaSnapshotWriter();
+
+        UiaSnapshotWriter(const UiaSnapshotWriter&) = delete;
+        UiaSnapshotWriter& operator=(const UiaSnapshotWriter&) = delete;
+
+        // Appends a node and returns its index. Nodes must be appended in breadth-first order: the parent index
+        // must be less than the new node's index, and no less than the parent index of the previous node. Only the
+        // first node may be the root.
+        uint32_t Append(const UiaSnapshotNode& node);
+
+        uint32_t GetNodeCount() const { return m_nodeCount; }
+
+        // Writes out the columns and closes the file. Nothing can be appended afterwards. If the writer is
+        // destroyed without finishing, the snapshot is left incomplete and fails to open.
+        void Finish();
+
+    private:
+        // A column buffered in memory up to a page and spilled to a temporary file beyond that.
+        class Column
+        {
+        public:
+            explicit Column(size_t pageBytes);
+
+            void Write(const void* data, size_t size);
+            // Copies the column to the end of the given file and returns its size.
+            uint64_t CopyTo(HANDLE file);
+
+        private:
+            void Flush();
+
+            wil::unique_hfile m_file;
+            std::vector<uint8_t> m_page;
+            size_t m_pageBytes;
+            uint64_t m_size = 0;
+        };
+
+        template <class T>
+        static void WriteValue(Column& column, const T& value)
+        {
+            column.Write(&value, sizeof(value));
+        }
+
+        uint32_t AddString(std::wstring_view value);
+
+        wil::unique_hfile m_file;
+        bool m_finished = false;
+
+        uint32_t m_nodeCount = 0;
+        uint32_t m_lastParentIndex = 0;
+
+        // The columns, in the order of the file's sections.
+        std::vector<Column> m_columns;
+
+        uint32_t m_stringCount = 0;
+        uint64_t m_stringCharacterCount = 0;
+        std::unordered_map<std::wstring, uint32_t> m_stringIndices;
+    };
+
+    // Reads a snapshot by mapping it into memory. Nothing is copied or parsed up front, so opening a snapshot takes
+    // the same time regardless of its size, and only the pages that are read are loaded.
+    class UiaSnapshotReader
+    {
+    public:
+        // Throws if the file isn't a complete snapshot in this format.
+        explicit UiaSnapshotReader(const std::wstring& path);
+
+        UiaSnapshotReader(const UiaSnapshotReader&) = delete;
+        UiaSnapshotReader& operator=(const UiaSnapshotReader&) = delete;
+
+        uint32_t GetNodeCount() const { return m_nodeCount; }
+
+        // The node at the given index. Its strings point into the mapped file and are valid as long as the reader.
+        UiaSnapshotNode GetNode(uint32_t index) const;
+
+        uint32_t GetParentIndex(uint32_t index) const;
+        // Returns the half-open range of the indices of the node's children.
+        std::pair<uint32_t, uint32_t> GetChildRange(uint32_t index) const;
+
+    private:
+        std::wstring_view GetString(uint32_t stringIndex) const;
+
+        template <class T>
+        const T* GetColumn(size_t section, uint64_t count) const;
+
+        wil::unique_hfile m_file;
+        wil::unique_handle m_mapping;
+        wil::unique_mapview_ptr<uint8_t> m_view;
+        uint64_t m_fileSize = 0;
+
+        uint32_t m_nodeCount = 0;
+        uint32_t m_stringCount = 0;
+
+        const uint32_t* m_parents = nullptr;
+        const uint32_t* m_runtimeIds = nullptr;
+        const uint32_t* m_names = nullptr;
+        const uint32_t* m_automationIds = nullptr;
+        const uint32_t* m_classNames = nullptr;
+        const CONTROLTYPEID* m_controlTypes = nullptr;
+        const winrt::Windows::Foundation::Rect* m_boundingRectangles = nullptr;
+        const uint32_t* m_flags = nullptr;
+        const uint64_t* m_stringOffsets = nullptr;
+        const wchar_t* m_stringCharacters = nullptr;
+    };
+
+    // Writes a snapshot of the subtree under the root, fetching one page of elements per operation and appending
+    // them to the snapshot as each operation resolves. Returns the number of nodes written. An element that fails
+    // to be read, typically because it went away during the dump, is left out of the snapshot along with its
+    // subtree, rather than failing the dump.
+    //
+    // Apart from the writer's pages, the only state kept between operations is the elements that have been found
+    // but not visited yet. These are live element references, which can't be spilled to disk like the writer's
+    // columns, so while they span at most two levels of the tree, their number grows with the width of those
+    // levels: a dump only stays within a fixed amount of memory if the tree is narrow.
+    uint32_t WriteSubtreeSnapshot(UiaElement root, const std::wstring& path, size_t elementsPerOperation = 256);
+}
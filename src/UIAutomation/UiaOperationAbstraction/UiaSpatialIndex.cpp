@@ -0,0 +1,276 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "UiaSpatialIndex.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        // Pending updates are folded into the packed tree once they exceed this fraction of the indexed entries
+        // (or c_minRepackThreshold, for small indices), bounding the linear part of every query.
+        constexpr size_t c_repackDivisor = 4;
+        constexpr size_t c_minRepackThreshold = 64;
+
+        float CenterX(const winrt::Windows::Foundation::Rect& rect)
+        {
+            return rect.X + rect.Width / 2;
+        }
+
+        float CenterY(const winrt::Windows::Foundation::Rect& rect)
+        {
+            return rect.Y + rect.Height / 2;
+        }
+    }
+
+    UiaSpatialIndex::UiaSpatialIndex(std::vector<UiaSpatialIndexEntry> entries) :
+        m_entries(std::move(entries))
+    {
+        m_live.assign(m_entries.size(), true);
+        for (uint32_t slot = 0; slot < m_entries.size(); ++slot)
+        {
+            auto [it, inserted] = m_slotsByRuntimeId.emplace(m_entries[slot].runtimeId, slot);
+            if (!inserted)
+            {
+                // The last entry for a runtime ID wins, as if the entries had been inserted one at a time.
+                m_live[it->second] = false;
+                it->second = slot;
+            }
+        }
+
+        Repack();
+    }
+
+    /* static */ UiaSpatialIndex UiaSpatialIndex::FromSubtree(UiaElement root)
+    {
+        auto scope = UiaOperationScope::StartNew();
+        scope.BindInput(root);
+
+        // Walk the subtree breadth first, using the array of visited elements as the queue.
+        UiaArray<UiaElement> elements;
+        UiaArray<UiaRect> boundingRectangles;
+        UiaArray<UiaArray<UiaInt>> runtimeIds;
+        UiaUint next = 0;
+
+        elements.Append(root);
+        scope.While([&]()
+        {
+            return next < elements.Size();
+        },
+        [&]()
+        {
+            UiaElement element = elements.GetAt(next);
+            next += 1;
+
+            boundingRectangles.Append(element.GetBoundingRectangle());
+            runtimeIds.Append(element.GetRuntimeId());
+
+            ForEachChildElement(element, [&](UiaElement child)
+            {
+                elements.Append(child);
+            });
+        });
+
+        scope.BindResult(boundingRectangles, runtimeIds);
+        scope.Resolve();
+
+        const auto& localRectangles = *boundingRectangles;
+        const auto& localRuntimeIds = *runtimeIds;
+
+        std::vector<UiaSpatialIndexEntry> entries;
+        entries.reserve(localRectangles.size());
+        for (size_t i = 0; i < localRectangles.size(); ++i)
+        {
+            entries.push_back({ localRectangles[i], *localRuntimeIds[i] });
+        }
+
+        return UiaSpatialIndex(std::move(entries));
+    }
+
+    void UiaSpatialIndex::Insert(UiaSpatialIndexEntry entry)
+    {
+        const auto slot = static_cast<uint32_t>(m_entries.size());
+        auto [it, inserted] = m_slotsByRuntimeId.emplace(entry.runtimeId, slot);
+        if (!inserted)
+        {
+            m_live[it->second] = false;
+            ++m_deadCount;
+            it->second = slot;
+        }
+
+        m_entries.emplace_back(std::move(entry));
+        m_live.push_back(true);
+
+        RepackIfNeeded();
+    }
+
+    bool UiaSpatialIndex::Remove(const std::vector<int>& runtimeId)
+    {
+        const auto it = m_slotsByRuntimeId.find(runtimeId);
+        if (it == m_slotsByRuntimeId.end())
+        {
+            return false;
+        }
+
+        m_live[it->second] = false;
+        ++m_deadCount;
+        m_slotsByRuntimeId.erase(it);
+
+        RepackIfNeeded();
+        return true;
+    }
+
+    std::vector<const UiaSpatialIndexEntry*> UiaSpatialIndex::QueryPoint(winrt::Windows::Foundation::Point point) const
+    {
+        return Query([&](const Box& box)
+        {
+            return box.minX <= point.X && point.X < box.maxX && box.minY <= point.Y && point.Y < box.maxY;
+        });
+    }
+
+    std::vector<const UiaSpatialIndexEntry*> UiaSpatialIndex::QueryRegion(winrt::Windows::Foundation::Rect region) const
+    {
+        const auto regionBox = ToBox(region);
+        return Query([&](const Box& box)
+        {
+            return box.minX < regionBox.maxX && regionBox.minX < box.maxX && box.minY < regionBox.maxY && regionBox.minY < box.maxY;
+        });
+    }
+
+    template <class Predicate>
+    std::vector<const UiaSpatialIndexEntry*> UiaSpatialIndex::Query(const Predicate& intersects) const
+    {
+        std::vector<const UiaSpatialIndexEntry*> matches;
+
+        if (!m_nodes.empty())
+        {
+            std::vector<uint32_t> pending{ static_cast<uint32_t>(m_nodes.size() - 1) };
+            while (!pending.empty())
+            {
+                const auto& node = m_nodes[pending.back()];
+                pending.pop_back();
+                if (!intersects(node.bounds))
+                {
+                    continue;
+                }
+
+                for (auto child = node.first; child < node.first + node.count; ++child)
+                {
+                    if (!node.isLeaf)
+                    {
+                        pending.push_back(child);
+                    }
+                    else if (m_live[child] && intersects(ToBox(m_entries[child].boundingRectangle)))
+                    {
+                        matches.push_back(&m_entries[child]);
+                    }
+                }
+            }
+        }
+
+        for (auto slot = m_indexedCount; slot < m_entries.size(); ++slot)
+        {
+            if (m_live[slot] && intersects(ToBox(m_entries[slot].boundingRectangle)))
+            {
+                matches.push_back(&m_entries[slot]);
+            }
+        }
+
+        return matches;
+    }
+
+    void UiaSpatialIndex::RepackIfNeeded()
+    {
+        const size_t pending = (m_entries.size() - m_indexedCount) + m_deadCount;
+        if (pending > std::max(c_minRepackThreshold, m_indexedCount / c_repackDivisor))
+        {
+            Repack();
+        }
+    }
+
+    void UiaSpatialIndex::Repack()
+    {
+        std::vector<UiaSpatialIndexEntry> live;
+        live.reserve(m_slotsByRuntimeId.size());
+        for (size_t slot = 0; slot < m_entries.size(); ++slot)
+        {
+            if (m_live[slot])
+            {
+                live.emplace_back(std::move(m_entries[slot]));
+            }
+        }
+
+        // Sort-Tile-Recursive: cut the entries into vertical slices by x, then order each slice by y, so that
+        // each run of c_nodeCapacity entries forms a compact leaf.
+        const size_t leafCount = (live.size() + c_nodeCapacity - 1) / c_nodeCapacity;
+        const auto sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+        const size_t sliceSize = std::max<size_t>(sliceCount * c_nodeCapacity, 1);
+
+        std::sort(live.begin(), live.end(), [](const auto& lhs, const auto& rhs)
+        {
+            return CenterX(lhs.boundingRectangle) < CenterX(rhs.boundingRectangle);
+        });
+        for (size_t sliceStart = 0; sliceStart < live.size(); sliceStart += sliceSize)
+        {
+            const auto sliceEnd = std::min(sliceStart + sliceSize, live.size());
+            std::sort(live.begin() + sliceStart, live.begin() + sliceEnd, [](const auto& lhs, const auto& rhs)
+            {
+                return CenterY(lhs.boundingRectangle) < CenterY(rhs.boundingRectangle);
+            });
+        }
+
+        m_entries = std::move(live);
+        m_live.assign(m_entries.size(), true);
+        m_slotsByRuntimeId.clear();
+        for (uint32_t slot = 0; slot < m_entries.size(); ++slot)
+        {
+            m_slotsByRuntimeId.emplace(m_entries[slot].runtimeId, slot);
+        }
+        m_indexedCount = static_cast<uint32_t>(m_entries.size());
+        m_deadCount = 0;
+
+        // Build the tree bottom up. Packing keeps neighbours adjacent, so each upper level simply groups runs of
+        // consecutive nodes from the level below, and the root ends up as the last node.
+        m_nodes.clear();
+        auto makeNode = [&](uint32_t first, uint32_t count, bool isLeaf)
+        {
+            Node node{ { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX }, first, count, isLeaf };
+            for (auto child = first; child < first + count; ++child)
+            {
+                const auto box = isLeaf ? ToBox(m_entries[child].boundingRectangle) : m_nodes[child].bounds;
+                node.bounds.minX = std::min(node.bounds.minX, box.minX);
+                node.bounds.minY = std::min(node.bounds.minY, box.minY);
+                node.bounds.maxX = std::max(node.bounds.maxX, box.maxX);
+                node.bounds.maxY = std::max(node.bounds.maxY, box.maxY);
+            }
+            m_nodes.push_back(node);
+        };
+
+        for (uint32_t first = 0; first < m_indexedCount; first += c_nodeCapacity)
+        {
+            makeNode(first, std::min<uint32_t>(c_nodeCapacity, m_indexedCount - first), true /* isLeaf */);
+        }
+
+        uint32_t levelStart = 0;
+        auto levelEnd = static_cast<uint32_t>(m_nodes.size());
+        while (levelEnd - levelStart > 1)
+        {
+            for (auto first = levelStart; first < levelEnd; first += c_nodeCapacity)
+            {
+                makeNode(first, std::min<uint32_t>(c_nodeCapacity, levelEnd - first), false /* isLeaf */);
+            }
+            levelStart = levelEnd;
+            levelEnd = static_cast<uint32_t>(m_nodes.size());
+        }
+    }
+
+    /* static */ UiaSpatialIndex::Box UiaSpatialIndex::ToBox(const winrt::Windows::Foundation::Rect& rect)
+    {
+        return { rect.X, rect.Y, rect.X + rect.Width, rect.Y + rect.Height };
+    }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements a client-side spatial index over element bounding rectangles, so that point and region queries can be
+// answered without a round trip per query.
+namespace UiaOperationAbstraction
+{
+    struct UiaSpatialIndexEntry
+    {
+        winrt::Windows::Foundation::Rect boundingRectangle;
+        std::vector<int> runtimeId;
+    };
+
+    // A packed R-tree, bulk loaded with Sort-Tile-Recursive packing.
+    //
+    // The packed tree itself is immutable. Inserted entries are kept in a small unindexed overflow list and removed
+    // entries are tombstoned; both are folded back into a freshly packed tree once they grow past a fraction of the
+    // indexed entries, which keeps queries close to the bulk loaded cost while updates stay cheap.
+    //
+    // Entries are identified by runtime ID, which must be unique within the index. Query results point into the
+    // index and are only valid until it is next modified.
+    class UiaSpatialIndex
+    {
+    public:
+        UiaSpatialIndex() = default;
+        explicit UiaSpatialIndex(std::vector<UiaSpatialIndexEntry> entries);
+
+        // Fetches the bounding rectangles and runtime IDs of the given element and all of its descendants in a
+        // single operation, and bulk loads them. Large subtrees may exceed the remote instruction limit, in which
+        // case this throws and the subtree needs to be indexed in parts.
+        static UiaSpatialIndex FromSubtree(UiaElement root);
+
+        // Adds an entry, or moves the existing entry with the same runtime ID.
+        void Insert(UiaSpatialIndexEntry entry);
+        // Returns false if there is no entry with the given runtime ID.
+        bool Remove(const std::vector<int>& runtimeId);
+
+        // Returns the entries whose bounding rectangles contain the given point, in no particular order.
+        std::vector<const UiaSpatialIndexEntry*> QueryPoint(winrt::Windows::Foundation::Point point) const;
+        // Returns the entries whose bounding rectangles intersect the given region, in no particular order.
+        std::vector<const UiaSpatialIndexEntry*> QueryRegion(winrt::Windows::Foundation::Rect region) const;
+
+        size_t Size() const { return m_slotsByRuntimeId.size(); }
+
+        // Rebuilds the packed tree from the live entries, folding in pending updates.
+        void Repack();
+
+    private:
+        static constexpr size_t c_nodeCapacity = 16;
+
+        struct Box
+        {
+            float minX;
+            float minY;
+            float maxX;
+            float maxY;
+        };
+
+        struct Node
+        {
+            Box bounds;
+            // Index of the first child: a slot in m_entries for leaves, or an index into m_nodes otherwise.
+            uint32_t first;
+            uint32_t count;
+            bool isLeaf;
+        };
+
+        template <class Predicate>
+        std::vector<const UiaSpatialIndexEntry*> Query(const Predicate& intersects) const;
+
+        void RepackIfNeeded();
+
+        static Box ToBox(const winrt::Windows::Foundation::Rect& rect);
+
+        // Entry storage. Slots are never reused until the next repack; removed slots are marked dead.
+        std::vector<UiaSpatialIndexEntry> m_entries;
+        std::vector<bool> m_live;
+        std::map<std::vector<int>, uint32_t> m_slotsByRuntimeId;
+
+        // Repacking sorts m_entries into leaf order, so the packed tree covers the slots below m_indexedCount.
+        // Slots from m_indexedCount onwards are the overflow list.
+        std::vector<Node> m_nodes;
+        uint32_t m_indexedCount = 0;
+        uint32_t m_deadCount = 0;
+    };
+}
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include "UiaStringBuilder.h"
+
+namespace UiaOperationAbstraction
+{
+    void UiaStringBuilder::Append(UiaString fragment)
+    {
+        m_fragments.Append(fragment);
+    }
+
+    UiaUint UiaStringBuilder::FragmentCount() const
+    {
+        return m_fragments.Size();
+    }
+
+    UiaString UiaStringBuilder::ToString(UiaOperationScope& scope)
+    {
+        UiaString result = L"";
+
+        UiaUint count = 0;
+        count = m_fragments.Size();
+        scope.If(count > 0u, [&]()
+        {
+            // Reduce in place: at each level, the fragment at every multiple of 2 * stride absorbs its neighbour
+            // stride positions to the right, until the first fragment holds the whole string.
+            UiaUint stride = 1;
+            scope.While([&]()
+            {
+                return stride < count;
+            },
+            [&]()
+            {
+                UiaUint step = 0;
+                step = stride;
+                step *= 2;
+
+                UiaUint index = 0;
+                UiaUint neighbour = 0;
+                neighbour = stride;
+                scope.While([&]()
+                {
+                    return neighbour < count;
+                },
+                [&]()
+                {
+                    m_fragments.SetAt(index, m_fragments.GetAt(index).Concat(m_fragments.GetAt(neighbour)));
+                    index += step;
+                    neighbour += step;
+                });
+
+                stride = step;
+            });
+
+            result = m_fragments.GetAt(0);
+
+            // Drop the partial results so that only the joined string is left.
+            scope.While([&]()
+            {
+                return m_fragments.Size() > 1u;
+            },
+            [&]()
+            {
+                UiaUint last = 0;
+                last = m_fragments.Size();
+                last -= 1;
+                m_fragments.RemoveAt(last);
+            });
+        });
+
+        return result;
+    }
+}
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "UiaOperationAbstraction.h"
+
+// Implements a string builder for operations that join many fragments.
+namespace UiaOperationAbstraction
+{
+    // Joins string fragments without the quadratic copying of a Concat chain.
+    //
+    // Remote strings are immutable, so `result = result.Concat(fragment)` in a loop copies everything built so far on
+    // every iteration: joining n fragments of total length L copies O(n * L) characters on the provider side, which
+    // for equally sized fragments is O(n^2). The builder instead collects the fragments in an array and joins them
+    // pairwise in a balanced tree, neighbours first, so each character is copied once per level of the tree for
+    // O(L * log n) in total. With 4096 fragments that is 12 copies of each character rather than an average of
+    // 2048.
+    //
+    // Like the other wrappers, the builder works both locally and remotely; when an operation scope is active it
+    // must be used within that scope.
+    class UiaStringBuilder
+    {
+    public:
+        void Append(UiaString fragment);
+
+        UiaUint FragmentCount() const;
+
+        // Joins the fragments appended so far, in order. The fragments are collapsed into the single result, so the
+        // builder can keep being appended to and joined again.
+        UiaString ToString(UiaOperationScope& scope);
+
+    private:
+        UiaArray<UiaString> m_fragments;
+    };
+}
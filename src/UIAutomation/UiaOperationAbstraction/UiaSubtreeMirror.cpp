@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+
+#include "UiaSubtreeMirror.h"
+
+namespace UiaOperationAbstraction
+{
+    namespace
+    {
+        std::wstring ToWstring(const wil::shared_bstr& value)
+        {
+            return std::wstring(value ? value.get() : L"");
+        }
+    }
+
+    UiaSubtreeMirror::UiaSubtreeMirror(UiaElement root) :
+        m_root(std::move(root))
+    {
+    }
+
+    UiaMirrorSyncStatistics UiaSubtreeMirror::Sync()
+    {
+        std::map<std::wstring, wil::shared_bstr> knownChildrenLocal;
+        std::map<std::wstring, wil::shared_bstr> knownNamesLocal;
+        std::map<std::wstring, wil::shared_bstr> knownRectanglesLocal;
+        for (const auto& [key, node] : m_nodes)
+        {
+            knownChildrenLocal.emplace(key, wil::make_bstr(node.childrenSignature.c_str()));
+            knownNamesLocal.emplace(key, wil::make_bstr(node.name.c_str()));
+            knownRectanglesLocal.emplace(key, wil::make_bstr(node.boundingRectangleSignature.c_str()));
+        }
+
+        auto scope = UiaOperationScope::StartNew();
+
+        // Bind a copy, so that m_root stays local and can be imported again by the next Sync.
+        UiaElement root = m_root;
+        scope.BindInput(root);
+
+        UiaStringMap<UiaString> knownChildren{ std::move(knownChildrenLocal) };
+        UiaStringMap<UiaString> knownNames{ std::move(knownNamesLocal) };
+        UiaStringMap<UiaString> knownRectangles{ std::move(knownRectanglesLocal) };
+
+        UiaString rootKey = root.GetRuntimeId().Stringify();
+
+        // Nodes that are new or whose children changed.
+        UiaArray<UiaString> structureKeys;
+        UiaArray<UiaString> structureSignatures;
+        UiaArray<UiaArray<UiaString>> structureChildren;
+
+        // Nodes that are new or whose properties changed.
+        UiaArray<UiaString> propertyKeys;
+        UiaArray<UiaString> names;
+        UiaArray<UiaRect> rectangles;
+        UiaArray<UiaString> rectangleSignatures;
+
+        UiaArray<UiaElement> pending;
+        UiaUint next = 0;
+        pending.Append(root);
+        scope.While([&]()
+        {
+            return next < pending.Size();
+        },
+        [&]()
+        {
+            UiaElement element = pending.GetAt(next);
+            next += 1;
+
+            UiaString key = element.GetRuntimeId().Stringify();
+            UiaString name = element.GetName();
+            UiaRect rectangle = element.GetBoundingRectangle();
+            UiaString rectangleSignature = rectangle.Stringify();
+
+            UiaArray<UiaString> childKeys;
+            ForEachChildElement(element, [&](UiaElement child)
+            {
+                pending.Append(child);
+                childKeys.Append(child.GetRuntimeId().Stringify());
+            });
+            UiaString childrenSignature = childKeys.Stringify();
+
+            auto reportStructure = [&]()
+            {
+                structureKeys.Append(key);
+                structureSignatures.Append(childrenSignature);
+                structureChildren.Append(childKeys);
+            };
+            auto reportProperties = [&]()
+            {
+                propertyKeys.Append(key);
+                names.Append(name);
+                rectangles.Append(rectangle);
+                rectangleSignatures.Append(rectangleSignature);
+            };
+
+            scope.If(knownChildren.HasKey(key), [&]()
+            {
+                scope.If(knownChildren.Lookup(key) != childrenSignature, reportStructure);
+                scope.If(knownNames.Lookup(key) != name || knownRectangles.Lookup(key) != rectangleSignature, reportProperties);
+            },
+            [&]()
+            {
+                reportStructure();
+                reportProperties();
+            });
+        });
+
+        scope.BindResult(rootKey, structureKeys, structureSignatures, structureChildren, propertyKeys, names, rectangles, rectangleSignatures);
+        scope.Resolve();
+
+        UiaMirrorSyncStatistics statistics;
+        m_rootKey = rootKey.GetLocalWstring();
+
+        std::set<std::wstring> added;
+        std::set<std::wstring> stillReferenced;
+        std::vector<std::wstring> removalCandidates;
+
+        const auto& localStructureKeys = *structureKeys;
+        for (size_t i = 0; i < localStructureKeys.size(); ++i)
+        {
+            const auto key = ToWstring(localStructureKeys[i]);
+
+            std::vector<std::wstring> children;
+            for (const auto& childKey : *(*structureChildren)[i])
+            {
+                children.emplace_back(ToWstring(childKey));
+            }
+            stillReferenced.insert(children.begin(), children.end());
+
+            auto [it, inserted] = m_nodes.try_emplace(key);
+            auto& node = it->second;
+            if (inserted)
+            {
+                added.insert(key);
+                ++statistics.addedCount;
+            }
+            else
+            {
+                ++statistics.childrenChangedCount;
+                for (const auto& oldChild : node.children)
+                {
+                    if (std::find(children.begin(), children.end(), oldChild) == children.end())
+                    {
+                        removalCandidates.push_back(oldChild);
+                    }
+                }
+            }
+
+            node.children = std::move(children);
+            node.childrenSignature = ToWstring((*structureSignatures)[i]);
+        }
+
+        const auto& localPropertyKeys = *propertyKeys;
+        for (size_t i = 0; i < localPropertyKeys.size(); ++i)
+        {
+            const auto key = ToWstring(localPropertyKeys[i]);
+            if (added.find(key) == added.end())
+            {
+                ++statistics.propertiesChangedCount;
+            }
+
+            auto& node = m_nodes[key];
+            node.name = ToWstring((*names)[i]);
+            node.boundingRectangle = (*rectangles)[i];
+            node.boundingRectangleSignature = ToWstring((*rectangleSignatures)[i]);
+        }
+
+        // A child that disappeared from one list may have moved to another; only drop it if no changed list still
+        // refers to it.
+        for (const auto& candidate : removalCandidates)
+        {
+            if (stillReferenced.find(candidate) == stillReferenced.end())
+            {
+                RemoveSubtree(candidate, stillReferenced, statistics);
+            }
+        }
+
+        return statistics;
+    }
+
+    void UiaSubtreeMirror::RemoveSubtree(const std::wstring& key, const std::set<std::wstring>& stillReferenced, UiaMirrorSyncStatistics& statistics)
+    {
+        const auto it = m_nodes.find(key);
+        if (it == m_nodes.end())
+        {
+            return;
+        }
+
+        const auto children = std::move(it->second.children);
+        m_nodes.erase(it);
+        ++statistics.removedCount;
+
+        for (const auto& child : children)
+        {
+            if (stillReferenced.find(child) == stillReferenced.end())
+            {
+                RemoveSubtree(child, stillReferenced, statistics);
+            }
+        }
+    }
+}
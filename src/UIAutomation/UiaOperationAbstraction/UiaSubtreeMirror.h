@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements a client-side mirror of an element subtree that is kept up to date by exchanging only differences with
+// the provider.
+namespace UiaOperationAbstraction
+{
+    struct UiaMirrorNode
+    {
+        std::wstring name;
+        winrt::Windows::Foundation::Rect boundingRectangle{};
+        // The keys of the children, in order.
+        std::vector<std::wstring> children;
+
+        // The strings that the provider side compares against to detect changes. They are produced by the provider
+        // side itself so that they always compare equal when nothing changed.
+        std::wstring childrenSignature;
+        std::wstring boundingRectangleSignature;
+    };
+
+    struct UiaMirrorSyncStatistics
+    {
+        size_t addedCount = 0;
+        size_t removedCount = 0;
+        // Known nodes whose children were added, removed or reordered.
+        size_t childrenChangedCount = 0;
+        // Known nodes whose name or bounding rectangle changed.
+        size_t propertiesChangedCount = 0;
+    };
+
+    // Mirrors the structure, names and bounding rectangles of the subtree under an element. Nodes are keyed by their
+    // Stringify'd runtime ID.
+    //
+    // Each Sync sends the provider the children and properties the mirror currently knows about for every node, as
+    // string maps keyed by runtime ID. The provider walks the live subtree and sends back only the nodes that are
+    // new or whose children or properties differ, which the mirror then applies in place. The walk still visits
+    // every element on the provider side, but what crosses the process boundary and what the client does with it is
+    // proportional to the size of the change.
+    class UiaSubtreeMirror
+    {
+    public:
+        explicit UiaSubtreeMirror(UiaElement root);
+
+        UiaMirrorSyncStatistics Sync();
+
+        // Empty until the first Sync.
+        const std::wstring& GetRootKey() const { return m_rootKey; }
+        const std::map<std::wstring, UiaMirrorNode>& GetNodes() const { return m_nodes; }
+
+    private:
+        // Removes the node and, unless they were moved elsewhere, its descendants.
+        void RemoveSubtree(const std::wstring& key, const std::set<std::wstring>& stillReferenced, UiaMirrorSyncStatistics& statistics);
+
+        UiaElement m_root;
+        std::wstring m_rootKey;
+        std::map<std::wstring, UiaMirrorNode> m_nodes;
+    };
+}
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include "UiaTreeQueries.h"
+
+namespace UiaOperationAbstraction
+{
+    UiaBool RectContainsPoint(UiaRect rect, UiaDouble x, UiaDouble y)
+    {
+        UiaDouble right = rect.GetX();
+        right += rect.GetWidth();
+        UiaDouble bottom = rect.GetY();
+        bottom += rect.GetHeight();
+
+        return rect.GetX() <= x && x < right && rect.GetY() <= y && y < bottom;
+    }
+
+    UiaHitTestResult HitTest(UiaOperationScope& scope, UiaElement root, winrt::Windows::Foundation::Point point)
+    {
+        const UiaDouble x = static_cast<double>(point.X);
+        const UiaDouble y = static_cast<double>(point.Y);
+
+        // Start from a fresh element rather than a copy of root, so that descending doesn't overwrite the caller's
+        // root when running remotely.
+        UiaHitTestResult result{ false, UiaElement{ static_cast<IUIAutomationElement*>(nullptr) }, UiaArray<UiaElement>{} };
+        result.element = root;
+
+        scope.If(RectContainsPoint(root.GetBoundingRectangle(), x, y), [&]()
+        {
+            result.found = true;
+            result.chain.Append(root);
+
+            UiaBool descend = true;
+            scope.While([&]()
+            {
+                return descend;
+            },
+            [&]()
+            {
+                descend = false;
+
+                UiaElement child = result.element.GetFirstChildElement();
+                scope.While([&]()
+                {
+                    return !child.IsNull();
+                },
+                [&]()
+                {
+                    scope.If(RectContainsPoint(child.GetBoundingRectangle(), x, y), [&]()
+                    {
+                        result.element = child;
+                        result.chain.Append(child);
+                        descend = true;
+                        scope.Break();
+                    });
+
+                    child = child.GetNextSiblingElement();
+                });
+            });
+        });
+
+        return result;
+    }
+
+    UiaDouble Min(UiaOperationScope& scope, UiaDouble lhs, UiaDouble rhs)
+    {
+        // Assign into a fresh value rather than copying lhs, which would share (and then overwrite) its remote
+        // operand.
+        UiaDouble result = 0.0;
+        result = lhs;
+        scope.If(rhs < lhs, [&]()
+        {
+            result = rhs;
+        });
+        return result;
+    }
+
+    UiaDouble Max(UiaOperationScope& scope, UiaDouble lhs, UiaDouble rhs)
+    {
+        UiaDouble result = 0.0;
+        result = lhs;
+        scope.If(rhs > lhs, [&]()
+        {
+            result = rhs;
+        });
+        return result;
+    }
+
+    std::vector<winrt::Windows::Foundation::Rect> UiaVisibleElements::GetVisibleRectangles() const
+    {
+        const auto& bounds = *visibleBounds;
+
+        std::vector<winrt::Windows::Foundation::Rect> rectangles;
+        rectangles.reserve(bounds.size() / 4);
+        for (size_t i = 0; i + 3 < bounds.size(); i += 4)
+        {
+            rectangles.push_back({
+                static_cast<float>(bounds[i]),
+                static_cast<float>(bounds[i + 1]),
+                static_cast<float>(bounds[i + 2] - bounds[i]),
+                static_cast<float>(bounds[i + 3] - bounds[i + 1]) });
+        }
+        return rectangles;
+    }
+
+    UiaVisibleElements FindVisibleElements(
+        UiaOperationScope& scope,
+        UiaElement root,
+        std::optional<winrt::Windows::Foundation::Rect> viewport)
+    {
+        UiaVisibleElements result;
+
+        // Walk the subtree breadth first. pending holds the elements still to visit and pendingClips holds the
+        // clip rectangle inherited by each of them, as four edges per element.
+        UiaArray<UiaElement> pending;
+        UiaArray<UiaDouble> pendingClips;
+        UiaUint next = 0;
+
+        pending.Append(root);
+        if (viewport)
+        {
+            pendingClips.Append(static_cast<double>(viewport->X));
+            pendingClips.Append(static_cast<double>(viewport->Y));
+            pendingClips.Append(static_cast<double>(viewport->X + viewport->Width));
+            pendingClips.Append(static_cast<double>(viewport->Y + viewport->Height));
+        }
+        else
+        {
+            // Without a viewport, the root is only clipped by itself.
+            UiaRect rootRect = root.GetBoundingRectangle();
+            UiaDouble right = rootRect.GetX();
+            right += rootRect.GetWidth();
+            UiaDouble bottom = rootRect.GetY();
+            bottom += rootRect.GetHeight();
+
+            pendingClips.Append(rootRect.GetX());
+            pendingClips.Append(rootRect.GetY());
+            pendingClips.Append(right);
+            pendingClips.Append(bottom);
+        }
+
+        scope.While([&]()
+        {
+            return next < pending.Size();
+        },
+        [&]()
+        {
+            UiaElement element = pending.GetAt(next);
+            UiaUint clipIndex = 0;
+            clipIndex = next;
+            clipIndex *= 4;
+            next += 1;
+
+            auto nextClipEdge = [&]()
+            {
+                UiaDouble edge = pendingClips.GetAt(clipIndex);
+                clipIndex += 1;
+                return edge;
+            };
+            const auto clipLeft = nextClipEdge();
+            const auto clipTop = nextClipEdge();
+            const auto clipRight = nextClipEdge();
+            const auto clipBottom = nextClipEdge();
+
+            UiaRect rect = element.GetBoundingRectangle();
+            UiaDouble right = rect.GetX();
+            right += rect.GetWidth();
+            UiaDouble bottom = rect.GetY();
+            bottom += rect.GetHeight();
+
+            const auto left = Max(scope, rect.GetX(), clipLeft);
+            const auto top = Max(scope, rect.GetY(), clipTop);
+            const auto visibleRight = Min(scope, right, clipRight);
+            const auto visibleBottom = Min(scope, bottom, clipBottom);
+
+            scope.If(!element.GetIsOffscreen() && left < visibleRight && top < visibleBottom, [&]()
+            {
+                result.elements.Append(element);
+                result.visibleBounds.Append(left);
+                result.visibleBounds.Append(top);
+                result.visibleBounds.Append(visibleRight);
+                result.visibleBounds.Append(visibleBottom);
+
+                ForEachChildElement(element, [&](UiaElement child)
+                {
+                    pending.Append(child);
+                    pendingClips.Append(left);
+                    pendingClips.Append(top);
+                    pendingClips.Append(visibleRight);
+                    pendingClips.Append(visibleBottom);
+                });
+            });
+        });
+
+        return result;
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements queries over the element tree that run entirely within a single operation.
+//
+// Each query adds its work to the given scope and returns wrappers for its results; bind them with
+// scope.BindResult before resolving the scope, like any other value computed in the scope.
+namespace UiaOperationAbstraction
+{
+    // Returns whether the given point lies within the rectangle. The left and top edges are inside the rectangle
+    // and the right and bottom edges are not, so an empty rectangle contains no points.
+    UiaBool RectContainsPoint(UiaRect rect, UiaDouble x, UiaDouble y);
+
+    struct UiaHitTestResult
+    {
+        // Whether the root contains the point at all.
+        UiaBool found;
+        // The deepest element whose bounding rectangle contains the point, or the root if nothing was found.
+        UiaElement element;
+        // The elements from the root down to and including element. Empty if nothing was found.
+        UiaArray<UiaElement> chain;
+    };
+
+    // Finds the deepest element under the given root whose bounding rectangle contains the point, along with its
+    // ancestor chain.
+    //
+    // At each level this follows the first child whose bounding rectangle contains the point and skips the rest of
+    // its siblings, so the provider is only asked about the children of elements on the path to the result. Where
+    // siblings overlap, the first one in tree order wins.
+    UiaHitTestResult HitTest(UiaOperationScope& scope, UiaElement root, winrt::Windows::Foundation::Point point);
+
+    // Returns the smaller or larger of two values.
+    UiaDouble Min(UiaOperationScope& scope, UiaDouble lhs, UiaDouble rhs);
+    UiaDouble Max(UiaOperationScope& scope, UiaDouble lhs, UiaDouble rhs);
+
+    struct UiaVisibleElements
+    {
+        // The visible elements, parents before their children.
+        UiaArray<UiaElement> elements;
+        // Four values per element: the left, top, right and bottom edges of its visible rectangle.
+        UiaArray<UiaDouble> visibleBounds;
+
+        // Unpacks visibleBounds once the scope has been resolved.
+        std::vector<winrt::Windows::Foundation::Rect> GetVisibleRectangles() const;
+    };
+
+    // Finds the elements in the given subtree that are actually visible, along with the part of each that is
+    // visible, in a single operation.
+    //
+    // Each element's bounding rectangle is clipped by the rectangles of all of its ancestors up to the root (and by
+    // the viewport, if given), with the clip rectangles carried down the traversal on the provider side. Elements
+    // that are offscreen or whose clipped rectangle is empty are left out along with their whole subtree, since a
+    // child can't be visible outside of its parent's clip.
+    UiaVisibleElements FindVisibleElements(
+        UiaOperationScope& scope,
+        UiaElement root,
+        std::optional<winrt::Windows::Foundation::Rect> viewport = std::nullopt);
+}
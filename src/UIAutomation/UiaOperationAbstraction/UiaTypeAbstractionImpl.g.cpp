@@ -65,8 +65,7 @@
 
     void UiaInvokePattern::Invoke()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteInvokePattern>(m_member).Invoke();
             return;
@@ -138,68 +137,44 @@
 
     UiaArray<UiaElement> UiaSelectionPattern::GetSelection(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern>(m_member).GetSelection();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedSelection(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentSelection(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern::GetCachedSelection,
+            &IUIAutomationSelectionPattern::GetCurrentSelection);
     }
 
     UiaBool UiaSelectionPattern::GetCanSelectMultiple(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern>(m_member).GetCanSelectMultiple();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanSelectMultiple(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanSelectMultiple(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern::get_CachedCanSelectMultiple,
+            &IUIAutomationSelectionPattern::get_CurrentCanSelectMultiple);
     }
 
     UiaBool UiaSelectionPattern::GetIsSelectionRequired(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern>(m_member).GetIsSelectionRequired();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsSelectionRequired(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsSelectionRequired(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern::get_CachedIsSelectionRequired,
+            &IUIAutomationSelectionPattern::get_CurrentIsSelectionRequired);
     }
 
     UiaValuePattern::UiaValuePattern(_In_ IUIAutomationValuePattern* pattern):
@@ -265,52 +240,35 @@
 
     UiaString UiaValuePattern::GetValue(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteValuePattern>(m_member).GetValue();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationValuePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedValue(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentValue(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationValuePattern::get_CachedValue,
+            &IUIAutomationValuePattern::get_CurrentValue);
     }
 
     UiaBool UiaValuePattern::GetIsReadOnly(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteValuePattern>(m_member).GetIsReadOnly();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationValuePattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsReadOnly(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsReadOnly(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationValuePattern::get_CachedIsReadOnly,
+            &IUIAutomationValuePattern::get_CurrentIsReadOnly);
     }
 
     void UiaValuePattern::SetValue(UiaString val)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             val.ToRemote();
             std::get<AutomationRemoteValuePattern>(m_member).SetValue(
@@ -385,140 +343,91 @@
 
     UiaDouble UiaRangeValuePattern::GetValue(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetValue();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedValue(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentValue(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedValue,
+            &IUIAutomationRangeValuePattern::get_CurrentValue);
     }
 
     UiaBool UiaRangeValuePattern::GetIsReadOnly(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetIsReadOnly();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsReadOnly(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsReadOnly(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedIsReadOnly,
+            &IUIAutomationRangeValuePattern::get_CurrentIsReadOnly);
     }
 
     UiaDouble UiaRangeValuePattern::GetMaximum(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetMaximum();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedMaximum(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentMaximum(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedMaximum,
+            &IUIAutomationRangeValuePattern::get_CurrentMaximum);
     }
 
     UiaDouble UiaRangeValuePattern::GetMinimum(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetMinimum();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedMinimum(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentMinimum(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedMinimum,
+            &IUIAutomationRangeValuePattern::get_CurrentMinimum);
     }
 
     UiaDouble UiaRangeValuePattern::GetLargeChange(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetLargeChange();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedLargeChange(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentLargeChange(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedLargeChange,
+            &IUIAutomationRangeValuePattern::get_CurrentLargeChange);
     }
 
     UiaDouble UiaRangeValuePattern::GetSmallChange(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteRangeValuePattern>(m_member).GetSmallChange();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedSmallChange(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentSmallChange(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationRangeValuePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationRangeValuePattern::get_CachedSmallChange,
+            &IUIAutomationRangeValuePattern::get_CurrentSmallChange);
     }
 
     void UiaRangeValuePattern::SetValue(UiaDouble val)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             val.ToRemote();
             std::get<AutomationRemoteRangeValuePattern>(m_member).SetValue(
@@ -593,140 +502,91 @@
 
     UiaDouble UiaScrollPattern::GetHorizontalScrollPercent(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetHorizontalScrollPercent();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHorizontalScrollPercent(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHorizontalScrollPercent(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedHorizontalScrollPercent,
+            &IUIAutomationScrollPattern::get_CurrentHorizontalScrollPercent);
     }
 
     UiaDouble UiaScrollPattern::GetVerticalScrollPercent(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetVerticalScrollPercent();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedVerticalScrollPercent(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentVerticalScrollPercent(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedVerticalScrollPercent,
+            &IUIAutomationScrollPattern::get_CurrentVerticalScrollPercent);
     }
 
     UiaDouble UiaScrollPattern::GetHorizontalViewSize(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetHorizontalViewSize();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHorizontalViewSize(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHorizontalViewSize(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedHorizontalViewSize,
+            &IUIAutomationScrollPattern::get_CurrentHorizontalViewSize);
     }
 
     UiaDouble UiaScrollPattern::GetVerticalViewSize(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetVerticalViewSize();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedVerticalViewSize(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentVerticalViewSize(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedVerticalViewSize,
+            &IUIAutomationScrollPattern::get_CurrentVerticalViewSize);
     }
 
     UiaBool UiaScrollPattern::GetHorizontallyScrollable(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetHorizontallyScrollable();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHorizontallyScrollable(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHorizontallyScrollable(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedHorizontallyScrollable,
+            &IUIAutomationScrollPattern::get_CurrentHorizontallyScrollable);
     }
 
     UiaBool UiaScrollPattern::GetVerticallyScrollable(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteScrollPattern>(m_member).GetVerticallyScrollable();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedVerticallyScrollable(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentVerticallyScrollable(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationScrollPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationScrollPattern::get_CachedVerticallyScrollable,
+            &IUIAutomationScrollPattern::get_CurrentVerticallyScrollable);
     }
 
     void UiaScrollPattern::Scroll(UiaScrollAmount horizontalAmount, UiaScrollAmount verticalAmount)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             horizontalAmount.ToRemote();
             verticalAmount.ToRemote();
@@ -743,8 +603,7 @@
 
     void UiaScrollPattern::SetScrollPercent(UiaDouble horizontalPercent, UiaDouble verticalPercent)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             horizontalPercent.ToRemote();
             verticalPercent.ToRemote();
@@ -822,30 +681,21 @@
 
     UiaExpandCollapseState UiaExpandCollapsePattern::GetExpandCollapseState(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteExpandCollapsePattern>(m_member).GetExpandCollapseState();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationExpandCollapsePattern>>(m_member);
-        ExpandCollapseState localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedExpandCollapseState(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentExpandCollapseState(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<ExpandCollapseState>(
+            std::get<winrt::com_ptr<IUIAutomationExpandCollapsePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationExpandCollapsePattern::get_CachedExpandCollapseState,
+            &IUIAutomationExpandCollapsePattern::get_CurrentExpandCollapseState);
     }
 
     void UiaExpandCollapsePattern::Expand()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteExpandCollapsePattern>(m_member).Expand();
             return;
@@ -856,8 +706,7 @@
 
     void UiaExpandCollapsePattern::Collapse()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteExpandCollapsePattern>(m_member).Collapse();
             return;
@@ -929,52 +778,35 @@
 
     UiaInt UiaGridPattern::GetRowCount(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridPattern>(m_member).GetRowCount();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedRowCount(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentRowCount(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridPattern::get_CachedRowCount,
+            &IUIAutomationGridPattern::get_CurrentRowCount);
     }
 
     UiaInt UiaGridPattern::GetColumnCount(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridPattern>(m_member).GetColumnCount();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedColumnCount(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentColumnCount(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridPattern::get_CachedColumnCount,
+            &IUIAutomationGridPattern::get_CurrentColumnCount);
     }
 
     UiaElement UiaGridPattern::GetItem(UiaInt row, UiaInt column)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             row.ToRemote();
             column.ToRemote();
@@ -1054,112 +886,72 @@
 
     UiaElement UiaGridItemPattern::GetContainingGrid(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridItemPattern>(m_member).GetContainingGrid();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedContainingGrid(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentContainingGrid(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridItemPattern::get_CachedContainingGrid,
+            &IUIAutomationGridItemPattern::get_CurrentContainingGrid);
     }
 
     UiaInt UiaGridItemPattern::GetRow(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridItemPattern>(m_member).GetRow();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedRow(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentRow(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridItemPattern::get_CachedRow,
+            &IUIAutomationGridItemPattern::get_CurrentRow);
     }
 
     UiaInt UiaGridItemPattern::GetColumn(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridItemPattern>(m_member).GetColumn();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedColumn(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentColumn(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridItemPattern::get_CachedColumn,
+            &IUIAutomationGridItemPattern::get_CurrentColumn);
     }
 
     UiaInt UiaGridItemPattern::GetRowSpan(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridItemPattern>(m_member).GetRowSpan();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedRowSpan(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentRowSpan(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridItemPattern::get_CachedRowSpan,
+            &IUIAutomationGridItemPattern::get_CurrentRowSpan);
     }
 
     UiaInt UiaGridItemPattern::GetColumnSpan(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteGridItemPattern>(m_member).GetColumnSpan();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedColumnSpan(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentColumnSpan(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationGridItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationGridItemPattern::get_CachedColumnSpan,
+            &IUIAutomationGridItemPattern::get_CurrentColumnSpan);
     }
 
     UiaMultipleViewPattern::UiaMultipleViewPattern(_In_ IUIAutomationMultipleViewPattern* pattern):
@@ -1225,52 +1017,35 @@
 
     UiaInt UiaMultipleViewPattern::GetCurrentView(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteMultipleViewPattern>(m_member).GetCurrentView();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationMultipleViewPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCurrentView(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCurrentView(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationMultipleViewPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationMultipleViewPattern::get_CachedCurrentView,
+            &IUIAutomationMultipleViewPattern::get_CurrentCurrentView);
     }
 
     UiaArray<UiaInt> UiaMultipleViewPattern::GetSupportedViews(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteMultipleViewPattern>(m_member).GetSupportedViews();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationMultipleViewPattern>>(m_member);
-        unique_safearray localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedSupportedViews(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentSupportedViews(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<unique_safearray>(
+            std::get<winrt::com_ptr<IUIAutomationMultipleViewPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationMultipleViewPattern::GetCachedSupportedViews,
+            &IUIAutomationMultipleViewPattern::GetCurrentSupportedViews);
     }
 
     UiaString UiaMultipleViewPattern::GetViewName(UiaInt view)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             view.ToRemote();
             return std::get<AutomationRemoteMultipleViewPattern>(m_member).GetViewName(
@@ -1286,8 +1061,7 @@
 
     void UiaMultipleViewPattern::SetCurrentView(UiaInt view)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             view.ToRemote();
             std::get<AutomationRemoteMultipleViewPattern>(m_member).SetCurrentView(
@@ -1362,140 +1136,91 @@
 
     UiaBool UiaWindowPattern::GetCanMaximize(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetCanMaximize();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanMaximize(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanMaximize(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedCanMaximize,
+            &IUIAutomationWindowPattern::get_CurrentCanMaximize);
     }
 
     UiaBool UiaWindowPattern::GetCanMinimize(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetCanMinimize();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanMinimize(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanMinimize(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedCanMinimize,
+            &IUIAutomationWindowPattern::get_CurrentCanMinimize);
     }
 
     UiaBool UiaWindowPattern::GetIsModal(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetIsModal();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsModal(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsModal(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedIsModal,
+            &IUIAutomationWindowPattern::get_CurrentIsModal);
     }
 
     UiaBool UiaWindowPattern::GetIsTopmost(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetIsTopmost();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsTopmost(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsTopmost(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedIsTopmost,
+            &IUIAutomationWindowPattern::get_CurrentIsTopmost);
     }
 
     UiaWindowVisualState UiaWindowPattern::GetWindowVisualState(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetWindowVisualState();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        WindowVisualState localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedWindowVisualState(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentWindowVisualState(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<WindowVisualState>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedWindowVisualState,
+            &IUIAutomationWindowPattern::get_CurrentWindowVisualState);
     }
 
     UiaWindowInteractionState UiaWindowPattern::GetWindowInteractionState(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteWindowPattern>(m_member).GetWindowInteractionState();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member);
-        WindowInteractionState localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedWindowInteractionState(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentWindowInteractionState(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<WindowInteractionState>(
+            std::get<winrt::com_ptr<IUIAutomationWindowPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationWindowPattern::get_CachedWindowInteractionState,
+            &IUIAutomationWindowPattern::get_CurrentWindowInteractionState);
     }
 
     void UiaWindowPattern::Close()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteWindowPattern>(m_member).Close();
             return;
@@ -1506,8 +1231,7 @@
 
     UiaBool UiaWindowPattern::WaitForInputIdle(UiaInt milliseconds)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             milliseconds.ToRemote();
             return std::get<AutomationRemoteWindowPattern>(m_member).WaitForInputIdle(
@@ -1523,8 +1247,7 @@
 
     void UiaWindowPattern::SetWindowVisualState(UiaWindowVisualState state)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             state.ToRemote();
             std::get<AutomationRemoteWindowPattern>(m_member).SetWindowVisualState(
@@ -1599,52 +1322,35 @@
 
     UiaBool UiaSelectionItemPattern::GetIsSelected(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionItemPattern>(m_member).GetIsSelected();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionItemPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsSelected(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsSelected(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionItemPattern::get_CachedIsSelected,
+            &IUIAutomationSelectionItemPattern::get_CurrentIsSelected);
     }
 
     UiaElement UiaSelectionItemPattern::GetSelectionContainer(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionItemPattern>(m_member).GetSelectionContainer();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionItemPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedSelectionContainer(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentSelectionContainer(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionItemPattern::get_CachedSelectionContainer,
+            &IUIAutomationSelectionItemPattern::get_CurrentSelectionContainer);
     }
 
     void UiaSelectionItemPattern::Select()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteSelectionItemPattern>(m_member).Select();
             return;
@@ -1655,8 +1361,7 @@
 
     void UiaSelectionItemPattern::AddToSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteSelectionItemPattern>(m_member).AddToSelection();
             return;
@@ -1667,8 +1372,7 @@
 
     void UiaSelectionItemPattern::RemoveFromSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteSelectionItemPattern>(m_member).RemoveFromSelection();
             return;
@@ -1740,30 +1444,21 @@
 
     UiaDockPosition UiaDockPattern::GetDockPosition(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDockPattern>(m_member).GetDockPosition();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDockPattern>>(m_member);
-        DockPosition localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDockPosition(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDockPosition(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<DockPosition>(
+            std::get<winrt::com_ptr<IUIAutomationDockPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDockPattern::get_CachedDockPosition,
+            &IUIAutomationDockPattern::get_CurrentDockPosition);
     }
 
     void UiaDockPattern::SetDockPosition(UiaDockPosition dockPos)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             dockPos.ToRemote();
             std::get<AutomationRemoteDockPattern>(m_member).SetDockPosition(
@@ -1838,68 +1533,44 @@
 
     UiaArray<UiaElement> UiaTablePattern::GetRowHeaders(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTablePattern>(m_member).GetRowHeaders();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedRowHeaders(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentRowHeaders(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTablePattern::GetCachedRowHeaders,
+            &IUIAutomationTablePattern::GetCurrentRowHeaders);
     }
 
     UiaArray<UiaElement> UiaTablePattern::GetColumnHeaders(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTablePattern>(m_member).GetColumnHeaders();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedColumnHeaders(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentColumnHeaders(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTablePattern::GetCachedColumnHeaders,
+            &IUIAutomationTablePattern::GetCurrentColumnHeaders);
     }
 
     UiaRowOrColumnMajor UiaTablePattern::GetRowOrColumnMajor(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTablePattern>(m_member).GetRowOrColumnMajor();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member);
-        RowOrColumnMajor localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedRowOrColumnMajor(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentRowOrColumnMajor(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<RowOrColumnMajor>(
+            std::get<winrt::com_ptr<IUIAutomationTablePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTablePattern::get_CachedRowOrColumnMajor,
+            &IUIAutomationTablePattern::get_CurrentRowOrColumnMajor);
     }
 
     UiaTableItemPattern::UiaTableItemPattern(_In_ IUIAutomationTableItemPattern* pattern):
@@ -1965,46 +1636,30 @@
 
     UiaArray<UiaElement> UiaTableItemPattern::GetRowHeaderItems(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTableItemPattern>(m_member).GetRowHeaderItems();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTableItemPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedRowHeaderItems(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentRowHeaderItems(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationTableItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTableItemPattern::GetCachedRowHeaderItems,
+            &IUIAutomationTableItemPattern::GetCurrentRowHeaderItems);
     }
 
     UiaArray<UiaElement> UiaTableItemPattern::GetColumnHeaderItems(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTableItemPattern>(m_member).GetColumnHeaderItems();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTableItemPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedColumnHeaderItems(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentColumnHeaderItems(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationTableItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTableItemPattern::GetCachedColumnHeaderItems,
+            &IUIAutomationTableItemPattern::GetCurrentColumnHeaderItems);
     }
 
     UiaTextRange::UiaTextRange(_In_ IUIAutomationTextRange* object):
@@ -2078,8 +1733,7 @@
 
     UiaTextRange UiaTextRange::Clone()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteTextRange>(m_member).Clone();
@@ -2093,8 +1747,7 @@
 
     UiaBool UiaTextRange::Compare(UiaTextRange range)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             range.ToRemote();
@@ -2111,8 +1764,7 @@
 
     UiaInt UiaTextRange::CompareEndpoints(UiaTextPatternRangeEndpoint srcEndPoint, UiaTextRange range, UiaTextPatternRangeEndpoint targetEndPoint)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             srcEndPoint.ToRemote();
@@ -2135,8 +1787,7 @@
 
     void UiaTextRange::ExpandToEnclosingUnit(UiaTextUnit TextUnit)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             TextUnit.ToRemote();
@@ -2151,8 +1802,7 @@
 
     UiaTextRange UiaTextRange::FindAttribute(UiaTextAttributeId attr, UiaVariant val, UiaBool backward)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             attr.ToRemote();
@@ -2175,8 +1825,7 @@
 
     UiaTextRange UiaTextRange::FindText(UiaString text, UiaBool backward, UiaBool ignoreCase)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             text.ToRemote();
@@ -2199,8 +1848,7 @@
 
     UiaVariant UiaTextRange::GetAttributeValue(UiaTextAttributeId attr)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             attr.ToRemote();
@@ -2217,8 +1865,7 @@
 
     UiaArray<UiaRect> UiaTextRange::GetBoundingRectangles()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteTextRange>(m_member).GetBoundingRectangles();
@@ -2232,8 +1879,7 @@
 
     UiaElement UiaTextRange::GetEnclosingElement(std::optional<UiaCacheRequest> cacheRequest /* = std::nullopt */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             auto result = std::get<AutomationRemoteTextRange>(m_member).GetEnclosingElement();
@@ -2261,8 +1907,7 @@
 
     UiaString UiaTextRange::GetText(UiaInt maxLength)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             maxLength.ToRemote();
@@ -2279,8 +1924,7 @@
 
     UiaInt UiaTextRange::Move(UiaTextUnit unit, UiaInt count)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             unit.ToRemote();
@@ -2300,8 +1944,7 @@
 
     UiaInt UiaTextRange::MoveEndpointByUnit(UiaTextPatternRangeEndpoint endpoint, UiaTextUnit unit, UiaInt count)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             endpoint.ToRemote();
@@ -2324,8 +1967,7 @@
 
     void UiaTextRange::MoveEndpointByRange(UiaTextPatternRangeEndpoint srcEndPoint, UiaTextRange range, UiaTextPatternRangeEndpoint targetEndPoint)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             srcEndPoint.ToRemote();
@@ -2346,8 +1988,7 @@
 
     void UiaTextRange::Select()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             std::get<AutomationRemoteTextRange>(m_member).Select();
@@ -2359,8 +2000,7 @@
 
     void UiaTextRange::AddToSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             std::get<AutomationRemoteTextRange>(m_member).AddToSelection();
@@ -2372,8 +2012,7 @@
 
     void UiaTextRange::RemoveFromSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             std::get<AutomationRemoteTextRange>(m_member).RemoveFromSelection();
@@ -2385,8 +2024,7 @@
 
     void UiaTextRange::ScrollIntoView(UiaBool alignToTop)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             alignToTop.ToRemote();
@@ -2401,8 +2039,7 @@
 
     UiaArray<UiaElement> UiaTextRange::GetChildren(std::optional<UiaCacheRequest> cacheRequest /* = std::nullopt */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             auto result = std::get<AutomationRemoteTextRange>(m_member).GetChildren();
@@ -2430,8 +2067,7 @@
 
     void UiaTextRange::ShowContextMenu()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             std::get<AutomationRemoteTextRange>(m_member).ShowContextMenu();
@@ -2504,8 +2140,7 @@
 
     UiaTextRange UiaTextPattern::RangeFromPoint(UiaPoint pt)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             pt.ToRemote();
             return std::get<AutomationRemoteTextPattern>(m_member).RangeFromPoint(
@@ -2521,8 +2156,7 @@
 
     UiaTextRange UiaTextPattern::RangeFromChild(UiaElement child)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             child.ToRemote();
             return std::get<AutomationRemoteTextPattern>(m_member).RangeFromChild(
@@ -2538,8 +2172,7 @@
 
     UiaArray<UiaTextRange> UiaTextPattern::GetSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextPattern>(m_member).GetSelection();
         }
@@ -2552,8 +2185,7 @@
 
     UiaArray<UiaTextRange> UiaTextPattern::GetVisibleRanges()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextPattern>(m_member).GetVisibleRanges();
         }
@@ -2566,8 +2198,7 @@
 
     UiaTextRange UiaTextPattern::GetDocumentRange()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextPattern>(m_member).GetDocumentRange();
         }
@@ -2580,8 +2211,7 @@
 
     UiaSupportedTextSelection UiaTextPattern::GetSupportedTextSelection()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextPattern>(m_member).GetSupportedTextSelection();
         }
@@ -2655,30 +2285,21 @@
 
     UiaToggleState UiaTogglePattern::GetToggleState(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTogglePattern>(m_member).GetToggleState();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTogglePattern>>(m_member);
-        ToggleState localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedToggleState(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentToggleState(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<ToggleState>(
+            std::get<winrt::com_ptr<IUIAutomationTogglePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTogglePattern::get_CachedToggleState,
+            &IUIAutomationTogglePattern::get_CurrentToggleState);
     }
 
     void UiaTogglePattern::Toggle()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteTogglePattern>(m_member).Toggle();
             return;
@@ -2750,74 +2371,49 @@
 
     UiaBool UiaTransformPattern::GetCanMove(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern>(m_member).GetCanMove();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanMove(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanMove(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern::get_CachedCanMove,
+            &IUIAutomationTransformPattern::get_CurrentCanMove);
     }
 
     UiaBool UiaTransformPattern::GetCanResize(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern>(m_member).GetCanResize();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanResize(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanResize(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern::get_CachedCanResize,
+            &IUIAutomationTransformPattern::get_CurrentCanResize);
     }
 
     UiaBool UiaTransformPattern::GetCanRotate(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern>(m_member).GetCanRotate();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanRotate(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanRotate(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern::get_CachedCanRotate,
+            &IUIAutomationTransformPattern::get_CurrentCanRotate);
     }
 
     void UiaTransformPattern::Move(UiaDouble x, UiaDouble y)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             x.ToRemote();
             y.ToRemote();
@@ -2834,8 +2430,7 @@
 
     void UiaTransformPattern::Resize(UiaDouble width, UiaDouble height)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             width.ToRemote();
             height.ToRemote();
@@ -2852,8 +2447,7 @@
 
     void UiaTransformPattern::Rotate(UiaDouble degrees)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             degrees.ToRemote();
             std::get<AutomationRemoteTransformPattern>(m_member).Rotate(
@@ -2928,8 +2522,7 @@
 
     void UiaScrollItemPattern::ScrollIntoView()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteScrollItemPattern>(m_member).ScrollIntoView();
             return;
@@ -3001,228 +2594,147 @@
 
     UiaInt UiaLegacyIAccessiblePattern::GetChildId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetChildId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedChildId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentChildId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedChildId,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentChildId);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetName(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetName();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedName(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentName(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedName,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentName);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetValue(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetValue();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedValue(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentValue(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedValue,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentValue);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetDescription(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetDescription();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDescription(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDescription(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedDescription,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentDescription);
     }
 
     UiaUint UiaLegacyIAccessiblePattern::GetRole(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetRole();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        DWORD localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedRole(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentRole(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<DWORD>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedRole,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentRole);
     }
 
     UiaUint UiaLegacyIAccessiblePattern::GetState(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetState();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        DWORD localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedState(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentState(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<DWORD>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedState,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentState);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetHelp(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetHelp();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHelp(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHelp(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedHelp,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentHelp);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetKeyboardShortcut(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetKeyboardShortcut();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedKeyboardShortcut(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentKeyboardShortcut(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedKeyboardShortcut,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentKeyboardShortcut);
     }
 
     UiaArray<UiaElement> UiaLegacyIAccessiblePattern::GetSelection(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetSelection();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedSelection(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentSelection(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::GetCachedSelection,
+            &IUIAutomationLegacyIAccessiblePattern::GetCurrentSelection);
     }
 
     UiaString UiaLegacyIAccessiblePattern::GetDefaultAction(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).GetDefaultAction();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDefaultAction(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDefaultAction(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationLegacyIAccessiblePattern::get_CachedDefaultAction,
+            &IUIAutomationLegacyIAccessiblePattern::get_CurrentDefaultAction);
     }
 
     void UiaLegacyIAccessiblePattern::Select(UiaInt flagsSelect)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             flagsSelect.ToRemote();
             std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).Select(
@@ -3236,8 +2748,7 @@
 
     void UiaLegacyIAccessiblePattern::DoDefaultAction()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).DoDefaultAction();
             return;
@@ -3248,8 +2759,7 @@
 
     void UiaLegacyIAccessiblePattern::SetValue(UiaString szValue)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             szValue.ToRemote();
             std::get<AutomationRemoteLegacyIAccessiblePattern>(m_member).SetValue(
@@ -3324,8 +2834,7 @@
 
     UiaElement UiaItemContainerPattern::FindItemByProperty(UiaElement pStartAfter, UiaPropertyId propertyId, UiaVariant value)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             pStartAfter.ToRemote();
             propertyId.ToRemote();
@@ -3408,8 +2917,7 @@
 
     void UiaVirtualizedItemPattern::Realize()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteVirtualizedItemPattern>(m_member).Realize();
             return;
@@ -3481,8 +2989,7 @@
 
     void UiaSynchronizedInputPattern::StartListening(UiaSynchronizedInputType inputType)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             inputType.ToRemote();
             std::get<AutomationRemoteSynchronizedInputPattern>(m_member).StartListening(
@@ -3496,8 +3003,7 @@
 
     void UiaSynchronizedInputPattern::Cancel()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             std::get<AutomationRemoteSynchronizedInputPattern>(m_member).Cancel();
             return;
@@ -3569,112 +3075,72 @@
 
     UiaAnnotationType UiaAnnotationPattern::GetAnnotationTypeId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteAnnotationPattern>(m_member).GetAnnotationTypeId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAnnotationTypeId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAnnotationTypeId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationAnnotationPattern::get_CachedAnnotationTypeId,
+            &IUIAutomationAnnotationPattern::get_CurrentAnnotationTypeId);
     }
 
     UiaString UiaAnnotationPattern::GetAnnotationTypeName(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteAnnotationPattern>(m_member).GetAnnotationTypeName();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAnnotationTypeName(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAnnotationTypeName(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationAnnotationPattern::get_CachedAnnotationTypeName,
+            &IUIAutomationAnnotationPattern::get_CurrentAnnotationTypeName);
     }
 
     UiaString UiaAnnotationPattern::GetAuthor(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteAnnotationPattern>(m_member).GetAuthor();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAuthor(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAuthor(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationAnnotationPattern::get_CachedAuthor,
+            &IUIAutomationAnnotationPattern::get_CurrentAuthor);
     }
 
     UiaString UiaAnnotationPattern::GetDateTime(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteAnnotationPattern>(m_member).GetDateTime();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDateTime(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDateTime(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationAnnotationPattern::get_CachedDateTime,
+            &IUIAutomationAnnotationPattern::get_CurrentDateTime);
     }
 
     UiaElement UiaAnnotationPattern::GetTarget(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteAnnotationPattern>(m_member).GetTarget();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedTarget(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentTarget(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationAnnotationPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationAnnotationPattern::get_CachedTarget,
+            &IUIAutomationAnnotationPattern::get_CurrentTarget);
     }
 
     UiaTextPattern2::UiaTextPattern2(_In_ IUIAutomationTextPattern2* pattern):
@@ -3740,8 +3206,7 @@
 
     UiaTextRange UiaTextPattern2::RangeFromAnnotation(UiaElement annotation)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             annotation.ToRemote();
             return std::get<AutomationRemoteTextPattern2>(m_member).RangeFromAnnotation(
@@ -3757,8 +3222,7 @@
 
     UiaTextRange UiaTextPattern2::GetCaretRange(UiaBool& isActive)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             isActive.ToRemote();
             return std::get<AutomationRemoteTextPattern2>(m_member).GetCaretRange(
@@ -3835,156 +3299,100 @@
 
     UiaStyleId UiaStylesPattern::GetStyleId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetStyleId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedStyleId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentStyleId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedStyleId,
+            &IUIAutomationStylesPattern::get_CurrentStyleId);
     }
 
     UiaString UiaStylesPattern::GetStyleName(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetStyleName();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedStyleName(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentStyleName(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedStyleName,
+            &IUIAutomationStylesPattern::get_CurrentStyleName);
     }
 
     UiaInt UiaStylesPattern::GetFillColor(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetFillColor();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFillColor(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFillColor(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedFillColor,
+            &IUIAutomationStylesPattern::get_CurrentFillColor);
     }
 
     UiaString UiaStylesPattern::GetFillPatternStyle(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetFillPatternStyle();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFillPatternStyle(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFillPatternStyle(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedFillPatternStyle,
+            &IUIAutomationStylesPattern::get_CurrentFillPatternStyle);
     }
 
     UiaString UiaStylesPattern::GetShape(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetShape();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedShape(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentShape(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedShape,
+            &IUIAutomationStylesPattern::get_CurrentShape);
     }
 
     UiaInt UiaStylesPattern::GetFillPatternColor(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetFillPatternColor();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFillPatternColor(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFillPatternColor(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedFillPatternColor,
+            &IUIAutomationStylesPattern::get_CurrentFillPatternColor);
     }
 
     UiaString UiaStylesPattern::GetExtendedProperties(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteStylesPattern>(m_member).GetExtendedProperties();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedExtendedProperties(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentExtendedProperties(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationStylesPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationStylesPattern::get_CachedExtendedProperties,
+            &IUIAutomationStylesPattern::get_CurrentExtendedProperties);
     }
 
     UiaSpreadsheetPattern::UiaSpreadsheetPattern(_In_ IUIAutomationSpreadsheetPattern* pattern):
@@ -4050,8 +3458,7 @@
 
     UiaElement UiaSpreadsheetPattern::GetItemByName(UiaString name)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             name.ToRemote();
             return std::get<AutomationRemoteSpreadsheetPattern>(m_member).GetItemByName(
@@ -4128,68 +3535,44 @@
 
     UiaString UiaSpreadsheetItemPattern::GetFormula(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSpreadsheetItemPattern>(m_member).GetFormula();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFormula(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFormula(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSpreadsheetItemPattern::get_CachedFormula,
+            &IUIAutomationSpreadsheetItemPattern::get_CurrentFormula);
     }
 
     UiaArray<UiaElement> UiaSpreadsheetItemPattern::GetAnnotationObjects(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSpreadsheetItemPattern>(m_member).GetAnnotationObjects();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedAnnotationObjects(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentAnnotationObjects(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSpreadsheetItemPattern::GetCachedAnnotationObjects,
+            &IUIAutomationSpreadsheetItemPattern::GetCurrentAnnotationObjects);
     }
 
     UiaArray<UiaAnnotationType> UiaSpreadsheetItemPattern::GetAnnotationTypes(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSpreadsheetItemPattern>(m_member).GetAnnotationTypes();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member);
-        unique_safearray localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedAnnotationTypes(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentAnnotationTypes(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<unique_safearray>(
+            std::get<winrt::com_ptr<IUIAutomationSpreadsheetItemPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationSpreadsheetItemPattern::GetCachedAnnotationTypes,
+            &IUIAutomationSpreadsheetItemPattern::GetCurrentAnnotationTypes);
     }
 
     UiaTransformPattern2::UiaTransformPattern2(_In_ IUIAutomationTransformPattern2* pattern):
@@ -4255,96 +3638,63 @@
 
     UiaBool UiaTransformPattern2::GetCanZoom(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern2>(m_member).GetCanZoom();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCanZoom(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCanZoom(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern2::get_CachedCanZoom,
+            &IUIAutomationTransformPattern2::get_CurrentCanZoom);
     }
 
     UiaDouble UiaTransformPattern2::GetZoomLevel(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern2>(m_member).GetZoomLevel();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedZoomLevel(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentZoomLevel(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern2::get_CachedZoomLevel,
+            &IUIAutomationTransformPattern2::get_CurrentZoomLevel);
     }
 
     UiaDouble UiaTransformPattern2::GetZoomMinimum(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern2>(m_member).GetZoomMinimum();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedZoomMinimum(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentZoomMinimum(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern2::get_CachedZoomMinimum,
+            &IUIAutomationTransformPattern2::get_CurrentZoomMinimum);
     }
 
     UiaDouble UiaTransformPattern2::GetZoomMaximum(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTransformPattern2>(m_member).GetZoomMaximum();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member);
-        double localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedZoomMaximum(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentZoomMaximum(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<double>(
+            std::get<winrt::com_ptr<IUIAutomationTransformPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationTransformPattern2::get_CachedZoomMaximum,
+            &IUIAutomationTransformPattern2::get_CurrentZoomMaximum);
     }
 
     void UiaTransformPattern2::Zoom(UiaDouble zoomValue)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             zoomValue.ToRemote();
             std::get<AutomationRemoteTransformPattern2>(m_member).Zoom(
@@ -4358,8 +3708,7 @@
 
     void UiaTransformPattern2::ZoomByUnit(UiaZoomUnit ZoomUnit)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             ZoomUnit.ToRemote();
             std::get<AutomationRemoteTransformPattern2>(m_member).ZoomByUnit(
@@ -4434,8 +3783,7 @@
 
     UiaElement UiaTextChildPattern::GetTextContainer()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextChildPattern>(m_member).GetTextContainer();
         }
@@ -4448,8 +3796,7 @@
 
     UiaTextRange UiaTextChildPattern::GetTextRange()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextChildPattern>(m_member).GetTextRange();
         }
@@ -4523,90 +3870,58 @@
 
     UiaBool UiaDragPattern::GetIsGrabbed(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDragPattern>(m_member).GetIsGrabbed();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsGrabbed(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsGrabbed(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDragPattern::get_CachedIsGrabbed,
+            &IUIAutomationDragPattern::get_CurrentIsGrabbed);
     }
 
     UiaString UiaDragPattern::GetDropEffect(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDragPattern>(m_member).GetDropEffect();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDropEffect(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDropEffect(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDragPattern::get_CachedDropEffect,
+            &IUIAutomationDragPattern::get_CurrentDropEffect);
     }
 
     UiaArray<UiaString> UiaDragPattern::GetDropEffects(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDragPattern>(m_member).GetDropEffects();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member);
-        unique_safearray localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDropEffects(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDropEffects(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<unique_safearray>(
+            std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDragPattern::get_CachedDropEffects,
+            &IUIAutomationDragPattern::get_CurrentDropEffects);
     }
 
     UiaArray<UiaElement> UiaDragPattern::GetGrabbedItems(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDragPattern>(m_member).GetGrabbedItems();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->GetCachedGrabbedItems(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->GetCurrentGrabbedItems(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationDragPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDragPattern::GetCachedGrabbedItems,
+            &IUIAutomationDragPattern::GetCurrentGrabbedItems);
     }
 
     UiaDropTargetPattern::UiaDropTargetPattern(_In_ IUIAutomationDropTargetPattern* pattern):
@@ -4672,46 +3987,30 @@
 
     UiaString UiaDropTargetPattern::GetDropTargetEffect(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDropTargetPattern>(m_member).GetDropTargetEffect();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDropTargetPattern>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDropTargetEffect(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDropTargetEffect(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationDropTargetPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDropTargetPattern::get_CachedDropTargetEffect,
+            &IUIAutomationDropTargetPattern::get_CurrentDropTargetEffect);
     }
 
     UiaArray<UiaString> UiaDropTargetPattern::GetDropTargetEffects(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteDropTargetPattern>(m_member).GetDropTargetEffects();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationDropTargetPattern>>(m_member);
-        unique_safearray localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDropTargetEffects(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDropTargetEffects(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<unique_safearray>(
+            std::get<winrt::com_ptr<IUIAutomationDropTargetPattern>>(m_member),
+            useCachedApi,
+            &IUIAutomationDropTargetPattern::get_CachedDropTargetEffects,
+            &IUIAutomationDropTargetPattern::get_CurrentDropTargetEffects);
     }
 
     UiaTextEditPattern::UiaTextEditPattern(_In_ IUIAutomationTextEditPattern* pattern):
@@ -4777,8 +4076,7 @@
 
     UiaTextRange UiaTextEditPattern::GetActiveComposition()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextEditPattern>(m_member).GetActiveComposition();
         }
@@ -4791,8 +4089,7 @@
 
     UiaTextRange UiaTextEditPattern::GetConversionTarget()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteTextEditPattern>(m_member).GetConversionTarget();
         }
@@ -4866,8 +4163,7 @@
 
     UiaElement UiaCustomNavigationPattern::Navigate(UiaNavigateDirection direction)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             direction.ToRemote();
             return std::get<AutomationRemoteCustomNavigationPattern>(m_member).Navigate(
@@ -4944,90 +4240,58 @@
 
     UiaElement UiaSelectionPattern2::GetFirstSelectedItem(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern2>(m_member).GetFirstSelectedItem();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFirstSelectedItem(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFirstSelectedItem(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern2::get_CachedFirstSelectedItem,
+            &IUIAutomationSelectionPattern2::get_CurrentFirstSelectedItem);
     }
 
     UiaElement UiaSelectionPattern2::GetLastSelectedItem(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern2>(m_member).GetLastSelectedItem();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedLastSelectedItem(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentLastSelectedItem(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern2::get_CachedLastSelectedItem,
+            &IUIAutomationSelectionPattern2::get_CurrentLastSelectedItem);
     }
 
     UiaElement UiaSelectionPattern2::GetCurrentSelectedItem(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern2>(m_member).GetCurrentSelectedItem();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCurrentSelectedItem(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCurrentSelectedItem(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern2::get_CachedCurrentSelectedItem,
+            &IUIAutomationSelectionPattern2::get_CurrentCurrentSelectedItem);
     }
 
     UiaInt UiaSelectionPattern2::GetItemCount(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             return std::get<AutomationRemoteSelectionPattern2>(m_member).GetItemCount();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedItemCount(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentItemCount(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationSelectionPattern2>>(m_member),
+            useCachedApi,
+            &IUIAutomationSelectionPattern2::get_CachedItemCount,
+            &IUIAutomationSelectionPattern2::get_CurrentItemCount);
     }
 
     UiaElement::UiaElement(_In_ IUIAutomationElement* element):
@@ -5101,8 +4365,7 @@
 
     UiaArray<UiaInt> UiaElement::GetRuntimeId()
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetRuntimeId();
@@ -5116,8 +4379,7 @@
 
     UiaVariant UiaElement::GetPropertyValue(UiaPropertyId propId, UiaBool ignoreDefault /* = false */, bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             propId.ToRemote();
@@ -5141,1876 +4403,1139 @@
 
     UiaInt UiaElement::GetProcessId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetProcessId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedProcessId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentProcessId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedProcessId,
+            &IUIAutomationElement::get_CurrentProcessId);
     }
 
     UiaControlType UiaElement::GetControlType(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetControlType();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        CONTROLTYPEID localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedControlType(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentControlType(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<CONTROLTYPEID>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedControlType,
+            &IUIAutomationElement::get_CurrentControlType);
     }
 
     UiaString UiaElement::GetLocalizedControlType(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLocalizedControlType();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedLocalizedControlType(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentLocalizedControlType(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedLocalizedControlType,
+            &IUIAutomationElement::get_CurrentLocalizedControlType);
     }
 
     UiaString UiaElement::GetName(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetName();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedName(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentName(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedName,
+            &IUIAutomationElement::get_CurrentName);
     }
 
     UiaString UiaElement::GetAcceleratorKey(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAcceleratorKey();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAcceleratorKey(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAcceleratorKey(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedAcceleratorKey,
+            &IUIAutomationElement::get_CurrentAcceleratorKey);
     }
 
     UiaString UiaElement::GetAccessKey(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAccessKey();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAccessKey(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAccessKey(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedAccessKey,
+            &IUIAutomationElement::get_CurrentAccessKey);
     }
 
     UiaBool UiaElement::GetHasKeyboardFocus(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetHasKeyboardFocus();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHasKeyboardFocus(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHasKeyboardFocus(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedHasKeyboardFocus,
+            &IUIAutomationElement::get_CurrentHasKeyboardFocus);
     }
 
     UiaBool UiaElement::GetIsKeyboardFocusable(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsKeyboardFocusable();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsKeyboardFocusable(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsKeyboardFocusable(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsKeyboardFocusable,
+            &IUIAutomationElement::get_CurrentIsKeyboardFocusable);
     }
 
     UiaBool UiaElement::GetIsEnabled(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsEnabled();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsEnabled(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsEnabled(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsEnabled,
+            &IUIAutomationElement::get_CurrentIsEnabled);
     }
 
     UiaString UiaElement::GetAutomationId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAutomationId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAutomationId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAutomationId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedAutomationId,
+            &IUIAutomationElement::get_CurrentAutomationId);
     }
 
     UiaString UiaElement::GetClassName(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetClassName();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedClassName(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentClassName(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedClassName,
+            &IUIAutomationElement::get_CurrentClassName);
     }
 
     UiaString UiaElement::GetHelpText(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetHelpText();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedHelpText(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentHelpText(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedHelpText,
+            &IUIAutomationElement::get_CurrentHelpText);
     }
 
     UiaInt UiaElement::GetCulture(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetCulture();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedCulture(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentCulture(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedCulture,
+            &IUIAutomationElement::get_CurrentCulture);
     }
 
     UiaBool UiaElement::GetIsControlElement(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsControlElement();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsControlElement(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsControlElement(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsControlElement,
+            &IUIAutomationElement::get_CurrentIsControlElement);
     }
 
     UiaBool UiaElement::GetIsContentElement(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsContentElement();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsContentElement(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsContentElement(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsContentElement,
+            &IUIAutomationElement::get_CurrentIsContentElement);
     }
 
     UiaBool UiaElement::GetIsPassword(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsPassword();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsPassword(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsPassword(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsPassword,
+            &IUIAutomationElement::get_CurrentIsPassword);
     }
 
     UiaHwnd UiaElement::GetNativeWindowHandle(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetNativeWindowHandle();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        UIA_HWND localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedNativeWindowHandle(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentNativeWindowHandle(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<UIA_HWND>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedNativeWindowHandle,
+            &IUIAutomationElement::get_CurrentNativeWindowHandle);
     }
 
     UiaString UiaElement::GetItemType(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetItemType();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedItemType(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentItemType(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedItemType,
+            &IUIAutomationElement::get_CurrentItemType);
     }
 
     UiaBool UiaElement::GetIsOffscreen(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsOffscreen();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsOffscreen(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsOffscreen(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsOffscreen,
+            &IUIAutomationElement::get_CurrentIsOffscreen);
     }
 
     UiaOrientationType UiaElement::GetOrientation(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetOrientation();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        OrientationType localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedOrientation(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentOrientation(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<OrientationType>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedOrientation,
+            &IUIAutomationElement::get_CurrentOrientation);
     }
 
     UiaString UiaElement::GetFrameworkId(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetFrameworkId();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFrameworkId(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFrameworkId(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedFrameworkId,
+            &IUIAutomationElement::get_CurrentFrameworkId);
     }
 
     UiaBool UiaElement::GetIsRequiredForForm(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsRequiredForForm();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsRequiredForForm(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentIsRequiredForForm(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsRequiredForForm,
+            &IUIAutomationElement::get_CurrentIsRequiredForForm);
     }
 
     UiaString UiaElement::GetItemStatus(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetItemStatus();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedItemStatus(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentItemStatus(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedItemStatus,
+            &IUIAutomationElement::get_CurrentItemStatus);
     }
 
     UiaRect UiaElement::GetBoundingRectangle(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetBoundingRectangle();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        RECT localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedBoundingRectangle(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentBoundingRectangle(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<RECT>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedBoundingRectangle,
+            &IUIAutomationElement::get_CurrentBoundingRectangle);
     }
 
     UiaElement UiaElement::GetLabeledBy(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLabeledBy();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElement> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedLabeledBy(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentLabeledBy(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElement>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedLabeledBy,
+            &IUIAutomationElement::get_CurrentLabeledBy);
     }
 
     UiaString UiaElement::GetAriaRole(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAriaRole();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAriaRole(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAriaRole(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedAriaRole,
+            &IUIAutomationElement::get_CurrentAriaRole);
     }
 
     UiaString UiaElement::GetAriaProperties(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAriaProperties();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedAriaProperties(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentAriaProperties(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedAriaProperties,
+            &IUIAutomationElement::get_CurrentAriaProperties);
     }
 
     UiaBool UiaElement::GetIsDataValidForForm(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
-        {
-            this->ToRemote();
-            return std::get<AutomationRemoteElement>(m_member).GetIsDataValidForForm();
-        }
-
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedIsDataValidForForm(&localPropertyValue));
-        }
-        else
+        if (ShouldUseRemoteApi())
         {
-            winrt::check_hresult(localObject->get_CurrentIsDataValidForForm(&localPropertyValue));
+            this->ToRemote();
+            return std::get<AutomationRemoteElement>(m_member).GetIsDataValidForForm();
         }
 
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedIsDataValidForForm,
+            &IUIAutomationElement::get_CurrentIsDataValidForForm);
     }
 
     UiaArray<UiaElement> UiaElement::GetControllerFor(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetControllerFor();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedControllerFor(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentControllerFor(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedControllerFor,
+            &IUIAutomationElement::get_CurrentControllerFor);
     }
 
     UiaArray<UiaElement> UiaElement::GetDescribedBy(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetDescribedBy();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedDescribedBy(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentDescribedBy(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedDescribedBy,
+            &IUIAutomationElement::get_CurrentDescribedBy);
     }
 
     UiaArray<UiaElement> UiaElement::GetFlowsTo(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetFlowsTo();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedFlowsTo(localPropertyValue.put()));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentFlowsTo(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedFlowsTo,
+            &IUIAutomationElement::get_CurrentFlowsTo);
     }
 
     UiaString UiaElement::GetProviderDescription(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetProviderDescription();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localObject->get_CachedProviderDescription(&localPropertyValue));
-        }
-        else
-        {
-            winrt::check_hresult(localObject->get_CurrentProviderDescription(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement::get_CachedProviderDescription,
+            &IUIAutomationElement::get_CurrentProviderDescription);
     }
 
     UiaBool UiaElement::GetOptimizeForVisualContent(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetOptimizeForVisualContent();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CachedOptimizeForVisualContent(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CurrentOptimizeForVisualContent(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement2::get_CachedOptimizeForVisualContent,
+            &IUIAutomationElement2::get_CurrentOptimizeForVisualContent);
     }
 
     UiaLiveSetting UiaElement::GetLiveSetting(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLiveSetting();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        LiveSetting localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CachedLiveSetting(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CurrentLiveSetting(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<LiveSetting>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement2::get_CachedLiveSetting,
+            &IUIAutomationElement2::get_CurrentLiveSetting);
     }
 
     UiaArray<UiaElement> UiaElement::GetFlowsFrom(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetFlowsFrom();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CachedFlowsFrom(localPropertyValue.put()));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement2>();
-            winrt::check_hresult(localObjectQueried->get_CurrentFlowsFrom(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement2::get_CachedFlowsFrom,
+            &IUIAutomationElement2::get_CurrentFlowsFrom);
     }
 
     UiaBool UiaElement::GetIsPeripheral(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsPeripheral();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement3>();
-            winrt::check_hresult(localObjectQueried->get_CachedIsPeripheral(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement3>();
-            winrt::check_hresult(localObjectQueried->get_CurrentIsPeripheral(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement3::get_CachedIsPeripheral,
+            &IUIAutomationElement3::get_CurrentIsPeripheral);
     }
 
     UiaInt UiaElement::GetPositionInSet(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetPositionInSet();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CachedPositionInSet(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CurrentPositionInSet(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement4::get_CachedPositionInSet,
+            &IUIAutomationElement4::get_CurrentPositionInSet);
     }
 
     UiaInt UiaElement::GetSizeOfSet(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSizeOfSet();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CachedSizeOfSet(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CurrentSizeOfSet(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement4::get_CachedSizeOfSet,
+            &IUIAutomationElement4::get_CurrentSizeOfSet);
     }
 
     UiaInt UiaElement::GetLevel(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLevel();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        int localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CachedLevel(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CurrentLevel(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<int>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement4::get_CachedLevel,
+            &IUIAutomationElement4::get_CurrentLevel);
     }
 
     UiaArray<UiaAnnotationType> UiaElement::GetAnnotationTypes(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAnnotationTypes();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        unique_safearray localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CachedAnnotationTypes(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CurrentAnnotationTypes(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<unique_safearray>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement4::get_CachedAnnotationTypes,
+            &IUIAutomationElement4::get_CurrentAnnotationTypes);
     }
 
     UiaArray<UiaElement> UiaElement::GetAnnotationObjects(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAnnotationObjects();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        winrt::com_ptr<IUIAutomationElementArray> localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CachedAnnotationObjects(localPropertyValue.put()));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement4>();
-            winrt::check_hresult(localObjectQueried->get_CurrentAnnotationObjects(localPropertyValue.put()));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<winrt::com_ptr<IUIAutomationElementArray>>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement4::get_CachedAnnotationObjects,
+            &IUIAutomationElement4::get_CurrentAnnotationObjects);
     }
 
     UiaLandmarkType UiaElement::GetLandmarkType(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLandmarkType();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        LANDMARKTYPEID localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement5>();
-            winrt::check_hresult(localObjectQueried->get_CachedLandmarkType(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement5>();
-            winrt::check_hresult(localObjectQueried->get_CurrentLandmarkType(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<LANDMARKTYPEID>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement5::get_CachedLandmarkType,
+            &IUIAutomationElement5::get_CurrentLandmarkType);
     }
 
     UiaString UiaElement::GetLocalizedLandmarkType(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLocalizedLandmarkType();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement5>();
-            winrt::check_hresult(localObjectQueried->get_CachedLocalizedLandmarkType(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement5>();
-            winrt::check_hresult(localObjectQueried->get_CurrentLocalizedLandmarkType(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement5::get_CachedLocalizedLandmarkType,
+            &IUIAutomationElement5::get_CurrentLocalizedLandmarkType);
     }
 
     UiaString UiaElement::GetFullDescription(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetFullDescription();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        wil::unique_bstr localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement6>();
-            winrt::check_hresult(localObjectQueried->get_CachedFullDescription(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement6>();
-            winrt::check_hresult(localObjectQueried->get_CurrentFullDescription(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<wil::unique_bstr>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement6::get_CachedFullDescription,
+            &IUIAutomationElement6::get_CurrentFullDescription);
     }
 
     UiaHeadingLevel UiaElement::GetHeadingLevel(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetHeadingLevel();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        HEADINGLEVELID localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement8>();
-            winrt::check_hresult(localObjectQueried->get_CachedHeadingLevel(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement8>();
-            winrt::check_hresult(localObjectQueried->get_CurrentHeadingLevel(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<HEADINGLEVELID>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement8::get_CachedHeadingLevel,
+            &IUIAutomationElement8::get_CurrentHeadingLevel);
     }
 
     UiaBool UiaElement::GetIsDialog(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetIsDialog();
         }
 
-        auto localObject = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
-        BOOL localPropertyValue;
-        if (useCachedApi)
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement9>();
-            winrt::check_hresult(localObjectQueried->get_CachedIsDialog(&localPropertyValue));
-        }
-        else
-        {
-            auto localObjectQueried = localObject.as<IUIAutomationElement9>();
-            winrt::check_hresult(localObjectQueried->get_CurrentIsDialog(&localPropertyValue));
-        }
-
-        return localPropertyValue;
+        return impl::GetComProperty<BOOL>(
+            std::get<winrt::com_ptr<IUIAutomationElement>>(m_member),
+            useCachedApi,
+            &IUIAutomationElement9::get_CachedIsDialog,
+            &IUIAutomationElement9::get_CurrentIsDialog);
     }
 
     UiaInvokePattern UiaElement::GetInvokePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetInvokePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationInvokePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_InvokePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_InvokePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_InvokePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSelectionPattern UiaElement::GetSelectionPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSelectionPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSelectionPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SelectionPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SelectionPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SelectionPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaValuePattern UiaElement::GetValuePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetValuePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationValuePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_ValuePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_ValuePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_ValuePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaRangeValuePattern UiaElement::GetRangeValuePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetRangeValuePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationRangeValuePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_RangeValuePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_RangeValuePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_RangeValuePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaScrollPattern UiaElement::GetScrollPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetScrollPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationScrollPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_ScrollPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_ScrollPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_ScrollPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaExpandCollapsePattern UiaElement::GetExpandCollapsePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetExpandCollapsePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationExpandCollapsePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_ExpandCollapsePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_ExpandCollapsePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_ExpandCollapsePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaGridPattern UiaElement::GetGridPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetGridPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationGridPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_GridPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_GridPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_GridPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaGridItemPattern UiaElement::GetGridItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetGridItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationGridItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_GridItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_GridItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_GridItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaMultipleViewPattern UiaElement::GetMultipleViewPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetMultipleViewPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationMultipleViewPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_MultipleViewPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_MultipleViewPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_MultipleViewPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaWindowPattern UiaElement::GetWindowPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetWindowPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationWindowPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_WindowPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_WindowPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_WindowPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSelectionItemPattern UiaElement::GetSelectionItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSelectionItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSelectionItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SelectionItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SelectionItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SelectionItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaDockPattern UiaElement::GetDockPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetDockPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationDockPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_DockPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_DockPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_DockPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTablePattern UiaElement::GetTablePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTablePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTablePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TablePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TablePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TablePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTableItemPattern UiaElement::GetTableItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTableItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTableItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TableItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TableItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TableItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTextPattern UiaElement::GetTextPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTextPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTextPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TextPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TextPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TextPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTogglePattern UiaElement::GetTogglePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTogglePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTogglePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TogglePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TogglePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TogglePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTransformPattern UiaElement::GetTransformPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTransformPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTransformPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TransformPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TransformPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TransformPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaScrollItemPattern UiaElement::GetScrollItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetScrollItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationScrollItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_ScrollItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_ScrollItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_ScrollItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaLegacyIAccessiblePattern UiaElement::GetLegacyIAccessiblePattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetLegacyIAccessiblePattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationLegacyIAccessiblePattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_LegacyIAccessiblePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_LegacyIAccessiblePatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_LegacyIAccessiblePatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaItemContainerPattern UiaElement::GetItemContainerPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetItemContainerPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationItemContainerPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_ItemContainerPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_ItemContainerPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_ItemContainerPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaVirtualizedItemPattern UiaElement::GetVirtualizedItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetVirtualizedItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationVirtualizedItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_VirtualizedItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_VirtualizedItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_VirtualizedItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSynchronizedInputPattern UiaElement::GetSynchronizedInputPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSynchronizedInputPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSynchronizedInputPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SynchronizedInputPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SynchronizedInputPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SynchronizedInputPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaAnnotationPattern UiaElement::GetAnnotationPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetAnnotationPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationAnnotationPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_AnnotationPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_AnnotationPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_AnnotationPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTextPattern2 UiaElement::GetTextPattern2(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTextPattern2();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTextPattern2> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TextPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TextPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TextPattern2Id, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaStylesPattern UiaElement::GetStylesPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetStylesPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationStylesPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_StylesPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_StylesPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_StylesPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSpreadsheetPattern UiaElement::GetSpreadsheetPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSpreadsheetPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSpreadsheetPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SpreadsheetPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SpreadsheetPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SpreadsheetPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSpreadsheetItemPattern UiaElement::GetSpreadsheetItemPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSpreadsheetItemPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSpreadsheetItemPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SpreadsheetItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SpreadsheetItemPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SpreadsheetItemPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTransformPattern2 UiaElement::GetTransformPattern2(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTransformPattern2();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTransformPattern2> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TransformPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TransformPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TransformPattern2Id, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTextChildPattern UiaElement::GetTextChildPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTextChildPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTextChildPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TextChildPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TextChildPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TextChildPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaDragPattern UiaElement::GetDragPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetDragPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationDragPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_DragPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_DragPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_DragPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaDropTargetPattern UiaElement::GetDropTargetPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetDropTargetPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationDropTargetPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_DropTargetPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_DropTargetPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_DropTargetPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaTextEditPattern UiaElement::GetTextEditPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetTextEditPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationTextEditPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_TextEditPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_TextEditPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_TextEditPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaCustomNavigationPattern UiaElement::GetCustomNavigationPattern(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetCustomNavigationPattern();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationCustomNavigationPattern> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_CustomNavigationPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_CustomNavigationPatternId, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_CustomNavigationPatternId, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaSelectionPattern2 UiaElement::GetSelectionPattern2(bool useCachedApi /* = false */)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetSelectionPattern2();
         }
 
-        auto localElement = std::get<winrt::com_ptr<IUIAutomationElement>>(m_member);
         winrt::com_ptr<IUIAutomationSelectionPattern2> localPattern;
-        if (useCachedApi)
-        {
-            winrt::check_hresult(localElement->GetCachedPatternAs(UIA_SelectionPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-        else
-        {
-            winrt::check_hresult(localElement->GetCurrentPatternAs(UIA_SelectionPattern2Id, IID_PPV_ARGS(localPattern.put())));
-        }
-
+        impl::GetComPattern(std::get<winrt::com_ptr<IUIAutomationElement>>(m_member), useCachedApi, UIA_SelectionPattern2Id, IID_PPV_ARGS(localPattern.put()));
         return localPattern;
     }
 
     UiaElement UiaElement::GetUpdatedCacheElement(UiaCacheRequest cacheRequest)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             ToRemote();
             return std::get<AutomationRemoteElement>(m_member).GetUpdatedCacheElement(cacheRequest);
@@ -7201,8 +5726,7 @@
 
     UiaVariant UiaElement::GetMetadataValue(UiaPropertyId propertyId, UiaMetadata metadataId)
     {
-        auto delegator = UiaOperationScope::GetCurrentDelegator();
-        if (delegator && delegator->GetUseRemoteApi())
+        if (ShouldUseRemoteApi())
         {
             this->ToRemote();
             propertyId.ToRemote();
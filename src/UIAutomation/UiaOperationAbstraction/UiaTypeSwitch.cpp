@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <algorithm>
+
+#include "UiaTypeSwitch.h"
+
+namespace UiaOperationAbstraction
+{
+    void UiaTypeFrequencies::Observe(const UiaVariant& value)
+    {
+        if (value.IsRemoteType())
+        {
+            return;
+        }
+
+        const VARIANT variant = value.get();
+        ++m_counts[V_VT(&variant)];
+    }
+
+    uint64_t UiaTypeFrequencies::Count(VARTYPE type) const
+    {
+        const auto it = m_counts.find(type);
+        return (it != m_counts.end()) ? it->second : 0;
+    }
+
+    UiaTypeSwitch::UiaTypeSwitch(UiaOperationScope& scope, UiaVariant value, const UiaTypeFrequencies* frequencies) :
+        m_scope(scope),
+        m_value(std::move(value)),
+        m_frequencies(frequencies)
+    {
+    }
+
+    UiaTypeSwitch& UiaTypeSwitch::Default(std::function<void()> handler)
+    {
+        m_default = std::move(handler);
+        return *this;
+    }
+
+    void UiaTypeSwitch::Run()
+    {
+        // Observed frequencies win; the declared ones break ties, such as before anything has been observed.
+        std::stable_sort(m_cases.begin(), m_cases.end(), [this](const TypeCase& lhs, const TypeCase& rhs)
+        {
+            const auto lhsObserved = m_frequencies ? m_frequencies->Count(lhs.variantType) : 0;
+            const auto rhsObserved = m_frequencies ? m_frequencies->Count(rhs.variantType) : 0;
+            if (lhsObserved != rhsObserved)
+            {
+                return lhsObserved > rhsObserved;
+            }
+            return lhs.expectedFrequency > rhs.expectedFrequency;
+        });
+
+        RunFrom(0);
+    }
+
+    void UiaTypeSwitch::RunFrom(size_t index)
+    {
+        if (index == m_cases.size())
+        {
+            if (m_default)
+            {
+                m_default();
+            }
+            return;
+        }
+
+        const auto& typeCase = m_cases[index];
+        if (index + 1 == m_cases.size() && !m_default)
+        {
+            // Nothing left to test if this case doesn't match, so there is no need for a false branch.
+            m_scope.If(typeCase.test(), typeCase.handler);
+            return;
+        }
+
+        m_scope.If(typeCase.test(), typeCase.handler, [&]()
+        {
+            RunFrom(index + 1);
+        });
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "UiaOperationAbstraction.h"
+
+// Implements dispatch on the type of a value whose type is only known once the operation runs, such as the result
+// of GetPropertyValue.
+namespace UiaOperationAbstraction
+{
+    // Counts the types of resolved values, so that later switches can test the most common types first.
+    class UiaTypeFrequencies
+    {
+    public:
+        // Records the type of the given value. Values that haven't been resolved yet are ignored.
+        void Observe(const UiaVariant& value);
+
+        uint64_t Count(VARTYPE type) const;
+
+    private:
+        std::map<VARTYPE, uint64_t> m_counts;
+    };
+
+    // Runs the handler of the first case whose type matches the value.
+    //
+    // Written by hand, this is a sequence of `If(value.IsX(), ...)` blocks, which tests every type even once one has
+    // matched, and casts the value again wherever it's used. The switch instead nests each test in the false branch
+    // of the previous one, so testing stops at the first match, and tests the most frequent types first, so the
+    // common case takes the fewest tests. Each case casts the value once, and its handler receives the cast value.
+    //
+    //     UiaTypeSwitch(scope, value)
+    //         .Case<UiaString>([&](UiaString string) { ... }, 10)
+    //         .Case<UiaInt>([&](UiaInt number) { ... })
+    //         .Default([&]() { ... })
+    //         .Run();
+    //
+    // Like the other wrappers, the switch works both locally and remotely.
+    class UiaTypeSwitch
+    {
+    public:
+        // The frequencies, if given, take precedence over the ones declared by the cases. They must outlive the
+        // call to Run.
+        UiaTypeSwitch(UiaOperationScope& scope, UiaVariant value, const UiaTypeFrequencies* frequencies = nullptr);
+
+        // Adds a case for values of the given wrapper type (e.g. UiaInt or UiaElement). Cases are tested in order of
+        // decreasing frequency, and in the order they were added when frequencies are equal. A second case for the
+        // same type could never run, so it's ignored.
+        template <class WrapperType, class Handler>
+        UiaTypeSwitch& Case(Handler&& handler, uint64_t expectedFrequency = 1)
+        {
+            const std::type_index type(typeid(WrapperType));
+            for (const auto& existing : m_cases)
+            {
+                if (existing.type == type)
+                {
+                    return *this;
+                }
+            }
+
+            const auto value = m_value;
+            m_cases.push_back({
+                type,
+                WrapperType::c_comVariantType,
+                expectedFrequency,
+                [value]()
+                {
+                    return value.IsType<WrapperType>();
+                },
+                [value, handler = std::forward<Handler>(handler)]()
+                {
+                    handler(value.AsType<WrapperType>());
+                } });
+            return *this;
+        }
+
+        // Runs when no case matches.
+        UiaTypeSwitch& Default(std::function<void()> handler);
+
+        // Adds the switch to the scope.
+        void Run();
+
+    private:
+        struct TypeCase
+        {
+            std::type_index type;
+            VARTYPE variantType;
+            uint64_t expectedFrequency;
+            std::function<UiaBool()> test;
+            std::function<void()> handler;
+        };
+
+        void RunFrom(size_t index);
+
+        UiaOperationScope& m_scope;
+        UiaVariant m_value;
+        const UiaTypeFrequencies* m_frequencies;
+        std::vector<TypeCase> m_cases;
+        std::function<void()> m_default;
+    };
+}